@@ -8,6 +8,7 @@
 #include <iomanip>
 #include <sstream>
 #include <string>
+#include <string_view>
 
 #include "frontend/Frontend.hpp"
 
@@ -28,6 +29,18 @@ extern uint64_t ___site_content_oss_md_len; ///< Length of the OSS attribution f
 /// @brief Parse the CLI and configuration file
 hdoc::frontend::Frontend::Frontend(int argc, char** argv, hdoc::types::Config* cfg) {
   cfg->hdocVersion = HDOC_VERSION;
+
+  // Worker processes are launched as `hdoc --index-worker REQUEST [--verbose]`. The argument is internal, so it's
+  // handled here instead of being listed in --help. Workers get everything they need from their request, which
+  // saves reading the configuration file and looking up the system includes once per translation unit.
+  if (cfg->binaryType == hdoc::types::BinaryType::Full && argc >= 3 && std::string_view(argv[1]) == "--index-worker") {
+    const bool verbose = argc >= 4 && std::string_view(argv[3]) == "--verbose";
+    spdlog::set_level(verbose ? spdlog::level::info : spdlog::level::warn);
+    cfg->workerRequest = argv[2];
+    cfg->initialized   = true;
+    return;
+  }
+
   argparse::ArgumentParser program("hdoc", cfg->hdocVersion);
   program.add_argument("--verbose").help("Whether to use verbose output").default_value(false).implicit_value(true);
   program.add_argument("--oss").help("Show open source notices").default_value(false).implicit_value(true);
@@ -54,6 +67,10 @@ hdoc::frontend::Frontend::Frontend(int argc, char** argv, hdoc::types::Config* c
     spdlog::set_level(spdlog::level::warn);
   }
 
+  // Workers are launched by running this same binary again
+  static int mainExecutableAnchor = 0;
+  cfg->executablePath = llvm::sys::fs::getMainExecutable(argv[0], &mainExecutableAnchor);
+
   // Check that the current directory contains a .hdoc.toml file
   cfg->rootDir = std::filesystem::current_path();
   if (!std::filesystem::is_regular_file(cfg->rootDir / ".hdoc.toml")) {
@@ -203,7 +220,7 @@ hdoc::frontend::Frontend::Frontend(int argc, char** argv, hdoc::types::Config* c
     }
   }
 
-  // Get substrings of paths that should be ignored
+  // Get substrings or globs of paths that should be ignored
   if (const auto& ignores = toml["ignore"]["paths"].as_array()) {
     for (const auto& i : *ignores) {
       std::string s = i.value_or(std::string(""));
@@ -211,7 +228,7 @@ hdoc::frontend::Frontend::Frontend(int argc, char** argv, hdoc::types::Config* c
         spdlog::warn("An ignore directive from .hdoc.toml was malformed, ignoring it.");
         continue;
       }
-      spdlog::info("Ignoring paths containing: {}", s);
+      spdlog::info("Ignoring paths matching: {}", s);
       cfg->ignorePaths.emplace_back(s);
     }
   }
@@ -251,9 +268,68 @@ hdoc::frontend::Frontend::Frontend(int argc, char** argv, hdoc::types::Config* c
     spdlog::info("Minimal output enabled.");
   }
 
+  if (const toml::value<bool>* sharedLayout = toml["output"]["shared_layout"].as_boolean()) {
+    cfg->sharedLayout = sharedLayout->get();
+    if (cfg->sharedLayout) {
+      spdlog::info("Loading the sidebar and footer of all pages from layout.js");
+    }
+  }
+
+  // All output can be packed into a single archive instead of writing a file for every page
+  cfg->outputArchive = std::filesystem::path(toml["output"]["archive"].value_or(""));
+
+  // Indexed translation units can be cached between runs so that only TUs affected by a change are re-parsed
+  cfg->cacheDir = std::filesystem::path(toml["indexing"]["cache_dir"].value_or(""));
+
+  if (const toml::value<bool>* deduplicateHeaders = toml["indexing"]["deduplicate_headers"].as_boolean()) {
+    cfg->deduplicateHeaders = deduplicateHeaders->get();
+  }
+
+  if (const toml::value<bool>* skipFunctionBodies = toml["indexing"]["skip_function_bodies"].as_boolean()) {
+    cfg->skipFunctionBodies = skipFunctionBodies->get();
+  }
+
+  if (const toml::value<bool>* pruneAST = toml["indexing"]["prune_ast"].as_boolean()) {
+    cfg->pruneAST = pruneAST->get();
+  }
+
+  if (const toml::value<bool>* isolateTUs = toml["indexing"]["isolate_tus"].as_boolean()) {
+    cfg->isolateTUs = isolateTUs->get();
+  }
+  if (cfg->isolateTUs && cfg->binaryType == hdoc::types::BinaryType::Online) {
+    spdlog::warn("Indexing in worker processes isn't supported by hdoc-online, ignoring isolate_tus.");
+    cfg->isolateTUs = false;
+  }
+
+  if (toml["indexing"]["worker_memory_limit"]) {
+    const int64_t rawWorkerMemoryLimit = toml["indexing"]["worker_memory_limit"].value_or(0);
+    if (rawWorkerMemoryLimit < 0) {
+      spdlog::error("Worker memory limit must be a positive integer greater than or equal to 0.");
+      return;
+    }
+    cfg->workerMemoryLimit = rawWorkerMemoryLimit;
+  }
+
+  if (const toml::value<bool>* coveringTUsOnly = toml["indexing"]["covering_tus_only"].as_boolean()) {
+    cfg->coveringTUsOnly = coveringTUsOnly->get();
+  }
+  cfg->coverageReport = std::filesystem::path(toml["indexing"]["coverage_report"].value_or(""));
+
+  if (const auto precompiledHeader = toml["indexing"]["precompiled_header"].value<std::string>()) {
+    const std::filesystem::path header = std::filesystem::absolute(*precompiledHeader);
+    if (std::filesystem::is_regular_file(header) == false) {
+      spdlog::warn("Precompiled header {} either doesn't exist or isn't a file, ignoring it.", header.string());
+    } else {
+      cfg->precompiledHeader = header;
+    }
+  }
+
   if (const toml::value<bool>* debugDumpJSONPayload = toml["debug"]["dump_json_payload"].as_boolean()) {
     cfg->debugDumpJSONPayload = debugDumpJSONPayload->get();
   }
+  if (const auto perfReport = toml["debug"]["perf_report"].value<std::string>()) {
+    cfg->debugPerfReport = std::filesystem::absolute(*perfReport);
+  }
 
   // Collect paths to markdown files
   cfg->homepage = std::filesystem::path(toml["pages"]["homepage"].value_or(""));
@@ -293,15 +369,39 @@ hdoc::frontend::Frontend::Frontend(int argc, char** argv, hdoc::types::Config* c
   spdlog::info("Root directory: {}", cfg->rootDir.string());
   if (cfg->binaryType != hdoc::types::BinaryType::Online) {
     spdlog::info("Output directory: {}", cfg->outputDir.string());
+    if (cfg->outputArchive.empty() == false) {
+      spdlog::info("Packing output into archive: {}", cfg->outputArchive.string());
+    }
   }
   spdlog::info("Project name: {}", cfg->projectName);
   spdlog::info("Project version: {}", cfg->projectVersion);
   spdlog::info("Indexing using {} threads",
                cfg->numThreads == 0 ? std::string("all") : std::to_string(cfg->numThreads));
+  if (cfg->cacheDir.empty() == false) {
+    spdlog::info("Index cache directory: {}", cfg->cacheDir.string());
+  }
+  if (cfg->skipFunctionBodies) {
+    spdlog::info("Skipping function bodies");
+  }
+  if (cfg->pruneAST) {
+    spdlog::info("Pruning ignored subtrees of the AST");
+  }
+  if (cfg->isolateTUs) {
+    spdlog::info("Indexing translation units in worker processes");
+  }
+  if (cfg->coveringTUsOnly) {
+    spdlog::info("Only indexing translation units needed to cover all headers");
+  }
+  if (cfg->precompiledHeader.empty() == false) {
+    spdlog::info("Precompiled header: {}", cfg->precompiledHeader.string());
+  }
   if (cfg->debugLimitNumIndexedFiles > 0) {
     spdlog::info("Only indexing {} files ", std::to_string(cfg->debugLimitNumIndexedFiles));
   }
   if (cfg->debugDumpJSONPayload) {
     spdlog::info("Dumping JSON payload to ./hdoc-payload.json");
   }
+  if (cfg->debugPerfReport.empty() == false) {
+    spdlog::info("Writing performance report to {}", cfg->debugPerfReport.string());
+  }
 }
@@ -9,6 +9,7 @@
 #include "indexer/Indexer.hpp"
 #include "serde/SerdeUtils.hpp"
 #include "serde/Serialization.hpp"
+#include "support/Instrumentation.hpp"
 
 int main(int argc, char** argv) {
   // Print stack trace on failure
@@ -28,18 +29,21 @@ int main(int argc, char** argv) {
     return EXIT_FAILURE;
   }
 
-  llvm::ThreadPool       pool(llvm::hardware_concurrency(cfg.numThreads));
-  hdoc::indexer::Indexer indexer(&cfg, pool);
-  indexer.run();
-  indexer.pruneMethods();
-  indexer.pruneTypeRefs();
-  indexer.resolveNamespaces();
-  indexer.updateRecordNames();
+  hdoc::utils::Instrumentation instrumentation;
+  llvm::ThreadPool             pool(llvm::hardware_concurrency(cfg.numThreads));
+  hdoc::indexer::Indexer       indexer(&cfg, pool, &instrumentation);
+  instrumentation.measure("index", [&]() { indexer.run(); });
+  instrumentation.measure("pruneMethods", [&]() { indexer.pruneMethods(); });
+  instrumentation.measure("pruneTypeRefs", [&]() { indexer.pruneTypeRefs(); });
+  instrumentation.measure("resolveNamespaces", [&]() { indexer.resolveNamespaces(); });
+  instrumentation.measure("updateRecordNames", [&]() { indexer.updateRecordNames(); });
   indexer.printStats();
   const hdoc::types::Index* index = indexer.dump();
+  instrumentation.recordIndex(*index);
 
-  const std::string data = hdoc::serde::serializeToJSON(*index, cfg);
-  hdoc::serde::uploadDocs(data);
+  std::string data;
+  instrumentation.measure("serializeToJSON", [&]() { data = hdoc::serde::serializeToJSON(*index, cfg); });
+  instrumentation.measure("uploadDocs", [&]() { hdoc::serde::uploadDocs(data); });
 
   // Ensure that cfg was properly initialized
   if (cfg.debugDumpJSONPayload) {
@@ -49,5 +53,9 @@ int main(int argc, char** argv) {
     }
   }
 
+  if (cfg.debugPerfReport.empty() == false && instrumentation.write(cfg.debugPerfReport) == false) {
+    return EXIT_FAILURE;
+  }
+
   return EXIT_SUCCESS;
 }
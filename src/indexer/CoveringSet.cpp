@@ -0,0 +1,62 @@
+// Copyright 2019-2023 hdoc
+// SPDX-License-Identifier: AGPL-3.0-only
+
+#include "indexer/CoveringSet.hpp"
+
+#include <algorithm>
+#include <queue>
+
+#include "llvm/ADT/StringMap.h"
+
+std::vector<uint64_t> hdoc::indexer::findCoveringSet(const std::vector<std::vector<std::string>>& headers) {
+  // Number the headers so that the greedy loop only deals with integers
+  llvm::StringMap<uint32_t>          headerIDs;
+  std::vector<std::vector<uint32_t>> tuHeaders(headers.size());
+  for (uint64_t i = 0; i < headers.size(); i++) {
+    for (const auto& header : headers[i]) {
+      const auto [it, inserted] = headerIDs.try_emplace(header, headerIDs.size());
+      tuHeaders[i].emplace_back(it->second);
+    }
+    // TUs may report the same header more than once
+    std::sort(tuHeaders[i].begin(), tuHeaders[i].end());
+    tuHeaders[i].erase(std::unique(tuHeaders[i].begin(), tuHeaders[i].end()), tuHeaders[i].end());
+  }
+
+  // The number of new headers a TU adds can only shrink as other TUs are picked, so a stale gain is an upper bound.
+  // Lazily recomputing the gain of the TU at the top of the queue avoids rescanning every TU after each pick.
+  // Entries are (gain, -position) so that the queue prefers the highest gain and then the lowest position.
+  std::priority_queue<std::pair<uint64_t, int64_t>> queue;
+  for (uint64_t i = 0; i < tuHeaders.size(); i++) {
+    if (tuHeaders[i].size() > 0) {
+      queue.emplace(tuHeaders[i].size(), -static_cast<int64_t>(i));
+    }
+  }
+
+  std::vector<bool>     covered(headerIDs.size(), false);
+  std::vector<uint64_t> picked;
+  while (queue.empty() == false) {
+    const auto [staleGain, negPosition] = queue.top();
+    const uint64_t position             = static_cast<uint64_t>(-negPosition);
+    queue.pop();
+
+    uint64_t gain = 0;
+    for (const uint32_t id : tuHeaders[position]) {
+      gain += covered[id] ? 0 : 1;
+    }
+    if (gain == 0) {
+      continue;
+    }
+    if (gain < staleGain) {
+      queue.emplace(gain, negPosition);
+      continue;
+    }
+
+    for (const uint32_t id : tuHeaders[position]) {
+      covered[id] = true;
+    }
+    picked.emplace_back(position);
+  }
+
+  std::sort(picked.begin(), picked.end());
+  return picked;
+}
@@ -0,0 +1,18 @@
+// Copyright 2019-2023 hdoc
+// SPDX-License-Identifier: AGPL-3.0-only
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace hdoc::indexer {
+/// @brief Pick a small set of TUs which together include every header that any TU includes.
+///
+/// headers[i] holds the headers included by the i-th TU. Finding the smallest such set is NP-hard, so TUs are
+/// picked greedily by the number of headers they add, which is within a logarithmic factor of the optimum.
+/// Ties are broken by the position of the TU so that the result is deterministic.
+/// Returns the positions of the picked TUs in ascending order. TUs that don't include any headers are never picked.
+std::vector<uint64_t> findCoveringSet(const std::vector<std::vector<std::string>>& headers);
+} // namespace hdoc::indexer
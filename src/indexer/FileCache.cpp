@@ -0,0 +1,69 @@
+// Copyright 2019-2023 hdoc
+// SPDX-License-Identifier: AGPL-3.0-only
+
+#include "indexer/FileCache.hpp"
+
+#include "clang/Basic/FileManager.h"
+#include "llvm/Support/Path.h"
+#include "spdlog/spdlog.h"
+
+#include <filesystem>
+#include <optional>
+
+/// When hdoc is run by multiple threads, we use a VFS (virtual file system) to access
+/// files safely. The working directory of the parser is changed during indexing, and
+/// other threads have no visibility of this. Consequently, canonical paths
+/// generated in a non-VFS-aware way can be wrong.
+/// This function is similar to one defined in clang, and gets the canonical path in a
+/// VFS-aware way.
+static std::optional<std::string> getCanonicalPath(const clang::SourceManager& sourceManager,
+                                                   const clang::FileEntry*     fileEntry) {
+  llvm::SmallString<128> path = fileEntry->getName();
+  if (!llvm::sys::path::is_absolute(path)) {
+    if (auto ec = sourceManager.getFileManager().getVirtualFileSystem().makeAbsolute(path)) {
+      spdlog::warn("Could not turn relative path '{}' to absolute: {}", path.c_str(), ec.message().c_str());
+      return std::nullopt;
+    }
+  }
+
+  if (auto dir = sourceManager.getFileManager().getDirectoryRef(llvm::sys::path::parent_path(path))) {
+    const llvm::StringRef  dirName = sourceManager.getFileManager().getCanonicalName(dir.get());
+    llvm::SmallString<128> realPath;
+    llvm::sys::path::append(realPath, dirName, llvm::sys::path::filename(path));
+    return realPath.str().str();
+  }
+
+  return path.str().str();
+}
+
+hdoc::indexer::FileCache::FileInfo hdoc::indexer::FileCache::get(const clang::SourceManager& sm,
+                                                                 const clang::FileID         fid) {
+  const auto [it, inserted] = this->files.try_emplace(fid);
+  if (inserted == false) {
+    return it->second;
+  }
+
+  FileInfo&               info      = it->second;
+  const clang::FileEntry* fileEntry = sm.getFileEntryForID(fid);
+  // Decls without a file are probably compiler-generated
+  if (fileEntry == nullptr || fileEntry->getName().empty()) {
+    info.isIgnored = true;
+    return info;
+  }
+
+  const auto absPath = getCanonicalPath(sm, fileEntry);
+  if (!absPath) {
+    spdlog::warn("Unable to get absolute path for {}, ignoring decls in it", fileEntry->getName().str());
+    info.isIgnored = true;
+    return info;
+  }
+
+  const std::string relPath = std::filesystem::relative(std::filesystem::path(*absPath), this->cfg->rootDir).string();
+  info.isValid              = true;
+  info.relPath              = relPath;
+  info.isInIgnoreList       = this->ignorePaths.isMatch(relPath);
+  // ".." is used as a janky way to determine if the path is outside of rootDir since the canonicalized path
+  // should not have any ".."s in it
+  info.isIgnored = info.isInIgnoreList || relPath.find("..") != std::string::npos;
+  return info;
+}
@@ -0,0 +1,45 @@
+// Copyright 2019-2023 hdoc
+// SPDX-License-Identifier: AGPL-3.0-only
+
+#pragma once
+
+#include "clang/Basic/SourceManager.h"
+#include "llvm/ADT/DenseMap.h"
+
+#include "support/PathMatcher.hpp"
+#include "types/Config.hpp"
+#include "types/InternedString.hpp"
+
+namespace hdoc::indexer {
+/// @brief Remembers the path of each file that a TU's decls are in, and whether that file is ignored.
+///
+/// Thousands of decls share a few hundred files, and getting the canonical path of a file, making it relative
+/// to rootDir, and searching it for cfg->ignorePaths is done once per file instead of once per decl.
+/// FileIDs are only meaningful within one SourceManager, so clear() must be called at the start of every TU.
+/// Only the matchers of one TU may use an instance.
+class FileCache {
+public:
+  /// @brief What hdoc knows about a file.
+  struct FileInfo {
+    bool                        isValid        = false; ///< Could the canonical path of the file be found?
+    bool                        isIgnored      = false; ///< Is the file invalid, outside of rootDir, or ignored?
+    bool                        isInIgnoreList = false; ///< Does the path match any of cfg->ignorePaths?
+    hdoc::types::InternedString relPath;                ///< Canonical path of the file relative to rootDir
+  };
+
+  FileCache(const hdoc::types::Config* cfg) : cfg(cfg), ignorePaths(cfg->ignorePaths) {}
+
+  /// @brief Get the FileInfo for the file with the given FileID, computing it if this is the first lookup.
+  FileInfo get(const clang::SourceManager& sm, const clang::FileID fid);
+
+  /// @brief Forget all files. Must be called before the cache is used with a different SourceManager.
+  void clear() {
+    this->files.clear();
+  }
+
+private:
+  const hdoc::types::Config*              cfg;
+  hdoc::utils::PathMatcher                ignorePaths; ///< Compiled cfg->ignorePaths
+  llvm::DenseMap<clang::FileID, FileInfo> files;       ///< Files that were looked up so far
+};
+} // namespace hdoc::indexer
@@ -0,0 +1,114 @@
+// Copyright 2019-2023 hdoc
+// SPDX-License-Identifier: AGPL-3.0-only
+
+#include "indexer/HeaderRegistry.hpp"
+
+#include "clang/AST/Decl.h"
+#include "clang/Lex/PPCallbacks.h"
+
+bool hdoc::indexer::HeaderRegistry::claim(llvm::StringRef path, llvm::StringRef owner) {
+  std::lock_guard<std::mutex> lock(this->mutex);
+  const auto [it, inserted] = this->owners.try_emplace(path, owner.str());
+  return inserted || it->second == owner;
+}
+
+bool hdoc::indexer::HeaderRegistry::isClaimed(llvm::StringRef path) const {
+  std::lock_guard<std::mutex> lock(this->mutex);
+  return this->owners.contains(path);
+}
+
+std::string hdoc::indexer::HeaderRegistry::getOwner(llvm::StringRef path) const {
+  std::lock_guard<std::mutex> lock(this->mutex);
+  return this->owners.lookup(path);
+}
+
+std::vector<std::string> hdoc::indexer::HeaderRegistry::getClaimedFiles() const {
+  std::lock_guard<std::mutex> lock(this->mutex);
+  std::vector<std::string>    files;
+  files.reserve(this->owners.size());
+  for (const auto& entry : this->owners) {
+    files.emplace_back(entry.getKey());
+  }
+  return files;
+}
+
+namespace hdoc::indexer {
+/// Forwards the files the preprocessor enters to OwnedFiles. The preprocessor owns its callbacks,
+/// so this is kept separate from OwnedFiles, which has to outlive it.
+class OwnershipCallbacks : public clang::PPCallbacks {
+public:
+  OwnershipCallbacks(OwnedFiles& ownedFiles, const clang::SourceManager& sm) : ownedFiles(ownedFiles), sm(sm) {}
+
+  void FileChanged(clang::SourceLocation             loc,
+                   FileChangeReason                  reason,
+                   clang::SrcMgr::CharacteristicKind fileType,
+                   clang::FileID                     prevFID) override {
+    (void)prevFID;
+    // Matchers never index system headers, so there's no need to claim them
+    if (reason != EnterFile || clang::SrcMgr::isSystem(fileType)) {
+      return;
+    }
+    this->ownedFiles.fileEntered(this->sm, this->sm.getFileID(loc));
+  }
+
+private:
+  OwnedFiles&                 ownedFiles;
+  const clang::SourceManager& sm;
+};
+} // namespace hdoc::indexer
+
+void hdoc::indexer::OwnedFiles::attachToPreprocessor(clang::Preprocessor& pp) {
+  // FileIDs and FileEntries are only meaningful within one AST
+  this->fileIDs.clear();
+  this->files.clear();
+  pp.addPPCallbacks(std::make_unique<OwnershipCallbacks>(*this, pp.getSourceManager()));
+}
+
+void hdoc::indexer::OwnedFiles::fileEntered(const clang::SourceManager& sm, const clang::FileID fid) {
+  if (this->registry == nullptr) {
+    return;
+  }
+
+  const clang::OptionalFileEntryRef entry = sm.getFileEntryRefForID(fid);
+  if (!entry) {
+    return;
+  }
+
+  // Files without include guards can be entered several times, but only need to be claimed once
+  const auto [it, inserted] = this->files.try_emplace(&entry->getFileEntry(), true);
+  if (inserted) {
+    // Prefer the real path so that the same file reached through different paths is only claimed once
+    llvm::StringRef path = entry->getFileEntry().tryGetRealPathName();
+    if (path.empty()) {
+      path = entry->getName();
+    }
+    it->second = this->registry->claim(path, this->tu);
+    if (it->second) {
+      this->claimedFiles.emplace_back(path.str());
+    } else {
+      this->skippedFiles.emplace_back(path.str());
+    }
+  }
+  this->fileIDs[fid] = it->second;
+}
+
+bool hdoc::indexer::OwnedFiles::isOwned(const clang::SourceManager& sm, const clang::SourceLocation loc) const {
+  const clang::SourceLocation expansionLoc = sm.getExpansionLoc(loc);
+  // The preprocessor never enters files in a precompiled header, their locations are loaded with the AST instead
+  if (this->skipPrecompiled && sm.isLoadedSourceLocation(expansionLoc)) {
+    return false;
+  }
+  const auto it = this->fileIDs.find(sm.getFileID(expansionLoc));
+  return it == this->fileIDs.end() || it->second;
+}
+
+bool hdoc::indexer::OwnedFiles::isOwned(const clang::SourceManager& sm, const clang::Decl* d) const {
+  if (this->isOwned(sm, d->getLocation()) == false) {
+    return false;
+  }
+  if (llvm::isa<clang::TagDecl, clang::NamespaceDecl>(d)) {
+    return true;
+  }
+  const clang::Decl* canonical = d->getCanonicalDecl();
+  return canonical == d || this->isOwned(sm, canonical->getLocation());
+}
@@ -0,0 +1,102 @@
+// Copyright 2019-2023 hdoc
+// SPDX-License-Identifier: AGPL-3.0-only
+
+#pragma once
+
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "clang/AST/DeclBase.h"
+#include "clang/Basic/SourceManager.h"
+#include "clang/Lex/Preprocessor.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/StringMap.h"
+
+namespace hdoc::indexer {
+/// @brief Records which translation unit is responsible for indexing each file, shared by all TUs.
+///
+/// Most headers are included by many TUs, and matching the same declarations over and over again in every one
+/// of them dominates indexing time. The first TU to enter a file claims it, and all other TUs skip its
+/// declarations since they'll be indexed by the owner anyway.
+class HeaderRegistry {
+public:
+  /// @brief Claim path for the TU named owner.
+  /// Returns true if the file was unclaimed or was already claimed by owner.
+  bool claim(llvm::StringRef path, llvm::StringRef owner);
+
+  /// @brief Check if any TU claimed path.
+  bool isClaimed(llvm::StringRef path) const;
+
+  /// @brief Get the path of the TU that claimed path, or an empty string if no TU claimed it.
+  std::string getOwner(llvm::StringRef path) const;
+
+  /// @brief Get the paths of all files that were claimed so far, in no particular order.
+  std::vector<std::string> getClaimedFiles() const;
+
+private:
+  mutable std::mutex           mutex;  ///< Guards owners
+  llvm::StringMap<std::string> owners; ///< Path of each claimed file to the path of the TU that claimed it
+};
+
+/// @brief Tracks which of the files included by a single TU that TU is responsible for indexing.
+///
+/// Files are claimed in the HeaderRegistry as the preprocessor enters them, so the verdict for every file is known
+/// by the time the AST is matched. Only the preprocessor and matchers of one TU may use an instance.
+class OwnedFiles {
+public:
+  /// If registry is nullptr, the TU owns every file it enters.
+  /// If skipPrecompiled is true, the TU doesn't own declarations loaded from a precompiled header,
+  /// since they were already indexed when the precompiled header was built.
+  OwnedFiles(HeaderRegistry* registry, const std::string& tu, const bool skipPrecompiled = false)
+      : registry(registry), tu(tu), skipPrecompiled(skipPrecompiled) {}
+
+  /// @brief Claim files as pp enters them. Must be called before preprocessing each compile command of the TU.
+  void attachToPreprocessor(clang::Preprocessor& pp);
+
+  /// @brief Should declarations at loc be indexed by this TU?
+  /// Returns true for locations that aren't in a file that was entered by the preprocessor,
+  /// unless they were loaded from a precompiled header that should be skipped.
+  bool isOwned(const clang::SourceManager& sm, const clang::SourceLocation loc) const;
+
+  /// @brief Should d be indexed by this TU?
+  /// Besides d itself, the first declaration of d has to be in a file this TU owns. Otherwise a TU that only sees
+  /// the out-of-line definition of a function would index it without the default arguments and specifiers that
+  /// are written on the declaration. Records, enums, and namespaces are decided by their own location, since
+  /// records and enums are only indexed where they're defined and namespaces are reopened everywhere.
+  bool isOwned(const clang::SourceManager& sm, const clang::Decl* d) const;
+
+  /// @brief Forget the files this TU claimed and skipped so far, before the TU is parsed again from scratch.
+  /// The claims stay in the registry since they belong to this TU, which claims the same files again.
+  void reset() {
+    this->fileIDs.clear();
+    this->files.clear();
+    this->claimedFiles.clear();
+    this->skippedFiles.clear();
+  }
+
+  /// @brief Get the paths of the files this TU claimed.
+  const std::vector<std::string>& getClaimedFiles() const {
+    return this->claimedFiles;
+  }
+
+  /// @brief Get the paths of the files that were left for other TUs to index.
+  const std::vector<std::string>& getSkippedFiles() const {
+    return this->skippedFiles;
+  }
+
+private:
+  friend class OwnershipCallbacks;
+
+  /// Decide if this TU owns the file with the given FileID, which the preprocessor just entered.
+  void fileEntered(const clang::SourceManager& sm, const clang::FileID fid);
+
+  HeaderRegistry*                               registry;        ///< Where files are claimed, nullptr to own all
+  std::string                                   tu;              ///< Path of the TU
+  bool                                          skipPrecompiled; ///< Skip locations loaded from a PCH
+  llvm::DenseMap<clang::FileID, bool>           fileIDs;         ///< Verdict for each FileID in the current AST
+  llvm::DenseMap<const clang::FileEntry*, bool> files;           ///< Verdict for each file in the current AST
+  std::vector<std::string>                      claimedFiles;    ///< Files claimed by this TU
+  std::vector<std::string>                      skippedFiles;    ///< Files claimed by other TUs
+};
+} // namespace hdoc::indexer
@@ -0,0 +1,163 @@
+// Copyright 2019-2023 hdoc
+// SPDX-License-Identifier: AGPL-3.0-only
+
+#include "indexer/IndexCache.hpp"
+#include "serde/BinarySerializer.hpp"
+#include "support/StringUtils.hpp"
+#include "version.hpp"
+
+#include "spdlog/spdlog.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/Support/xxhash.h"
+
+/// First line of every cache entry. Entries with a different header are ignored.
+static constexpr std::string_view cacheEntryHeader = "HDOCTU2\n";
+
+/// Append s to key, followed by a separator that can't appear in paths or arguments.
+static void appendToKey(std::string& key, const std::string_view s) {
+  key += s;
+  key += '\0';
+}
+
+hdoc::indexer::IndexCache::IndexCache(const hdoc::types::Config* cfg, const std::vector<std::string>& extraArgs)
+    : cfg(cfg) {
+  if (this->enabled() == false) {
+    return;
+  }
+
+  // Anything that changes which symbols are indexed, or how they're represented, must be part of the key
+  std::string key;
+  appendToKey(key, HDOC_VERSION);
+  appendToKey(key, cfg->rootDir.string());
+  appendToKey(key, cfg->ignorePrivateMembers ? "1" : "0");
+  appendToKey(key, cfg->deduplicateHeaders ? "1" : "0");
+  appendToKey(key, cfg->pruneAST ? "1" : "0");
+  for (const auto& list : {cfg->ignorePaths, cfg->ignoreNamespaces, cfg->detailNamespaces, extraArgs}) {
+    for (const auto& s : list) {
+      appendToKey(key, s);
+    }
+    appendToKey(key, "");
+  }
+  this->configHash = llvm::xxHash64(key);
+
+  std::error_code ec;
+  std::filesystem::create_directories(cfg->cacheDir, ec);
+  if (ec) {
+    spdlog::warn("Unable to create index cache directory {}: {}", cfg->cacheDir.string(), ec.message());
+  }
+}
+
+std::filesystem::path
+hdoc::indexer::IndexCache::getEntryPath(const std::vector<clang::tooling::CompileCommand>& cmds) const {
+  std::string key = std::to_string(this->configHash);
+  for (const auto& cmd : cmds) {
+    appendToKey(key, cmd.Directory);
+    appendToKey(key, cmd.Filename);
+    for (const auto& arg : cmd.CommandLine) {
+      appendToKey(key, arg);
+    }
+  }
+  return this->cfg->cacheDir / (llvm::utohexstr(llvm::xxHash64(key)) + ".tu");
+}
+
+std::optional<uint64_t> hdoc::indexer::IndexCache::hashFile(const std::string& path) {
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    if (const auto it = this->fileHashes.find(path); it != this->fileHashes.end()) {
+      return it->second;
+    }
+  }
+
+  std::optional<uint64_t> hash = std::nullopt;
+  if (auto buf = llvm::MemoryBuffer::getFile(path, /*IsText=*/false, /*RequiresNullTerminator=*/false)) {
+    hash = llvm::xxHash64(buf->get()->getBuffer());
+  }
+
+  std::lock_guard<std::mutex> lock(this->mutex);
+  this->fileHashes.emplace(path, hash);
+  return hash;
+}
+
+bool hdoc::indexer::IndexCache::load(const std::vector<clang::tooling::CompileCommand>& cmds,
+                                     hdoc::types::Index&                                index,
+                                     std::vector<std::string>&                          claimedFiles,
+                                     std::vector<std::string>&                          skippedFiles) {
+  const auto entryPath = this->getEntryPath(cmds);
+  auto       buf       = llvm::MemoryBuffer::getFile(entryPath.string(), false, false);
+  if (!buf) {
+    return false;
+  }
+
+  // Entries are laid out as a header, the number of dependencies, one "HASH PATH" line per dependency,
+  // the lists of claimed and skipped files, and finally the binary-serialized index
+  llvm::StringRef data = buf->get()->getBuffer();
+  if (data.consume_front(cacheEntryHeader) == false) {
+    return false;
+  }
+
+  auto [numDepsStr, rest] = data.split('\n');
+  uint64_t numDeps        = 0;
+  if (numDepsStr.getAsInteger(10, numDeps)) {
+    return false;
+  }
+  data = rest;
+
+  for (uint64_t i = 0; i < numDeps; i++) {
+    auto [line, remainder]  = data.split('\n');
+    auto [hashStr, depPath] = line.split(' ');
+    data                    = remainder;
+
+    uint64_t expectedHash = 0;
+    if (hashStr.getAsInteger(16, expectedHash)) {
+      return false;
+    }
+    const auto actualHash = this->hashFile(depPath.str());
+    if (actualHash.has_value() == false || *actualHash != expectedHash) {
+      spdlog::info("{} changed, re-indexing {}", depPath.str(), cmds.empty() ? "" : cmds.front().Filename);
+      return false;
+    }
+  }
+
+  std::string_view rest(data.data(), data.size());
+  if (hdoc::utils::consumeLines(rest, claimedFiles) == false ||
+      hdoc::utils::consumeLines(rest, skippedFiles) == false) {
+    return false;
+  }
+
+  if (hdoc::serde::deserializeFromBinary(rest, index) == false) {
+    spdlog::warn("Index cache entry {} is corrupt, ignoring it", entryPath.string());
+    return false;
+  }
+  return true;
+}
+
+void hdoc::indexer::IndexCache::store(const std::vector<clang::tooling::CompileCommand>& cmds,
+                                      const std::vector<std::string>&                    deps,
+                                      const std::vector<std::string>&                    claimedFiles,
+                                      const std::vector<std::string>&                    skippedFiles,
+                                      const hdoc::types::Index&                          index) {
+  std::string entry(cacheEntryHeader);
+  entry += std::to_string(deps.size()) + "\n";
+  for (const auto& dep : deps) {
+    const auto hash = this->hashFile(dep);
+    if (hash.has_value() == false) {
+      // A file that can't be read can't be checked for changes later, so the TU can't be cached
+      return;
+    }
+    entry += llvm::utohexstr(*hash) + " " + dep + "\n";
+  }
+  hdoc::utils::appendLines(entry, claimedFiles);
+  hdoc::utils::appendLines(entry, skippedFiles);
+  entry += hdoc::serde::serializeToBinary(index);
+
+  // Write to a temporary file and rename it, so concurrent hdoc runs never see partial entries
+  const auto entryPath = this->getEntryPath(cmds);
+  if (auto err = llvm::writeToOutput(entryPath.string(), [&](llvm::raw_ostream& os) {
+        os << entry;
+        return llvm::Error::success();
+      })) {
+    spdlog::warn("Unable to write index cache entry {}: {}", entryPath.string(), llvm::toString(std::move(err)));
+  }
+}
@@ -0,0 +1,64 @@
+// Copyright 2019-2023 hdoc
+// SPDX-License-Identifier: AGPL-3.0-only
+
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "clang/Tooling/CompilationDatabase.h"
+
+#include "types/Config.hpp"
+#include "types/Index.hpp"
+
+namespace hdoc::indexer {
+/// @brief Persistent on-disk cache of the symbols each translation unit contributes to the Index.
+///
+/// Entries are keyed by the TU's compile commands and the parts of hdoc's configuration that influence indexing.
+/// Each entry also lists every file the TU included along with a hash of its contents, and is only reused if none
+/// of those files changed since the entry was written.
+class IndexCache {
+public:
+  /// extraArgs are the arguments hdoc appends to every compile command, typically include search paths.
+  IndexCache(const hdoc::types::Config* cfg, const std::vector<std::string>& extraArgs);
+
+  /// @brief Is the cache enabled in the configuration?
+  bool enabled() const {
+    return this->cfg->cacheDir.empty() == false;
+  }
+
+  /// @brief Load the cached contribution of the TU compiled with cmds into index, which must be empty.
+  /// claimedFiles and skippedFiles are set to the files the TU did and didn't index when it was parsed,
+  /// see HeaderRegistry. Returns false if there's no usable entry, in which case the outputs are unspecified.
+  bool load(const std::vector<clang::tooling::CompileCommand>& cmds,
+            hdoc::types::Index&                                index,
+            std::vector<std::string>&                          claimedFiles,
+            std::vector<std::string>&                          skippedFiles);
+
+  /// @brief Save the contribution of the TU compiled with cmds, which included the files in deps.
+  void store(const std::vector<clang::tooling::CompileCommand>& cmds,
+             const std::vector<std::string>&                    deps,
+             const std::vector<std::string>&                    claimedFiles,
+             const std::vector<std::string>&                    skippedFiles,
+             const hdoc::types::Index&                          index);
+
+private:
+  /// Get the path of the cache entry for the TU compiled with cmds.
+  std::filesystem::path getEntryPath(const std::vector<clang::tooling::CompileCommand>& cmds) const;
+
+  /// Hash the contents of the file at path, returning std::nullopt if it can't be read.
+  /// Results are memoized since most headers are shared by many TUs.
+  std::optional<uint64_t> hashFile(const std::string& path);
+
+  const hdoc::types::Config* cfg;
+  uint64_t                   configHash = 0; ///< Hash of everything besides the compile command that affects indexing
+
+  std::mutex                                               mutex;      ///< Guards fileHashes
+  std::unordered_map<std::string, std::optional<uint64_t>> fileHashes; ///< Memoized content hashes
+};
+} // namespace hdoc::indexer
@@ -0,0 +1,90 @@
+// Copyright 2019-2023 hdoc
+// SPDX-License-Identifier: AGPL-3.0-only
+
+#include "indexer/IndexMerger.hpp"
+
+/// Move the entries in shard i of src into dst. For symbols that are in both, the one that came from the earlier TU
+/// is kept. The origin of entries in src is looked up in srcOrigins, or is tu if srcOrigins is nullptr.
+template <typename T>
+static void mergeShard(hdoc::types::Database<T>&         dst,
+                       hdoc::types::SymbolMap<uint32_t>& dstOrigins,
+                       hdoc::types::Database<T>&         src,
+                       hdoc::types::SymbolMap<uint32_t>* srcOrigins,
+                       const uint32_t                    tu,
+                       const uint32_t                    i) {
+  auto& dstEntries = dst.entries.getShard(i);
+  auto& origins    = dstOrigins.getShard(i);
+  for (auto& [id, symbol] : src.entries.getShard(i)) {
+    const uint32_t origin     = srcOrigins == nullptr ? tu : srcOrigins->getShard(i).at(id);
+    const auto [it, inserted] = origins.try_emplace(id, origin);
+    if (inserted || origin < it->second) {
+      it->second = origin;
+      dstEntries.insert_or_assign(id, std::move(symbol));
+    }
+  }
+}
+
+/// Merge shard i of all databases in src into dst, see mergeShard().
+static void mergeIndexShard(hdoc::types::Index&                        dst,
+                            hdoc::indexer::IndexMerger::Origins&       dstOrigins,
+                            hdoc::types::Index&                        src,
+                            hdoc::indexer::IndexMerger::Origins* const srcOrigins,
+                            const uint32_t                             tu,
+                            const uint32_t                             i) {
+  const bool hasOrigins = srcOrigins != nullptr;
+  mergeShard(dst.functions, dstOrigins.functions, src.functions, hasOrigins ? &srcOrigins->functions : nullptr, tu, i);
+  mergeShard(dst.records, dstOrigins.records, src.records, hasOrigins ? &srcOrigins->records : nullptr, tu, i);
+  mergeShard(dst.enums, dstOrigins.enums, src.enums, hasOrigins ? &srcOrigins->enums : nullptr, tu, i);
+  mergeShard(
+      dst.namespaces, dstOrigins.namespaces, src.namespaces, hasOrigins ? &srcOrigins->namespaces : nullptr, tu, i);
+  mergeShard(dst.aliases, dstOrigins.aliases, src.aliases, hasOrigins ? &srcOrigins->aliases : nullptr, tu, i);
+}
+
+/// Add the number of matches in each database of src to dst.
+static void addNumMatches(hdoc::types::Index& dst, const hdoc::types::Index& src) {
+  dst.functions.numMatches += src.functions.numMatches;
+  dst.records.numMatches += src.records.numMatches;
+  dst.enums.numMatches += src.enums.numMatches;
+  dst.namespaces.numMatches += src.namespaces.numMatches;
+  dst.aliases.numMatches += src.aliases.numMatches;
+}
+
+void hdoc::indexer::IndexMerger::add(hdoc::types::Index& tuIndex, const uint32_t tu) {
+  Partial* partial = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    if (this->available.empty()) {
+      this->partials.emplace_back(std::make_unique<Partial>());
+      this->available.emplace_back(this->partials.back().get());
+    }
+    partial = this->available.back();
+    this->available.pop_back();
+  }
+
+  for (uint32_t i = 0; i < hdoc::types::SymbolMap<uint32_t>::getNumShards(); i++) {
+    mergeIndexShard(partial->index, partial->origins, tuIndex, nullptr, tu, i);
+  }
+  addNumMatches(partial->index, tuIndex);
+
+  std::lock_guard<std::mutex> lock(this->mutex);
+  this->available.emplace_back(partial);
+}
+
+void hdoc::indexer::IndexMerger::finish(hdoc::types::Index& index, llvm::ThreadPool& pool) {
+  // Shards are independent of each other, so each one can be merged on a different thread without locking
+  Origins origins;
+  for (uint32_t i = 0; i < hdoc::types::SymbolMap<uint32_t>::getNumShards(); i++) {
+    pool.async([&, i]() {
+      for (auto& partial : this->partials) {
+        mergeIndexShard(index, origins, partial->index, &partial->origins, 0, i);
+      }
+    });
+  }
+  pool.wait();
+
+  for (const auto& partial : this->partials) {
+    addNumMatches(index, partial->index);
+  }
+  this->partials.clear();
+  this->available.clear();
+}
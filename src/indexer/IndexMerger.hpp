@@ -0,0 +1,50 @@
+// Copyright 2019-2023 hdoc
+// SPDX-License-Identifier: AGPL-3.0-only
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "llvm/Support/ThreadPool.h"
+
+#include "types/Index.hpp"
+
+namespace hdoc::indexer {
+/// @brief Merges the Indexes built for individual translation units into hdoc's index.
+///
+/// Worker threads add the Index of each TU as soon as it's parsed. When several TUs contain the same symbol, the
+/// symbol from the TU that comes first in the list of TUs is kept. The merged index therefore doesn't depend on
+/// how TUs were scheduled across threads, which keeps the generated documentation reproducible.
+class IndexMerger {
+public:
+  /// @brief Add the symbols in tuIndex, which was built for the TU at position tu in the list of all TUs.
+  /// Symbols are moved out of tuIndex. Each TU must be added at most once, since symbols from the same position tie.
+  /// Safe to call from multiple threads at once.
+  void add(hdoc::types::Index& tuIndex, const uint32_t tu);
+
+  /// @brief Merge all of the added symbols into index, which must be empty, merging shards in parallel on pool.
+  void finish(hdoc::types::Index& index, llvm::ThreadPool& pool);
+
+  /// @brief Position of the TU that each symbol in an Index came from, for each of its databases
+  struct Origins {
+    hdoc::types::SymbolMap<uint32_t> functions;
+    hdoc::types::SymbolMap<uint32_t> records;
+    hdoc::types::SymbolMap<uint32_t> enums;
+    hdoc::types::SymbolMap<uint32_t> namespaces;
+    hdoc::types::SymbolMap<uint32_t> aliases;
+  };
+
+private:
+  /// The symbols added by one thread at a time, so that threads never wait for each other while merging
+  struct Partial {
+    hdoc::types::Index index;
+    Origins            origins;
+  };
+
+  std::mutex                            mutex;     ///< Guards partials and available
+  std::vector<std::unique_ptr<Partial>> partials;  ///< All partial indexes created so far
+  std::vector<Partial*>                 available; ///< Partial indexes not used by any thread right now
+};
+} // namespace hdoc::indexer
@@ -1,51 +1,411 @@
 // Copyright 2019-2023 hdoc
 // SPDX-License-Identifier: AGPL-3.0-only
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <filesystem>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <unordered_map>
 
+#include "rapidjson/prettywriter.h"
+#include "rapidjson/stringbuffer.h"
 #include "spdlog/spdlog.h"
 #include "clang/ASTMatchers/ASTMatchFinder.h"
+#include "clang/Frontend/CompilerInstance.h"
+#include "clang/Frontend/FrontendAction.h"
+#include "clang/Frontend/FrontendActions.h"
+#include "clang/Frontend/MultiplexConsumer.h"
+#include "clang/Frontend/Utils.h"
 #include "clang/Tooling/ArgumentsAdjusters.h"
 #include "clang/Tooling/JSONCompilationDatabase.h"
 #include "clang/Tooling/Tooling.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/ADT/StringSet.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/FileUtilities.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Program.h"
+#include "llvm/Support/raw_ostream.h"
 
+#include "indexer/CoveringSet.hpp"
+#include "indexer/HeaderRegistry.hpp"
+#include "indexer/IndexCache.hpp"
+#include "indexer/IndexMerger.hpp"
 #include "indexer/Indexer.hpp"
 #include "indexer/Matchers.hpp"
+#include "indexer/TUCostModel.hpp"
+#include "indexer/WorkerProtocol.hpp"
+#include "support/Instrumentation.hpp"
+#include "support/PathMatcher.hpp"
 #include "support/ParallelExecutor.hpp"
 #include "support/StringUtils.hpp"
 
-// Check if a symbol is a child of the given namespace
-static bool isChild(const hdoc::types::Symbol& ns, const hdoc::types::Symbol& s) {
-  return s.parentNamespaceID.raw() == ns.ID.raw();
+/// IDs of the symbols whose parent is the key, in the order they're iterated over in their Database
+using ParentBuckets = std::unordered_map<hdoc::types::SymbolID, std::vector<hdoc::types::SymbolID>>;
+
+// Group the symbols in db by the ID of their parent namespace or record
+template <typename T> static ParentBuckets bucketByParent(const hdoc::types::Database<T>& db) {
+  ParentBuckets buckets;
+  for (const auto& [k, v] : db.entries) {
+    buckets[v.parentNamespaceID].emplace_back(v.ID);
+  }
+  return buckets;
 }
 
-void hdoc::indexer::Indexer::run() {
-  spdlog::info("Starting indexing...");
+// Append the IDs of the children of parent in buckets to ids
+static void appendChildren(std::vector<hdoc::types::SymbolID>& ids,
+                           const ParentBuckets&                buckets,
+                           const hdoc::types::SymbolID&        parent) {
+  if (const auto it = buckets.find(parent); it != buckets.end()) {
+    ids.insert(ids.end(), it->second.begin(), it->second.end());
+  }
+}
+
+// Call f with the index of every shard of the SymbolMaps in the Index, in parallel, and wait for all calls to finish.
+// Shards of different Databases that have the same index hold the same SymbolIDs. Safe to call from pool threads.
+template <typename F> static void parallelForEachShard(llvm::ThreadPool& pool, const F& f) {
+  llvm::ThreadPoolTaskGroup group(pool);
+  for (uint32_t i = 0; i < hdoc::types::SymbolMap<hdoc::types::FunctionSymbol>::getNumShards(); i++) {
+    group.async([&f, i]() { f(i); });
+  }
+  group.wait();
+}
+
+/// Append the dependencies seen by collector to deps as absolute paths without any dots.
+static void appendDependencies(clang::CompilerInstance&         ci,
+                               const clang::DependencyCollector& collector,
+                               std::vector<std::string>&         deps) {
+  auto& vfs = ci.getFileManager().getVirtualFileSystem();
+  for (const std::string& dep : collector.getDependencies()) {
+    llvm::SmallString<256> path(dep);
+    vfs.makeAbsolute(path);
+    llvm::sys::path::remove_dots(path, /*remove_dot_dot=*/true);
+    deps.emplace_back(path.str());
+  }
+}
+
+namespace {
+/// Collects the paths of all files included by a TU, including system headers.
+class IncludedFilesCollector : public clang::DependencyCollector {
+public:
+  bool needSystemDependencies() override {
+    return true;
+  }
+};
+
+/// Only runs the preprocessor over a TU, collecting the absolute paths of the non-system files it includes.
+class IncludeScanAction : public clang::PreprocessOnlyAction {
+public:
+  IncludeScanAction(std::vector<std::string>& headers) : headers(headers) {}
+
+  bool BeginSourceFileAction(clang::CompilerInstance& ci) override {
+    this->collector = std::make_shared<clang::DependencyCollector>();
+    this->collector->attachToPreprocessor(ci.getPreprocessor());
+    return clang::PreprocessOnlyAction::BeginSourceFileAction(ci);
+  }
+
+  void EndSourceFileAction() override {
+    clang::PreprocessOnlyAction::EndSourceFileAction();
+    appendDependencies(this->getCompilerInstance(), *this->collector, this->headers);
+  }
+
+private:
+  std::vector<std::string>&                   headers;
+  std::shared_ptr<clang::DependencyCollector> collector = nullptr;
+};
+
+class IncludeScanActionFactory : public clang::tooling::FrontendActionFactory {
+public:
+  IncludeScanActionFactory(std::vector<std::string>& headers) : headers(headers) {}
+
+  std::unique_ptr<clang::FrontendAction> create() override {
+    return std::make_unique<IncludeScanAction>(this->headers);
+  }
+
+private:
+  std::vector<std::string>& headers;
+};
+
+/// Runs hdoc's matchers over a TU. If deps isn't nullptr, it's filled with the absolute
+/// paths of every file the TU included so that the index cache can tell when it becomes stale.
+/// If ownedFiles isn't nullptr, files are claimed in the HeaderRegistry as they're entered.
+template <typename BaseAction = clang::ASTFrontendAction> class IndexingAction : public BaseAction {
+public:
+  IndexingAction(hdoc::indexer::matchers::IndexMatchers& matchers,
+                 std::vector<std::string>*               deps,
+                 hdoc::indexer::OwnedFiles*              ownedFiles)
+      : matchers(matchers), deps(deps), ownedFiles(ownedFiles) {}
+
+  std::unique_ptr<clang::ASTConsumer> CreateASTConsumer(clang::CompilerInstance& ci, llvm::StringRef) override {
+    if (this->deps != nullptr) {
+      this->collector = std::make_shared<IncludedFilesCollector>();
+      this->collector->attachToPreprocessor(ci.getPreprocessor());
+    }
+    if (this->ownedFiles != nullptr) {
+      this->ownedFiles->attachToPreprocessor(ci.getPreprocessor());
+    }
+    return this->matchers.newASTConsumer();
+  }
+
+  void EndSourceFileAction() override {
+    BaseAction::EndSourceFileAction();
+    if (this->collector != nullptr) {
+      appendDependencies(this->getCompilerInstance(), *this->collector, *this->deps);
+    }
+  }
+
+private:
+  hdoc::indexer::matchers::IndexMatchers& matchers;
+  std::vector<std::string>*               deps;
+  hdoc::indexer::OwnedFiles*              ownedFiles;
+  std::shared_ptr<IncludedFilesCollector> collector = nullptr;
+};
+
+/// Writes a precompiled header to pchPath while running hdoc's matchers over it, so that the declarations in it
+/// are indexed once instead of in every TU that uses it.
+class PrecompiledHeaderAction : public IndexingAction<clang::GeneratePCHAction> {
+public:
+  PrecompiledHeaderAction(hdoc::indexer::matchers::IndexMatchers& matchers,
+                          std::vector<std::string>*               deps,
+                          hdoc::indexer::OwnedFiles*              ownedFiles,
+                          const std::string&                      pchPath)
+      : IndexingAction(matchers, deps, ownedFiles), pchPath(pchPath) {}
+
+  bool BeginInvocation(clang::CompilerInstance& ci) override {
+    // Tools are run with -fsyntax-only and without an output file, so the output has to be set here
+    ci.getFrontendOpts().OutputFile = this->pchPath;
+    return IndexingAction::BeginInvocation(ci);
+  }
+
+  std::unique_ptr<clang::ASTConsumer> CreateASTConsumer(clang::CompilerInstance& ci, llvm::StringRef inFile) override {
+    std::unique_ptr<clang::ASTConsumer> pchConsumer = clang::GeneratePCHAction::CreateASTConsumer(ci, inFile);
+    if (pchConsumer == nullptr) {
+      return nullptr;
+    }
+    std::vector<std::unique_ptr<clang::ASTConsumer>> consumers;
+    consumers.emplace_back(std::move(pchConsumer));
+    consumers.emplace_back(IndexingAction::CreateASTConsumer(ci, inFile));
+    return std::make_unique<clang::MultiplexConsumer>(std::move(consumers));
+  }
+
+private:
+  std::string pchPath;
+};
+
+/// Creates IndexingActions, or PrecompiledHeaderActions if pchPath isn't empty.
+class IndexingActionFactory : public clang::tooling::FrontendActionFactory {
+public:
+  IndexingActionFactory(hdoc::indexer::matchers::IndexMatchers& matchers,
+                        std::vector<std::string>*               deps,
+                        hdoc::indexer::OwnedFiles*              ownedFiles,
+                        const std::string&                      pchPath = "")
+      : matchers(matchers), deps(deps), ownedFiles(ownedFiles), pchPath(pchPath) {}
+
+  std::unique_ptr<clang::FrontendAction> create() override {
+    if (this->pchPath.empty() == false) {
+      return std::make_unique<PrecompiledHeaderAction>(this->matchers, this->deps, this->ownedFiles, this->pchPath);
+    }
+    return std::make_unique<IndexingAction<>>(this->matchers, this->deps, this->ownedFiles);
+  }
+
+private:
+  hdoc::indexer::matchers::IndexMatchers& matchers;
+  std::vector<std::string>*               deps;
+  hdoc::indexer::OwnedFiles*              ownedFiles;
+  std::string                             pchPath;
+};
+
+/// Holds the compile commands of the single TU that a worker process indexes, as sent in its request.
+class WorkerCompilationDatabase : public clang::tooling::CompilationDatabase {
+public:
+  WorkerCompilationDatabase(const std::vector<clang::tooling::CompileCommand>& cmds) : cmds(cmds) {}
+
+  std::vector<clang::tooling::CompileCommand> getCompileCommands(llvm::StringRef) const override {
+    return this->cmds;
+  }
+
+private:
+  const std::vector<clang::tooling::CompileCommand>& cmds;
+};
+
+} // namespace
+
+bool hdoc::indexer::Indexer::indexTranslationUnit(const ParallelExecutor&   tool,
+                                                  const std::string&        path,
+                                                  hdoc::types::Index&       tuIndex,
+                                                  std::vector<std::string>* deps,
+                                                  OwnedFiles*               ownedFiles) const {
+  hdoc::indexer::matchers::IndexMatchers matchers(&tuIndex, this->cfg, ownedFiles);
+  IndexingActionFactory                  factory(matchers, deps, ownedFiles);
 
+  // Nothing collected while trying to use an unusable precompiled header is kept when the TU is parsed without it
+  const auto reset = [&]() {
+    tuIndex.clear();
+    if (deps != nullptr) {
+      deps->clear();
+    }
+    if (ownedFiles != nullptr) {
+      ownedFiles->reset();
+    }
+  };
+  return tool.runClang(path, &factory, reset);
+}
+
+bool hdoc::indexer::Indexer::buildPrecompiledHeader(const ParallelExecutor&   tool,
+                                                    const std::string&        file,
+                                                    const std::string&        pchPath,
+                                                    hdoc::types::Index&       pchIndex,
+                                                    std::vector<std::string>& deps,
+                                                    OwnedFiles&               ownedFiles) const {
+  hdoc::indexer::matchers::IndexMatchers matchers(&pchIndex, this->cfg, &ownedFiles);
+  IndexingActionFactory                  factory(matchers, &deps, &ownedFiles, pchPath);
+  return tool.runClangOnHeader(this->cfg->precompiledHeader.string(), file, &factory);
+}
+
+/// Write a JSON report of the translation units in picked, which were indexed, and of which translation units
+/// include each header, to path. If registry isn't nullptr, the translation unit that indexed each header is the
+/// one that claimed it there. Otherwise every picked translation unit indexes the header, and the symbols of the
+/// first one are kept when merging.
+static void writeCoverageReport(const std::filesystem::path&                 path,
+                                const std::vector<std::string>&              files,
+                                const std::vector<std::vector<std::string>>& headers,
+                                const std::vector<std::string>&              picked,
+                                const hdoc::indexer::HeaderRegistry*         registry) {
+  const llvm::StringSet<> isPicked(picked.begin(), picked.end());
+
+  // Sort headers by path so that reports of different runs can be compared
+  std::map<std::string, std::vector<uint64_t>> includedBy;
+  for (uint64_t i = 0; i < headers.size(); i++) {
+    for (const auto& header : headers[i]) {
+      auto& tus = includedBy[header];
+      if (tus.empty() || tus.back() != i) {
+        tus.emplace_back(i);
+      }
+    }
+  }
+
+  rapidjson::StringBuffer                          buf;
+  rapidjson::PrettyWriter<rapidjson::StringBuffer> writer(buf);
+  writer.StartObject();
+  writer.String("indexedTranslationUnits");
+  writer.StartArray();
+  for (const auto& file : picked) {
+    writer.String(file);
+  }
+  writer.EndArray();
+
+  writer.String("headers");
+  writer.StartArray();
+  for (const auto& [header, tus] : includedBy) {
+    writer.StartObject();
+    writer.String("path");
+    writer.String(header);
+    writer.String("indexedBy");
+    std::string indexedBy;
+    if (registry != nullptr) {
+      // Files are claimed by their real path, which only differs from the path of the header through symlinks
+      indexedBy = registry->getOwner(header);
+      llvm::SmallString<256> realPath;
+      if (indexedBy.empty() && llvm::sys::fs::real_path(header, realPath) == std::error_code()) {
+        indexedBy = registry->getOwner(realPath);
+      }
+    } else {
+      // TUs are in ascending order, so this is the TU whose symbols are kept
+      for (const uint64_t i : tus) {
+        if (isPicked.contains(files[i])) {
+          indexedBy = files[i];
+          break;
+        }
+      }
+    }
+    if (indexedBy.empty()) {
+      writer.Null();
+    } else {
+      writer.String(indexedBy);
+    }
+    writer.String("includedBy");
+    writer.StartArray();
+    for (const uint64_t i : tus) {
+      writer.String(files[i]);
+    }
+    writer.EndArray();
+    writer.EndObject();
+  }
+  writer.EndArray();
+  writer.EndObject();
+
+  std::ofstream out(path);
+  if (!out) {
+    spdlog::error("Failed to open coverage report {}.", path.string());
+    return;
+  }
+  out << buf.GetString();
+  spdlog::info("Coverage report written to {}.", path.string());
+}
+
+std::vector<std::string>
+hdoc::indexer::Indexer::findCoveringFiles(const ParallelExecutor&                tool,
+                                          const std::vector<std::string>&        files,
+                                          std::vector<std::vector<std::string>>& headers) const {
+  spdlog::info("Scanning includes of {} translation units.", files.size());
+
+  llvm::StringMap<uint32_t> positions;
+  for (uint32_t i = 0; i < files.size(); i++) {
+    positions[files[i]] = i;
+  }
+
+  // Only headers in the project that aren't ignored need to be covered, the TU's own source file never does
+  headers.assign(files.size(), {});
+  const hdoc::utils::PathMatcher ignorePaths(this->cfg->ignorePaths);
+  tool.execute(files, [&](const std::string& path) {
+    std::vector<std::string> deps;
+    IncludeScanActionFactory factory(deps);
+    // A TU that fails to preprocess still reports the headers it got to
+    tool.runClang(path, &factory);
+
+    std::vector<std::string>& tuHeaders = headers[positions.lookup(path)];
+    for (const auto& dep : deps) {
+      const std::string relative = std::filesystem::path(dep).lexically_relative(this->cfg->rootDir).string();
+      if (dep == path || relative.empty() || relative.starts_with("..")) {
+        continue;
+      }
+      if (ignorePaths.isMatch(relative) == false) {
+        tuHeaders.emplace_back(dep);
+      }
+    }
+  });
+
+  const std::vector<uint64_t> picked = hdoc::indexer::findCoveringSet(headers);
+  spdlog::info("Indexing {} of {} translation units, which include all headers in the project.",
+               picked.size(),
+               files.size());
+
+  std::vector<std::string> coveringFiles;
+  for (const uint64_t i : picked) {
+    coveringFiles.emplace_back(files[i]);
+  }
+  return coveringFiles;
+}
+
+std::unique_ptr<clang::tooling::CompilationDatabase> hdoc::indexer::Indexer::loadCompilationDatabase() const {
   std::string err;
   const auto  stx = clang::tooling::JSONCommandLineSyntax::AutoDetect;
-  const auto  cmpdb =
+  auto        cmpdb =
       clang::tooling::JSONCompilationDatabase::loadFromFile(this->cfg->compileCommandsJSON.string(), err, stx);
 
   if (cmpdb == nullptr) {
     spdlog::error("Unable to initialize compilation database ({})", err);
-    return;
   }
+  return cmpdb;
+}
 
-  hdoc::indexer::matchers::FunctionMatcher  FunctionFinder(&this->index, this->cfg);
-  hdoc::indexer::matchers::RecordMatcher    RecordFinder(&this->index, this->cfg);
-  hdoc::indexer::matchers::EnumMatcher      EnumFinder(&this->index, this->cfg);
-  hdoc::indexer::matchers::NamespaceMatcher NamespaceFinder(&this->index, this->cfg);
-  hdoc::indexer::matchers::UsingMatcher     UsingFinder(&this->index, this->cfg);
-  clang::ast_matchers::MatchFinder          Finder;
-  Finder.addMatcher(FunctionFinder.getMatcher(), &FunctionFinder);
-  Finder.addMatcher(RecordFinder.getMatcher(), &RecordFinder);
-  Finder.addMatcher(EnumFinder.getMatcher(), &EnumFinder);
-  Finder.addMatcher(NamespaceFinder.getMatcher(), &NamespaceFinder);
-  Finder.addMatcher(UsingFinder.getMatcher(), &UsingFinder);
-
+std::vector<std::string> hdoc::indexer::Indexer::getExtraArgs() const {
   // Add include search paths to clang invocation
-  std::vector<std::string> includePaths = {};
+  std::vector<std::string> extraArgs = {};
   for (const std::string& d : cfg->includePaths) {
     // Ignore include paths that don't exist
     if (!std::filesystem::exists(d)) {
@@ -53,141 +413,472 @@ void hdoc::indexer::Indexer::run() {
       continue;
     }
     spdlog::info("Appending {} to list of include paths.", d);
-    includePaths.emplace_back("-isystem" + d);
+    extraArgs.emplace_back("-isystem" + d);
   }
 
-  hdoc::indexer::ParallelExecutor tool(*cmpdb, includePaths, this->pool, this->cfg->debugLimitNumIndexedFiles);
-  tool.execute(clang::tooling::newFrontendActionFactory(&Finder));
+  // hdoc only looks at declarations, so the bodies of functions don't need to be parsed or semantically analyzed.
+  // Clang still parses bodies that are needed to understand a declaration, such as those of constexpr functions
+  // and functions with deduced return types.
+  if (this->cfg->skipFunctionBodies) {
+    extraArgs.insert(extraArgs.end(), {"-Xclang", "-skip-function-bodies"});
+  }
+  return extraArgs;
 }
 
-void hdoc::indexer::Indexer::resolveNamespaces() {
-  spdlog::info("Indexer resolving namespaces.");
-  for (auto& [k, ns] : this->index.namespaces.entries) {
-    // Add all the direct children of this namespace to its children vector
-    for (const auto& [k, v] : this->index.records.entries) {
-      if (isChild(ns, v)) {
-        ns.records.emplace_back(v.ID);
+bool hdoc::indexer::Indexer::indexTranslationUnitInWorker(const std::string&                                 path,
+                                                          const std::vector<clang::tooling::CompileCommand>& cmds,
+                                                          const std::vector<std::string>& extraArgs,
+                                                          const std::string&              pchPath,
+                                                          const HeaderRegistry*           registry,
+                                                          WorkerResult&                   result) const {
+  WorkerRequest request;
+  request.tu                       = path;
+  request.pchPath                  = pchPath;
+  request.commands                 = cmds;
+  request.extraArgs                = extraArgs;
+  request.cfg.rootDir              = this->cfg->rootDir;
+  request.cfg.ignorePaths          = this->cfg->ignorePaths;
+  request.cfg.ignoreNamespaces     = this->cfg->ignoreNamespaces;
+  request.cfg.detailNamespaces     = this->cfg->detailNamespaces;
+  request.cfg.ignorePrivateMembers = this->cfg->ignorePrivateMembers;
+  request.cfg.pruneAST             = this->cfg->pruneAST;
+  request.cfg.deduplicateHeaders   = this->cfg->deduplicateHeaders;
+  if (registry != nullptr) {
+    request.claimedFiles = registry->getClaimedFiles();
+  }
+
+  llvm::SmallString<256> requestPath;
+  if (const std::error_code ec = llvm::sys::fs::createTemporaryFile("hdoc-worker", "req", requestPath)) {
+    spdlog::error("Unable to create request file for worker indexing {}: {}", path, ec.message());
+    return false;
+  }
+  const std::string resultPath = requestPath.str().str() + ".res";
+  llvm::FileRemover requestRemover(requestPath);
+  llvm::FileRemover resultRemover(resultPath);
+
+  if (auto err = llvm::writeToOutput(requestPath, [&](llvm::raw_ostream& os) {
+        os << serializeWorkerRequest(request);
+        return llvm::Error::success();
+      })) {
+    spdlog::error("Unable to write request file for worker indexing {}: {}", path, llvm::toString(std::move(err)));
+    return false;
+  }
+
+  const std::string                  executable = this->cfg->executablePath.string();
+  llvm::SmallVector<llvm::StringRef> args       = {executable, "--index-worker", requestPath};
+  if (spdlog::should_log(spdlog::level::info)) {
+    args.emplace_back("--verbose");
+  }
+
+  // A crash may be caused by something transient like running out of memory, so crashed workers get one more try
+  for (uint32_t attempt = 0; attempt < 2; attempt++) {
+    std::string errMsg = "";
+    const int   rc =
+        llvm::sys::ExecuteAndWait(executable, args, std::nullopt, {}, 0, this->cfg->workerMemoryLimit, &errMsg);
+    if (rc == 0) {
+      auto buf = llvm::MemoryBuffer::getFile(resultPath, /*IsText=*/false, /*RequiresNullTerminator=*/false);
+      if (buf && deserializeWorkerResult(buf->get()->getBuffer(), result)) {
+        return true;
       }
+      errMsg = "unreadable result";
+    } else if (rc == -2) {
+      errMsg = "crashed";
     }
-    for (const auto& [k, v] : this->index.enums.entries) {
-      if (isChild(ns, v)) {
-        ns.enums.emplace_back(v.ID);
+    spdlog::warn("Worker indexing {} failed ({}, {}).", path, rc, errMsg);
+  }
+  spdlog::error("Worker failed to index {} twice. Information from this file will be missing from hdoc's output", path);
+  return false;
+}
+
+bool hdoc::indexer::Indexer::runWorker(const std::filesystem::path& requestPath) {
+  auto buf = llvm::MemoryBuffer::getFile(requestPath.string(), false, false);
+  if (!buf) {
+    spdlog::error("Unable to read worker request {}", requestPath.string());
+    return false;
+  }
+  WorkerRequest request;
+  if (deserializeWorkerRequest(buf->get()->getBuffer(), request) == false) {
+    spdlog::error("Worker request {} is malformed", requestPath.string());
+    return false;
+  }
+
+  // Workers only parse a single TU, so a single thread is enough
+  llvm::ThreadPool                pool(llvm::hardware_concurrency(1));
+  const Indexer                   indexer(&request.cfg, pool);
+  const WorkerCompilationDatabase cmpdb(request.commands);
+  hdoc::indexer::ParallelExecutor tool(cmpdb, request.extraArgs, pool, 0);
+  if (request.pchPath.empty() == false) {
+    tool.usePrecompiledHeader(request.pchPath);
+  }
+
+  // Files claimed by other TUs are owned by an empty TU path so that this TU can't claim them
+  hdoc::indexer::HeaderRegistry registry;
+  for (const auto& file : request.claimedFiles) {
+    registry.claim(file, "");
+  }
+  hdoc::indexer::OwnedFiles ownedFiles(request.cfg.deduplicateHeaders ? &registry : nullptr,
+                                       request.tu,
+                                       /*skipPrecompiled=*/request.pchPath.empty() == false);
+
+  WorkerResult result;
+  result.success      = indexer.indexTranslationUnit(tool, request.tu, result.index, &result.deps, &ownedFiles);
+  result.claimedFiles = ownedFiles.getClaimedFiles();
+  result.skippedFiles = ownedFiles.getSkippedFiles();
+
+  const std::string resultPath = requestPath.string() + ".res";
+  if (auto err = llvm::writeToOutput(resultPath, [&](llvm::raw_ostream& os) {
+        os << serializeWorkerResult(result);
+        return llvm::Error::success();
+      })) {
+    spdlog::error("Unable to write worker result {}: {}", resultPath, llvm::toString(std::move(err)));
+    return false;
+  }
+  return true;
+}
+
+void hdoc::indexer::Indexer::run() {
+  spdlog::info("Starting indexing...");
+
+  const auto cmpdb = this->loadCompilationDatabase();
+  if (cmpdb == nullptr) {
+    return;
+  }
+  const std::vector<std::string> extraArgs = this->getExtraArgs();
+
+  hdoc::indexer::ParallelExecutor tool(*cmpdb, extraArgs, this->pool, this->cfg->debugLimitNumIndexedFiles);
+  hdoc::indexer::HeaderRegistry   registry;
+  hdoc::indexer::IndexMerger      merger;
+  std::atomic<uint32_t>           numCachedFiles = 0;
+
+  // The position of each TU in the list decides which TU's symbols win when they're merged.
+  // Position 0 is reserved for the precompiled header.
+  const std::vector<std::string> files = tool.getFiles();
+  llvm::StringMap<uint32_t>      positions;
+  for (uint32_t i = 0; i < files.size(); i++) {
+    positions[files[i]] = i + 1;
+  }
+
+  // Optionally skip TUs that don't include any headers that the rest of the TUs don't include already
+  std::vector<std::vector<std::string>> headers;
+  const std::vector<std::string>        indexedFiles =
+      this->cfg->coveringTUsOnly ? this->findCoveringFiles(tool, files, headers) : files;
+
+  // Common headers are parsed once into a precompiled header that every TU loads instead of parsing them again.
+  // It's built with the flags of the first TU, and TUs with incompatible flags fall back to parsing without it.
+  llvm::SmallString<256>   pchPath;
+  llvm::FileRemover        pchRemover;
+  std::vector<std::string> pchDeps;
+  std::vector<std::string> cacheArgs = extraArgs;
+  if (this->cfg->precompiledHeader.empty() == false && indexedFiles.size() > 0) {
+    if (const std::error_code ec = llvm::sys::fs::createTemporaryFile("hdoc", "pch", pchPath)) {
+      spdlog::warn("Unable to create precompiled header file: {}", ec.message());
+    } else {
+      pchRemover.setFile(pchPath);
+      const std::string header = this->cfg->precompiledHeader.string();
+      spdlog::info("Building precompiled header {}", header);
+
+      // Files are claimed in a separate registry so that nothing is claimed if building the precompiled header fails
+      hdoc::indexer::HeaderRegistry pchRegistry;
+      hdoc::indexer::OwnedFiles     pchOwnedFiles(&pchRegistry, header);
+      hdoc::types::Index            pchIndex;
+      if (this->buildPrecompiledHeader(
+              tool, indexedFiles.front(), pchPath.str().str(), pchIndex, pchDeps, pchOwnedFiles)) {
+        if (this->cfg->deduplicateHeaders) {
+          for (const auto& file : pchOwnedFiles.getClaimedFiles()) {
+            registry.claim(file, header);
+          }
+        }
+        merger.add(pchIndex, 0);
+        tool.usePrecompiledHeader(pchPath.str().str());
+        cacheArgs.insert(cacheArgs.end(), {"-include-pch", header});
+      } else {
+        spdlog::warn("Unable to build precompiled header {}, indexing without it.", header);
+        pchPath.clear();
+        pchDeps.clear();
       }
     }
-    for (const auto& [k, v] : this->index.namespaces.entries) {
-      if (isChild(ns, v)) {
-        ns.namespaces.emplace_back(v.ID);
+  }
+
+  // TUs indexed with the precompiled header lack its symbols, so they're cached separately from ones without it
+  hdoc::indexer::IndexCache  cache(this->cfg, cacheArgs);
+  hdoc::indexer::TUCostModel costModel(this->cfg->cacheDir);
+
+  // TUs loaded from the cache that left files for other TUs to index. They may have to be parsed again, so they're
+  // only merged once that's decided, otherwise their symbols would be merged twice.
+  struct CachedTU {
+    std::string                         path;
+    uint32_t                            position = 0;
+    std::unique_ptr<hdoc::types::Index> index;
+    std::vector<std::string>            skippedFiles;
+  };
+  std::mutex            cachedTUsMutex;
+  std::vector<CachedTU> cachedTUs;
+
+  // Each TU is indexed into its own Index so that worker threads don't share any state while matching,
+  // and so that the contribution of each TU can be cached separately
+  const auto indexFile = [&](const std::string& path, const bool useCache) {
+    const uint32_t                                    position = positions.lookup(path);
+    const std::vector<clang::tooling::CompileCommand> cmds     = cmpdb->getCompileCommands(path);
+    if (useCache && cache.enabled()) {
+      auto                     cachedIndex = std::make_unique<hdoc::types::Index>();
+      std::vector<std::string> claimedFiles;
+      std::vector<std::string> skippedFiles;
+      if (cache.load(cmds, *cachedIndex, claimedFiles, skippedFiles)) {
+        numCachedFiles++;
+        for (const auto& file : claimedFiles) {
+          registry.claim(file, path);
+        }
+        if (skippedFiles.empty()) {
+          merger.add(*cachedIndex, position);
+          return;
+        }
+        std::lock_guard<std::mutex> lock(cachedTUsMutex);
+        cachedTUs.push_back({path, position, std::move(cachedIndex), std::move(skippedFiles)});
+        return;
       }
     }
-    for (const auto& [k, v] : this->index.aliases.entries) {
-      if (isChild(ns, v)) {
-        ns.usings.emplace_back(v.ID);
+
+    hdoc::indexer::HeaderRegistry* ownerRegistry = this->cfg->deduplicateHeaders ? &registry : nullptr;
+    WorkerResult                   result;
+    const auto                     start = std::chrono::steady_clock::now();
+    if (this->cfg->isolateTUs) {
+      // Workers can't access the registry, so they're given the files claimed so far and report back what they claim
+      this->indexTranslationUnitInWorker(path, cmds, extraArgs, pchPath.str().str(), ownerRegistry, result);
+      if (ownerRegistry != nullptr) {
+        for (const auto& file : result.claimedFiles) {
+          ownerRegistry->claim(file, path);
+        }
       }
+    } else {
+      hdoc::indexer::OwnedFiles ownedFiles(ownerRegistry, path, /*skipPrecompiled=*/pchPath.empty() == false);
+      result.success =
+          this->indexTranslationUnit(tool, path, result.index, cache.enabled() ? &result.deps : nullptr, &ownedFiles);
+      result.claimedFiles = ownedFiles.getClaimedFiles();
+      result.skippedFiles = ownedFiles.getSkippedFiles();
     }
-    for (const auto& [k, v] : this->index.functions.entries) {
-      if (isChild(ns, v)) {
-        ns.functions.emplace_back(v.ID);
-      }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    costModel.record(path, seconds);
+    if (this->instrumentation != nullptr) {
+      this->instrumentation->recordTranslationUnit(path, seconds);
+    }
+
+    // TUs that failed to parse aren't cached so that they are retried on the next run
+    if (result.success && cache.enabled()) {
+      // Files in the precompiled header aren't entered by the preprocessor, but the TU depends on them all the same
+      result.deps.insert(result.deps.end(), pchDeps.begin(), pchDeps.end());
+      cache.store(cmds, result.deps, result.claimedFiles, result.skippedFiles, result.index);
+    }
+    merger.add(result.index, position);
+  };
+
+  // The thread pool hands TUs to whichever thread is free, in the order they're queued. Queueing the TUs that
+  // are expected to take longest first keeps a huge TU from running on its own after all others are done.
+  std::vector<std::string> schedule = indexedFiles;
+  costModel.sortByDescendingCost(schedule);
+  tool.execute(schedule, [&](const std::string& path) { indexFile(path, true); });
+
+  // A TU loaded from the cache skipped the headers that other TUs claimed when it was last parsed. If none of the
+  // TUs claimed one of them in this run, for example because its previous owner no longer includes it, the TU
+  // has to be parsed again so that the header's symbols aren't lost, and its cached symbols are dropped.
+  std::vector<std::string> staleFiles;
+  for (auto& tu : cachedTUs) {
+    const bool isStale = std::any_of(tu.skippedFiles.begin(), tu.skippedFiles.end(), [&](const std::string& file) {
+      return registry.isClaimed(file) == false;
+    });
+    if (isStale) {
+      staleFiles.emplace_back(tu.path);
+    } else {
+      merger.add(*tu.index, tu.position);
     }
   }
+  cachedTUs.clear();
+  if (staleFiles.size() > 0) {
+    spdlog::info("Re-indexing {} cached translation units that include headers no other translation unit indexed.",
+                 staleFiles.size());
+    numCachedFiles -= staleFiles.size();
+    costModel.sortByDescendingCost(staleFiles);
+    tool.execute(staleFiles, [&](const std::string& path) { indexFile(path, false); });
+  }
+
+  if (cache.enabled()) {
+    spdlog::info("Reused {} of {} translation units from the index cache.", numCachedFiles.load(), indexedFiles.size());
+  }
+
+  costModel.store();
+
+  // The report is written after indexing so that it can name the TU that claimed each header
+  if (this->cfg->coveringTUsOnly && this->cfg->coverageReport.empty() == false) {
+    writeCoverageReport(this->cfg->coverageReport,
+                        files,
+                        headers,
+                        indexedFiles,
+                        this->cfg->deduplicateHeaders ? &registry : nullptr);
+  }
+
+  spdlog::info("Merging indexes of all translation units.");
+  merger.finish(this->index, this->pool);
+}
+
+void hdoc::indexer::Indexer::resolveNamespaces() {
+  spdlog::info("Indexer resolving namespaces.");
+
+  // Bucket every symbol by its parent in a single pass over each database, rather than scanning all symbols for
+  // every namespace. The buckets are only read afterwards, so the namespaces can then be filled in parallel.
+  ParentBuckets             records;
+  ParentBuckets             enums;
+  ParentBuckets             namespaces;
+  ParentBuckets             aliases;
+  ParentBuckets             functions;
+  llvm::ThreadPoolTaskGroup group(this->pool);
+  group.async([&]() { records = bucketByParent(this->index.records); });
+  group.async([&]() { enums = bucketByParent(this->index.enums); });
+  group.async([&]() { namespaces = bucketByParent(this->index.namespaces); });
+  group.async([&]() { aliases = bucketByParent(this->index.aliases); });
+  group.async([&]() { functions = bucketByParent(this->index.functions); });
+  group.wait();
+
+  // Each namespace is only modified by the thread that handles its shard
+  parallelForEachShard(this->pool, [&](const uint32_t i) {
+    for (auto& [k, ns] : this->index.namespaces.entries.getShard(i)) {
+      appendChildren(ns.records, records, ns.ID);
+      appendChildren(ns.enums, enums, ns.ID);
+      appendChildren(ns.namespaces, namespaces, ns.ID);
+      appendChildren(ns.usings, aliases, ns.ID);
+      appendChildren(ns.functions, functions, ns.ID);
+    }
+  });
   spdlog::info("Indexer namespace resolution complete.");
 }
 
 void hdoc::indexer::Indexer::updateRecordNames() {
   spdlog::info("Indexer updating record names with inheritance information.");
-  for (auto& [k, c] : this->index.records.entries) {
-    if (c.baseRecords.size() > 0) {
-      uint64_t count = 0;
-      c.proto += " : ";
-      for (const auto& baseRecord : c.baseRecords) {
-        if (count > 0) {
-          c.proto += ", ";
-        }
+  parallelForEachShard(this->pool, [&](const uint32_t i) {
+    for (auto& [k, c] : this->index.records.entries.getShard(i)) {
+      if (c.baseRecords.size() > 0) {
+        uint64_t count = 0;
+        c.proto += " : ";
+        for (const auto& baseRecord : c.baseRecords) {
+          if (count > 0) {
+            c.proto += ", ";
+          }
 
-        // Print the access type that indicates which kind of inheritance was used
-        switch (baseRecord.access) {
-        case clang::AS_public:
-          c.proto += "public ";
-          break;
-        case clang::AS_private:
-          c.proto += "private ";
-          break;
-        case clang::AS_protected:
-          c.proto += "protected ";
-          break;
-        case clang::AS_none:
-        // intentional fallthrough
-        default:
-          break;
+          // Print the access type that indicates which kind of inheritance was used
+          switch (baseRecord.access) {
+          case clang::AS_public:
+            c.proto += "public ";
+            break;
+          case clang::AS_private:
+            c.proto += "private ";
+            break;
+          case clang::AS_protected:
+            c.proto += "protected ";
+            break;
+          case clang::AS_none:
+          // intentional fallthrough
+          default:
+            break;
+          }
+
+          c.proto += baseRecord.name;
+          count++;
         }
+      }
+    }
+  });
+}
 
-        c.proto += baseRecord.name;
-        count++;
+void hdoc::indexer::replaceMethodTemplateParams(const hdoc::types::RecordSymbol& c,
+                                                hdoc::types::FunctionSymbol&     f,
+                                                std::string&                     buf) {
+  // A placeholder names the parameter at its index in the template parameter list at its depth. Only the lists of
+  // the record and the method itself are known, so placeholders of enclosing templates are left as they are.
+  const auto getName = [&](const uint64_t depth, const uint64_t index) -> const std::string* {
+    for (const auto* params : {&c.templateParams, &f.templateParams}) {
+      if (params->empty() || params->front().depth != depth) {
+        continue;
       }
+      if (index >= params->size() || (*params)[index].name.empty()) {
+        return nullptr;
+      }
+      return &(*params)[index].name;
+    }
+    return nullptr;
+  };
+
+  // The offsets of the name and the end of the template part move along with the substitutions
+  uint64_t offsets[] = {f.postTemplate, f.nameStart};
+  if (hdoc::utils::replaceTemplateTypeParams(f.proto, buf, getName, offsets)) {
+    spdlog::debug("Updated function proto to {}", f.proto);
+    f.postTemplate = offsets[0];
+    f.nameStart    = offsets[1];
+  }
+  hdoc::utils::replaceTemplateTypeParams(f.name, buf, getName);
+  std::string scratch;
+  for (auto& param : f.params) {
+    // Interned strings can't be modified in place, so the substitution is made in a copy
+    scratch = param.type.name.str();
+    if (hdoc::utils::replaceTemplateTypeParams(scratch, buf, getName)) {
+      param.type.name = scratch;
     }
+    hdoc::utils::replaceTemplateTypeParams(param.defaultValue, buf, getName);
   }
 }
 
 void hdoc::indexer::Indexer::updateMemberFunctions() {
-  for (auto& [k, c] : this->index.records.entries) {
-    for (auto& symbol : c.methodIDs) {
-      auto& f = this->index.functions.entries[symbol];
-      // split the proto into parts
-      std::string templatePart = f.proto.substr(0, f.postTemplate);
-      std::string preNamePart = f.proto.substr(f.postTemplate, f.nameStart - f.postTemplate);
-      std::string restPart = f.proto.substr(f.nameStart);
-      std::string name = f.name;
-      // and update them individually
-      auto fixTypeParam = [&](std::string& s) {
-        for(size_t i=0; i<c.templateParams.size(); i++) {
-          s = hdoc::utils::replaceAll(s, "type-parameter-0-" + std::to_string(i), c.templateParams[i].name);
+  // Every method belongs to a single record, so threads handling different records never update the same method
+  parallelForEachShard(this->pool, [&](const uint32_t i) {
+    std::string buf; // Scratch space for all substitutions on this thread
+    for (auto& [k, c] : this->index.records.entries.getShard(i)) {
+      for (auto& symbol : c.methodIDs) {
+        // Methods that were filtered out aren't in the index, and inserting them here would race with other threads
+        const auto it = this->index.functions.entries.find(symbol);
+        if (it == this->index.functions.entries.end()) {
+          continue;
         }
-      };
-      fixTypeParam(templatePart);
-      fixTypeParam(preNamePart);
-      fixTypeParam(restPart);
-      fixTypeParam(name);
-      // so that we can reconstruct the offsets
-      std::string newProto = templatePart + preNamePart + restPart;
-      if(newProto != f.proto) {
-        spdlog::debug("Updating function proto from\n  {} to \n  {}\n  name: {} -> {}", f.proto, newProto, f.name, name);
-        f.proto = templatePart + preNamePart + restPart;
-        f.name = name;
-        f.postTemplate = templatePart.size();
-        f.nameStart = templatePart.size() + preNamePart.size();
-      }
-      // also fix parameters
-      for(auto& param : f.params) {
-        fixTypeParam(param.type.name);
-        fixTypeParam(param.defaultValue);
+        replaceMethodTemplateParams(c, it->second, buf);
       }
     }
-  }
+  });
 }
 
 void hdoc::indexer::Indexer::resolveFunctionOverloads() {
-  for (auto& [k, f] : this->index.functions.entries) {
-    if (f.isRecordMember || f.isHiddenFriend || index.records.contains(f.parentNamespaceID)) {
-      // not a freestanding function
-      continue;
+  // Functions are grouped per shard in parallel, and the groups of all shards are merged afterwards
+  using FunctionGroups = std::map<types::FreestandingFunctionID, types::FreestandingFunction>;
+  const auto warnDetailMismatch = [](const std::string& name) {
+    spdlog::warn(
+        "Function {} has different isDetail values in different overloads. Using the value from the first overload processed.",
+        name);
+  };
+
+  std::vector<FunctionGroups> shardGroups(hdoc::types::SymbolMap<hdoc::types::FunctionSymbol>::getNumShards());
+  parallelForEachShard(this->pool, [&](const uint32_t i) {
+    for (auto& [k, f] : this->index.functions.entries.getShard(i)) {
+      if (f.isRecordMember || f.isHiddenFriend || index.records.contains(f.parentNamespaceID)) {
+        // not a freestanding function
+        continue;
+      }
+      types::FreestandingFunctionID id = {f.name, f.parentNamespaceID};
+      const auto [it, inserted]        = shardGroups[i].try_emplace(id, types::FreestandingFunction{f.isDetail, {}});
+      if (inserted == false && it->second.isDetail != f.isDetail) {
+        warnDetailMismatch(f.name);
+      }
+      f.freestandingID = id;
+      it->second.functionIDs.emplace_back(f.ID);
     }
-    types::FreestandingFunctionID id   = {f.name, f.parentNamespaceID};
-    types::FreestandingFunction*  funs = [&]() {
-      if (index.freestandingFunctions.contains(id)) {
-        auto& existingFuns = index.freestandingFunctions.at(id);
-        if (existingFuns.isDetail != f.isDetail) {
-          spdlog::warn(
-              "Function {} has different isDetail values in different overloads. Using the value from the first overload processed.",
-              f.name);
-        }
-        return &existingFuns;
-      } else {
-        index.freestandingFunctions.insert({id, {f.isDetail, {}}});
-        return &index.freestandingFunctions.at(id);
+  });
+
+  // Merging in shard order processes functions in the same order as iterating over the whole Database
+  for (auto& groups : shardGroups) {
+    for (auto& [id, funs] : groups) {
+      const auto [it, inserted] = index.freestandingFunctions.try_emplace(id, std::move(funs));
+      if (inserted) {
+        continue;
+      }
+      if (it->second.isDetail != funs.isDetail) {
+        warnDetailMismatch(id.name);
       }
-    }();
-    f.freestandingID = id;
-    funs->functionIDs.emplace_back(f.ID);
+      it->second.functionIDs.insert(it->second.functionIDs.end(), funs.functionIDs.begin(), funs.functionIDs.end());
+    }
   }
 }
 
@@ -198,7 +889,7 @@ void hdoc::indexer::Indexer::printStats() const {
                  name,
                  db.numMatches,
                  db.entries.size(),
-                 db.entries.size() * sizeof(T) / 1024);
+                 hdoc::utils::getHeapBytes(db) / 1024);
   };
 
   printDatabaseSize("Functions", this->index.functions);
@@ -207,22 +898,21 @@ void hdoc::indexer::Indexer::printStats() const {
   printDatabaseSize("Namespaces", this->index.namespaces);
   printDatabaseSize("Usings", this->index.aliases);
   spdlog::info("Freestanding function groups: {}", this->index.freestandingFunctions.size());
+  spdlog::info("Interned strings: {}, {} KiB total size",
+               hdoc::types::InternedString::getPoolSize(),
+               hdoc::types::InternedString::getPoolHeapBytes() / 1024);
 }
 
 void hdoc::indexer::Indexer::pruneMethods() {
   // If a method's parent isn't in the index, it was filtered out and not indexed.
   // ergo, it's children shouldn't be indexed either, so we remove them
-  std::vector<hdoc::types::SymbolID> toBePruned;
-  for (const auto& [k, v] : this->index.functions.entries) {
-    if (v.isRecordMember && !this->index.records.contains(v.parentNamespaceID)) {
-      toBePruned.emplace_back(k);
-    }
-  }
-  // Remove methods from index
-  for (const auto& deadSymbolID : toBePruned) {
-    this->index.functions.entries.erase(deadSymbolID);
-  }
-  spdlog::info("Pruned {} functions from the database.", toBePruned.size());
+  std::atomic<uint64_t> numPruned = 0;
+  parallelForEachShard(this->pool, [&](const uint32_t i) {
+    numPruned += std::erase_if(this->index.functions.entries.getShard(i), [&](const auto& entry) {
+      return entry.second.isRecordMember && !this->index.records.contains(entry.second.parentNamespaceID);
+    });
+  });
+  spdlog::info("Pruned {} functions from the database.", numPruned.load());
 }
 
 void hdoc::indexer::Indexer::pruneTypeRefs() {
@@ -230,31 +920,55 @@ void hdoc::indexer::Indexer::pruneTypeRefs() {
     return this->index.records.contains(id) || this->index.enums.contains(id) || this->index.aliases.contains(id);
   };
 
-  for (auto& [k, v] : this->index.functions.entries) {
-    if (haveId(v.returnType.id) == false) {
-      v.returnType.id = hdoc::types::SymbolID();
+  parallelForEachShard(this->pool, [&](const uint32_t i) {
+    for (auto& [k, v] : this->index.functions.entries.getShard(i)) {
+      if (haveId(v.returnType.id) == false) {
+        v.returnType.id = hdoc::types::SymbolID();
+      }
+
+      for (auto& param : v.params) {
+        if (haveId(param.type.id) == false) {
+          param.type.id = hdoc::types::SymbolID();
+        }
+      }
     }
 
-    for (auto& param : v.params) {
-      if (haveId(param.type.id) == false) {
-        param.type.id = hdoc::types::SymbolID();
+    for (auto& [k, v] : this->index.records.entries.getShard(i)) {
+      for (auto& var : v.vars) {
+        if (haveId(var.type.id) == false) {
+          var.type.id = hdoc::types::SymbolID();
+        }
       }
     }
-  }
 
-  for (auto& [k, v] : this->index.records.entries) {
-    for (auto& var : v.vars) {
-      if (haveId(var.type.id) == false) {
-        var.type.id = hdoc::types::SymbolID();
+    for (auto& [k, v] : this->index.aliases.entries.getShard(i)) {
+      if (haveId(v.target.id) == false) {
+        v.target.id = hdoc::types::SymbolID();
       }
     }
-  }
+  });
+}
 
-  for (auto& [k, v] : this->index.aliases.entries) {
-    if (haveId(v.target.id) == false) {
-      v.target.id = hdoc::types::SymbolID();
+void hdoc::indexer::Indexer::postProcess() {
+  const auto runPass = [&](const std::string& name, const auto& pass) {
+    if (this->instrumentation != nullptr) {
+      this->instrumentation->measure(name, pass);
+    } else {
+      pass();
     }
-  }
+  };
+
+  // updateRecordNames only touches the protos of records, which no other pass reads or writes, so it runs
+  // alongside everything else. All other passes must not see the methods that pruneMethods removes.
+  // The remaining passes then only write to fields that the others don't access, so they run concurrently.
+  llvm::ThreadPoolTaskGroup passes(this->pool);
+  passes.async([&]() { runPass("updateRecordNames", [&]() { this->updateRecordNames(); }); });
+  runPass("pruneMethods", [&]() { this->pruneMethods(); });
+  passes.async([&]() { runPass("pruneTypeRefs", [&]() { this->pruneTypeRefs(); }); });
+  passes.async([&]() { runPass("resolveNamespaces", [&]() { this->resolveNamespaces(); }); });
+  passes.async([&]() { runPass("updateMemberFunctions", [&]() { this->updateMemberFunctions(); }); });
+  passes.async([&]() { runPass("resolveFunctionOverloads", [&]() { this->resolveFunctionOverloads(); }); });
+  passes.wait();
 }
 
 const hdoc::types::Index* hdoc::indexer::Indexer::dump() const {
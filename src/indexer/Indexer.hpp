@@ -3,19 +3,51 @@
 
 #pragma once
 
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
 #include "llvm/Support/ThreadPool.h"
 
 #include "types/Config.hpp"
 #include "types/Index.hpp"
 
+namespace clang::tooling {
+class CompilationDatabase;
+struct CompileCommand;
+} // namespace clang::tooling
+
+namespace hdoc::utils {
+class Instrumentation;
+} // namespace hdoc::utils
+
 namespace hdoc::indexer {
+class HeaderRegistry;
+class OwnedFiles;
+class ParallelExecutor;
+struct WorkerResult;
+
 /// @brief Index all of the code in a project into hdoc's internal representation
 class Indexer {
 public:
-  Indexer(const hdoc::types::Config* cfg, llvm::ThreadPool& pool) : cfg(cfg), pool(pool) {}
+  /// If instrumentation isn't nullptr, the time it takes to index each translation unit is recorded in it.
+  Indexer(const hdoc::types::Config*    cfg,
+          llvm::ThreadPool&             pool,
+          hdoc::utils::Instrumentation* instrumentation = nullptr)
+      : cfg(cfg), pool(pool), instrumentation(instrumentation) {}
   /// @brief Run the indexer over project code
   void run();
 
+  /// @brief Index the single TU described by the request at requestPath and write the result next to it.
+  /// Called in worker processes launched by indexTranslationUnitInWorker(), which get all of their options from the
+  /// request. Returns false if the result couldn't be produced, which doesn't include clang failing to parse the TU.
+  static bool runWorker(const std::filesystem::path& requestPath);
+
+  /// @brief Run all of the passes below that process the Index after indexing, in parallel where possible.
+  /// If instrumentation was given to the constructor, the time each pass takes is recorded in it.
+  void postProcess();
+
   /// @brief Update the declaration of the all records to indicate records they inherit
   /// from and the type of inheritance. This must be done after all records are
   /// parsed as the inherited records might not be in the database at parse-time.
@@ -46,9 +78,60 @@ public:
   const hdoc::types::Index* dump() const;
 
 private:
-  hdoc::types::Index         index;
-  const hdoc::types::Config* cfg;
-  llvm::ThreadPool&          pool;
+  /// @brief Load the compilation database named in the config, returning nullptr if it can't be loaded.
+  std::unique_ptr<clang::tooling::CompilationDatabase> loadCompilationDatabase() const;
+
+  /// @brief Get the arguments that are appended to every compile command.
+  std::vector<std::string> getExtraArgs() const;
+
+  /// @brief Parse the translation unit at path and index its symbols into tuIndex.
+  /// If deps isn't nullptr it's filled with the absolute paths of all files the translation unit included.
+  /// If ownedFiles isn't nullptr, only symbols in files that weren't claimed by other translation units are indexed.
+  /// Returns false if clang failed to parse the translation unit.
+  bool indexTranslationUnit(const ParallelExecutor&   tool,
+                            const std::string&        path,
+                            hdoc::types::Index&       tuIndex,
+                            std::vector<std::string>* deps,
+                            OwnedFiles*               ownedFiles) const;
+
+  /// @brief Precompile the configured umbrella header to pchPath with the compile flags of file,
+  /// indexing its symbols into pchIndex. deps is filled with the absolute paths of all files it included,
+  /// and ownedFiles with the files it claimed. Returns false if clang failed to parse the header.
+  bool buildPrecompiledHeader(const ParallelExecutor&   tool,
+                              const std::string&        file,
+                              const std::string&        pchPath,
+                              hdoc::types::Index&       pchIndex,
+                              std::vector<std::string>& deps,
+                              OwnedFiles&               ownedFiles) const;
+
+  /// @brief Index the translation unit at path in a separate hdoc process, so that clang crashing or running out of
+  /// memory doesn't bring down the rest of indexing. Crashed workers are retried once.
+  /// Files in registry are skipped unless registry is nullptr. Returns false if no worker produced a result.
+  /// The worker parses the TU with cmds and extraArgs instead of loading the compilation database again.
+  bool indexTranslationUnitInWorker(const std::string&                                 path,
+                                    const std::vector<clang::tooling::CompileCommand>& cmds,
+                                    const std::vector<std::string>&                    extraArgs,
+                                    const std::string&                                 pchPath,
+                                    const HeaderRegistry*                              registry,
+                                    WorkerResult&                                      result) const;
+
+  /// @brief Scan the includes of files with the preprocessor and return the smallest subset of them,
+  /// as picked by findCoveringSet(), that includes every non-ignored header under the root directory.
+  /// headers is filled with the non-ignored headers that each of files includes.
+  std::vector<std::string> findCoveringFiles(const ParallelExecutor&                tool,
+                                             const std::vector<std::string>&        files,
+                                             std::vector<std::vector<std::string>>& headers) const;
+
+  hdoc::types::Index            index;
+  const hdoc::types::Config*    cfg;
+  llvm::ThreadPool&             pool;
+  hdoc::utils::Instrumentation* instrumentation;
 };
 
+/// @brief Replace the placeholders that clang prints for template parameters in the proto, name, and parameters of
+/// method f of record c with the names of the parameters, see hdoc::utils::replaceTemplateTypeParams().
+/// Only placeholders that refer to the template parameters of c or f are replaced, since those of enclosing
+/// templates aren't known. buf is scratch space that can be reused across calls.
+void replaceMethodTemplateParams(const hdoc::types::RecordSymbol& c, hdoc::types::FunctionSymbol& f, std::string& buf);
+
 } // namespace hdoc::indexer
@@ -0,0 +1,144 @@
+// Copyright 2019-2023 hdoc
+// SPDX-License-Identifier: AGPL-3.0-only
+
+#include "indexer/IndexingVisitor.hpp"
+
+#include "clang/AST/ASTContext.h"
+#include "clang/AST/RecursiveASTVisitor.h"
+
+#include "indexer/FileCache.hpp"
+#include "indexer/NamespaceCache.hpp"
+
+namespace {
+class IndexingVisitor : public clang::RecursiveASTVisitor<IndexingVisitor> {
+public:
+  IndexingVisitor(hdoc::indexer::matchers::IndexMatchers& matchers, const clang::SourceManager& sm)
+      : matchers(matchers), sm(sm), files(matchers.cfg), ignoredNamespaces(matchers.cfg->ignoreNamespaces) {}
+
+  bool TraverseDecl(clang::Decl* d) {
+    if (d == nullptr || this->shouldPrune(d)) {
+      return true;
+    }
+    return clang::RecursiveASTVisitor<IndexingVisitor>::TraverseDecl(d);
+  }
+
+  // Nothing hdoc documents is declared in a statement or a type, so neither function bodies and initializers
+  // nor the types of decls are walked
+  bool TraverseStmt(clang::Stmt*, DataRecursionQueue* = nullptr) {
+    return true;
+  }
+
+  bool TraverseType(clang::QualType) {
+    return true;
+  }
+
+  bool TraverseTypeLoc(clang::TypeLoc) {
+    return true;
+  }
+
+  bool VisitFunctionDecl(clang::FunctionDecl* d) {
+    if (d->isTemplateInstantiation() == false) {
+      this->matchers.functionFinder.indexDecl(d);
+    }
+    return true;
+  }
+
+  bool VisitCXXRecordDecl(clang::CXXRecordDecl* d) {
+    if (d->isThisDeclarationADefinition() &&
+        clang::isTemplateInstantiation(d->getTemplateSpecializationKind()) == false) {
+      this->matchers.recordFinder.indexDecl(d);
+    }
+    return true;
+  }
+
+  bool VisitEnumDecl(clang::EnumDecl* d) {
+    if (d->isThisDeclarationADefinition()) {
+      this->matchers.enumFinder.indexDecl(d);
+    }
+    return true;
+  }
+
+  bool VisitNamespaceDecl(clang::NamespaceDecl* d) {
+    // Namespaces aren't pruned by ownership, so that's checked here instead
+    if (this->isOwned(d)) {
+      this->matchers.namespaceFinder.indexDecl(d);
+    }
+    return true;
+  }
+
+  bool VisitUsingDecl(clang::UsingDecl* d) {
+    this->matchers.usingFinder.indexDecl(d);
+    return true;
+  }
+
+  bool VisitUsingShadowDecl(clang::UsingShadowDecl* d) {
+    this->matchers.usingFinder.indexDecl(d);
+    return true;
+  }
+
+  bool VisitTypedefNameDecl(clang::TypedefNameDecl* d) {
+    this->matchers.usingFinder.indexDecl(d);
+    return true;
+  }
+
+private:
+  bool isOwned(const clang::Decl* d) const {
+    return this->matchers.ownedFiles == nullptr || this->matchers.ownedFiles->isOwned(this->sm, d);
+  }
+
+  /// Check if nothing in d, including d itself, should be indexed.
+  bool shouldPrune(const clang::Decl* d) {
+    if (llvm::isa<clang::TranslationUnitDecl>(d)) {
+      return false;
+    }
+
+    // Everything in a system header is skipped, including the namespaces they open
+    const clang::SourceLocation beginLoc = d->getBeginLoc();
+    if (beginLoc.isValid() && this->sm.isInSystemHeader(this->sm.getExpansionLoc(beginLoc))) {
+      return true;
+    }
+
+    if (const auto* ns = llvm::dyn_cast<clang::NamespaceDecl>(d)) {
+      return ns->isAnonymousNamespace() || this->ignoredNamespaces.isInMatchingNamespace(ns);
+    }
+
+    // Like namespaces, linkage specifications and export blocks often wrap #includes, so what's in them can be
+    // in other files and is checked on its own
+    if (llvm::isa<clang::LinkageSpecDecl, clang::ExportDecl>(d)) {
+      return false;
+    }
+
+    if (this->isOwned(d) == false) {
+      return true;
+    }
+    const clang::SourceLocation fileLoc = this->sm.getFileLoc(d->getLocation());
+    return this->files.get(this->sm, this->sm.getFileID(fileLoc)).isIgnored;
+  }
+
+  hdoc::indexer::matchers::IndexMatchers& matchers;
+  const clang::SourceManager&             sm;
+  hdoc::indexer::FileCache                files;             ///< Paths and ignore verdicts of the files of the TU
+  hdoc::indexer::NamespaceCache           ignoredNamespaces; ///< Namespaces of the TU in cfg->ignoreNamespaces
+};
+
+class IndexingConsumer : public clang::ASTConsumer {
+public:
+  IndexingConsumer(hdoc::indexer::matchers::IndexMatchers& matchers) : matchers(matchers) {}
+
+  void HandleTranslationUnit(clang::ASTContext& context) override {
+    // The matchers cache what they know about the files and namespaces of a TU, just like with a MatchFinder
+    this->matchers.onStartOfTranslationUnit();
+
+    IndexingVisitor visitor(this->matchers, context.getSourceManager());
+    visitor.TraverseDecl(context.getTranslationUnitDecl());
+  }
+
+private:
+  hdoc::indexer::matchers::IndexMatchers& matchers;
+};
+} // namespace
+
+std::unique_ptr<clang::ASTConsumer>
+hdoc::indexer::newIndexingConsumer(hdoc::indexer::matchers::IndexMatchers& matchers) {
+  return std::make_unique<IndexingConsumer>(matchers);
+}
@@ -0,0 +1,22 @@
+// Copyright 2019-2023 hdoc
+// SPDX-License-Identifier: AGPL-3.0-only
+
+#pragma once
+
+#include "clang/AST/ASTConsumer.h"
+
+#include "indexer/Matchers.hpp"
+
+#include <memory>
+
+namespace hdoc::indexer {
+/// @brief Create an ASTConsumer that indexes a TU by walking its AST and giving each decl to the matching
+/// indexDecl() of matchers, as an alternative to running matchers.finder over the TU.
+///
+/// MatchFinder visits every node of the AST and then rejects most of them one by one, walking up the parent map
+/// to look for anonymous namespaces along the way. The visitor instead skips whole subtrees that can't contain
+/// anything worth documenting: system headers, anonymous and ignored namespaces, decls in ignored files or in
+/// files owned by another TU, and all statements, including function bodies. Local classes and enums declared
+/// in function bodies aren't indexed as a result.
+std::unique_ptr<clang::ASTConsumer> newIndexingConsumer(hdoc::indexer::matchers::IndexMatchers& matchers);
+} // namespace hdoc::indexer
@@ -6,37 +6,13 @@
 #include <spdlog/spdlog.h>
 #include <spdlog/fmt/fmt.h>
 
+#include "IndexingVisitor.hpp"
 #include "Matchers.hpp"
 #include "MatcherUtils.hpp"
 #include "types/Symbols.hpp"
 #include "clang/AST/Comment.h"
 #include "clang/Lex/Lexer.h"
 
-bool hdoc::indexer::matchers::utils::isEnclosingNamespaceInList(const clang::Decl* decl, const std::vector<std::string>& list) {
-  auto* parent = decl->getDeclContext();
-  // The namespace itself counts as its own parent
-  // This makes e.g. detail namespaces themselves also be considered detail
-  if (auto* namespaceDecl = llvm::dyn_cast<clang::NamespaceDecl>(decl)) {
-    parent = namespaceDecl;
-  }
-  while (parent) {
-    if (auto* namespaceDecl = llvm::dyn_cast<clang::NamespaceDecl>(parent)) {
-      if (namespaceDecl->isAnonymousNamespace()) {
-        parent = parent->getParent();
-        continue;
-      }
-      auto name = namespaceDecl->getNameAsString();
-      for (const auto& substr : list) {
-        if (name.find(substr) != std::string::npos) {
-          return true;
-        }
-      }
-    }
-    parent = parent->getParent();
-  }
-  return false;
-}
-
 /// @brief Try to get a SymbolID from a QualType, and return an empty SymbolID if it's not possible
 static hdoc::types::SymbolID getTypeSymbolID(const clang::QualType& typ) {
   // Get a TagDecl from the QualType, stripping pointers and references if needed.
@@ -77,6 +53,7 @@ static std::vector<hdoc::types::TemplateParam> collectTemplateParams(const clang
   if (describedTemplateParms) {
     for (const auto* paramDecl : describedTemplateParms->asArray()) {
       hdoc::types::TemplateParam tparam;
+      tparam.depth = describedTemplateParms->getDepth();
       if (const auto& templateType = llvm::dyn_cast<clang::TemplateTypeParmDecl>(paramDecl)) {
         tparam.templateType    = hdoc::types::TemplateParam::TemplateType::TemplateTypeParameter;
         tparam.isTypename      = templateType->wasDeclaredWithTypename();
@@ -98,25 +75,31 @@ static std::vector<hdoc::types::TemplateParam> collectTemplateParams(const clang
         tparam.type =
             clang::Lexer::getSourceText(clang::CharSourceRange::getCharRange(templateTemplateType->getSourceRange()),
                                         res->getASTContext().getSourceManager(),
-                                        res->getASTContext().getLangOpts());
+                                        res->getASTContext().getLangOpts())
+                .str();
         tparam.name            = templateTemplateType->getNameAsString();
         tparam.isParameterPack = templateTemplateType->isParameterPack() ? "..." : ""; // What? TODO: investigate
       }
-      templateParams.emplace_back(tparam);
+      templateParams.emplace_back(std::move(tparam));
     }
   }
   return templateParams;
 }
 
 static bool isHiddenFriendFunction(const clang::Decl* res) {
-  // Note that unlike other friend declarations, hidden friends have a body attached (see last condition) 
+  // Note that unlike other friend declarations, hidden friends are defined in place (see last condition).
+  // Function bodies may have been skipped while parsing, so check for a definition rather than a body.
   return res != nullptr && (llvm::isa<clang::FunctionDecl>(res) || llvm::isa<clang::FunctionTemplateDecl>(res)) &&
          res->isCanonicalDecl() && res->getLexicalDeclContext()->getDeclKind() == clang::Decl::Kind::CXXRecord &&
-         res->getDeclContext()->getDeclKind() == clang::Decl::Kind::Namespace && res->getBody() != nullptr;
+         res->getDeclContext()->getDeclKind() == clang::Decl::Kind::Namespace &&
+         res->getAsFunction()->isThisDeclarationADefinition();
 }
 
 void hdoc::indexer::matchers::FunctionMatcher::run(const clang::ast_matchers::MatchFinder::MatchResult& Result) {
-  const auto res = Result.Nodes.getNodeAs<clang::FunctionDecl>("function");
+  this->indexDecl(Result.Nodes.getNodeAs<clang::FunctionDecl>("function"));
+}
+
+void hdoc::indexer::matchers::FunctionMatcher::indexDecl(const clang::FunctionDecl* res) {
 
   // Ignore deduction guides, at least for now
   // (generally, these usually are designed to make things work as one would expect, so
@@ -130,20 +113,19 @@ void hdoc::indexer::matchers::FunctionMatcher::run(const clang::ast_matchers::Ma
 
   // Ignore invalid matches, matches in ignored files, and static functions
   if (res == nullptr ||
-      isInIgnoreList(res, this->cfg) || !res->getSourceRange().isValid() ||
+      isInIgnoreList(res, this->files, this->ignoredNamespaces) || !res->getSourceRange().isValid() ||
       (res->isStatic() && !res->isCXXClassMember()) || isInAnonymousNamespace(res) ||
       (res->getAccess() == clang::AS_private && cfg->ignorePrivateMembers == true)) {
     return;
   }
 
   const hdoc::types::SymbolID ID = buildID(res);
-  if (this->index->functions.contains(ID)) {
+  if (this->index->functions.claim(ID) == false) {
     return;
   }
-  this->index->functions.reserve(ID);
   hdoc::types::FunctionSymbol f;
   f.ID = ID;
-  fillOutSymbol(f, res, this->cfg->rootDir);
+  fillOutSymbol(f, res, this->files);
 
   // Determine if the function is a conversion operator early, since it influences proto generation
   if (const auto* conversion = llvm::dyn_cast<clang::CXXConversionDecl>(res)) {
@@ -194,12 +176,14 @@ void hdoc::indexer::matchers::FunctionMatcher::run(const clang::ast_matchers::Ma
       a.defaultValue = i->hasUninstantiatedDefaultArg() ? exprToString(i->getUninstantiatedDefaultArg(), pp)
                                                         : exprToString(i->getDefaultArg(), pp);
     }
-    f.params.emplace_back(a);
+    f.params.emplace_back(std::move(a));
   }
 
   if (clang::FunctionTemplateDecl* templateDecl = res->getDescribedFunctionTemplate()) {
+    f.templateParams.reserve(templateDecl->getTemplateParameters()->size());
     for (const auto* parameterDecl : *templateDecl->getTemplateParameters()) {
       hdoc::types::TemplateParam tparam;
+      tparam.depth = templateDecl->getTemplateParameters()->getDepth();
       if (const auto* templateType = llvm::dyn_cast<clang::TemplateTypeParmDecl>(parameterDecl)) {
         tparam.templateType    = hdoc::types::TemplateParam::TemplateType::TemplateTypeParameter;
         tparam.isParameterPack = templateType->isParameterPack();
@@ -215,7 +199,7 @@ void hdoc::indexer::matchers::FunctionMatcher::run(const clang::ast_matchers::Ma
             nonTypeTemplate->hasDefaultArgument() ? exprToString(nonTypeTemplate->getDefaultArgument(), pp) : "";
         tparam.type = nonTypeTemplate->getType().getAsString(pp);
       }
-      f.templateParams.emplace_back(tparam);
+      f.templateParams.emplace_back(std::move(tparam));
     }
   }
 
@@ -231,19 +215,23 @@ void hdoc::indexer::matchers::FunctionMatcher::run(const clang::ast_matchers::Ma
     f.returnType.id   = getTypeSymbolID(res->getReturnType());
   } else {
     // simplify name of the constructors to remove template arguments in case it is a specialization
-    f.name = std::regex_replace(f.name, std::regex("<.*>"), "");
+    static const std::regex templateArgs("<.*>");
+    f.name = std::regex_replace(f.name, templateArgs, "");
   }
   f.isRecordMember = res->isCXXClassMember();
   f.isHiddenFriend = isHiddenFriendFunction(res);
 
   f.proto          = getFunctionSignature(f);
 
-  fillNamespace(f, res, this->cfg);
-  this->index->functions.update(f.ID, f);
+  fillNamespace(f, res, this->detailNamespaces);
+  this->index->functions.update(f.ID, std::move(f));
 }
 
 void hdoc::indexer::matchers::UsingMatcher::run(const clang::ast_matchers::MatchFinder::MatchResult& Result) {
-  const auto res = Result.Nodes.getNodeAs<clang::NamedDecl>("using");
+  this->indexDecl(Result.Nodes.getNodeAs<clang::NamedDecl>("using"));
+}
+
+void hdoc::indexer::matchers::UsingMatcher::indexDecl(const clang::NamedDecl* res) {
 
   // Only interested in aliases
   if(!llvm::isa_and_present<clang::UsingDecl>(res) && !llvm::isa_and_present<clang::UsingShadowDecl>(res)
@@ -259,27 +247,26 @@ void hdoc::indexer::matchers::UsingMatcher::run(const clang::ast_matchers::Match
   // Count the number of aliases matched
   this->index->aliases.numMatches++;
 
-  if(isInIgnoreList(res, this->cfg)) spdlog::warn("Ignoring Using [ignore list] : {}", res->getQualifiedNameAsString());
+  if(isInIgnoreList(res, this->files, this->ignoredNamespaces)) spdlog::warn("Ignoring Using [ignore list] : {}", res->getQualifiedNameAsString());
   if(!res->getSourceRange().isValid()) spdlog::warn("Ignoring Using [invalid source range] : {}", res->getQualifiedNameAsString());
 
   // Ignore invalid matches and matches in ignored files
   if (res == nullptr ||
-      isInIgnoreList(res, this->cfg) || !res->getSourceRange().isValid() ||
+      isInIgnoreList(res, this->files, this->ignoredNamespaces) || !res->getSourceRange().isValid() ||
       (res->getAccess() == clang::AS_private && cfg->ignorePrivateMembers == true)) {
     return;
   }
 
   const hdoc::types::SymbolID ID = buildID(res);
-  if (this->index->aliases.contains(ID)) {
+  if (this->index->aliases.claim(ID) == false) {
     return;
   }
-  this->index->aliases.reserve(ID);
 
   clang::PrintingPolicy pp(res->getASTContext().getLangOpts());
 
   hdoc::types::AliasSymbol a;
   a.ID = ID;
-  fillOutSymbol(a, res, this->cfg->rootDir);
+  fillOutSymbol(a, res, this->files);
 
   a.isRecordMember = res->isCXXClassMember();
   if(a.isRecordMember) a.access = res->getAccess();
@@ -315,8 +302,8 @@ void hdoc::indexer::matchers::UsingMatcher::run(const clang::ast_matchers::Match
     processSymbolComment(a, comment, res->getASTContext());
   }
 
-  fillNamespace(a, res, this->cfg);
-  this->index->aliases.update(a.ID, a);
+  fillNamespace(a, res, this->detailNamespaces);
+  this->index->aliases.update(a.ID, std::move(a));
 }
 
 std::vector<std::string> templateArgsToStrings(const clang::TemplateArgumentList& args, const clang::ASTContext& ctx, const hdoc::types::RecordSymbol& record) {
@@ -357,26 +344,29 @@ std::vector<std::string> templateArgsToStrings(const clang::TemplateArgumentList
           fallbackName = 'A';
         }
       }
-      ret.emplace_back(replacement);
+      ret.emplace_back(std::move(replacement));
     } else {
       // We also potentially have template arguments for a template template type, which we just remove for readability
-      std::regex re("<.*>");
-      result = std::regex_replace(result, re, "<...>");
-      ret.emplace_back(result);
+      static const std::regex templateArgs("<.*>");
+      result = std::regex_replace(result, templateArgs, "<...>");
+      ret.emplace_back(std::move(result));
     }
   }
   return ret;
 }
 
 void hdoc::indexer::matchers::RecordMatcher::run(const clang::ast_matchers::MatchFinder::MatchResult& Result) {
-  const auto res = Result.Nodes.getNodeAs<clang::CXXRecordDecl>("record");
+  this->indexDecl(Result.Nodes.getNodeAs<clang::CXXRecordDecl>("record"));
+}
+
+void hdoc::indexer::matchers::RecordMatcher::indexDecl(const clang::CXXRecordDecl* res) {
 
   // Count the number of records matched
   this->index->records.numMatches++;
 
   // Ignore invalid matches
   if (res == nullptr || !res->isCompleteDefinition() || !res->getSourceRange().isValid() ||
-      isInIgnoreList(res, this->cfg) || isInAnonymousNamespace(res)) {
+      isInIgnoreList(res, this->files, this->ignoredNamespaces) || isInAnonymousNamespace(res)) {
     return;
   }
 
@@ -407,13 +397,12 @@ void hdoc::indexer::matchers::RecordMatcher::run(const clang::ast_matchers::Matc
   }
 
   const hdoc::types::SymbolID ID = buildID(res);
-  if (this->index->records.contains(ID)) {
+  if (this->index->records.claim(ID) == false) {
     return;
   }
-  this->index->records.reserve(ID);
   hdoc::types::RecordSymbol c;
   c.ID = ID;
-  fillOutSymbol(c, res, this->cfg->rootDir);
+  fillOutSymbol(c, res, this->files);
 
   // Apply the cached name found earlier for suspected typedef'ed decls
   if (c.name == "") {
@@ -427,7 +416,7 @@ void hdoc::indexer::matchers::RecordMatcher::run(const clang::ast_matchers::Matc
   // Get methods and decls (what's the difference?) for this record
   for (const auto* m : res->methods()) {
     if (m == nullptr || m->isImplicit() ||
-        isInIgnoreList(m, this->cfg) || isInAnonymousNamespace(m) ||
+        isInIgnoreList(m, this->files, this->ignoredNamespaces) || isInAnonymousNamespace(m) ||
         (m->getAccess() == clang::AS_private && cfg->ignorePrivateMembers == true)) {
       continue;
     }
@@ -436,7 +425,7 @@ void hdoc::indexer::matchers::RecordMatcher::run(const clang::ast_matchers::Matc
   for (const auto* d : res->decls()) {
     if (const auto* ftd = llvm::dyn_cast<clang::FunctionTemplateDecl>(d)) {
       if (ftd == nullptr || ftd->isImplicit() ||
-          isInIgnoreList(ftd, this->cfg) || isInAnonymousNamespace(ftd) ||
+          isInIgnoreList(ftd, this->files, this->ignoredNamespaces) || isInAnonymousNamespace(ftd) ||
           (ftd->getAccess() == clang::AS_private && cfg->ignorePrivateMembers == true)) {
         continue;
       }
@@ -453,7 +442,7 @@ void hdoc::indexer::matchers::RecordMatcher::run(const clang::ast_matchers::Matc
       if (!alias) alias = llvm::dyn_cast<clang::UsingDecl>(d);
       if (!alias) alias = llvm::dyn_cast<clang::TypedefNameDecl>(d);
       if (alias == nullptr || alias->isImplicit() ||
-          isInIgnoreList(alias, this->cfg) || isInAnonymousNamespace(alias) ||
+          isInIgnoreList(alias, this->files, this->ignoredNamespaces) || isInAnonymousNamespace(alias) ||
           (alias->getAccess() == clang::AS_private && cfg->ignorePrivateMembers == true)) {
         continue;
       }
@@ -537,7 +526,7 @@ void hdoc::indexer::matchers::RecordMatcher::run(const clang::ast_matchers::Matc
       }
     }
 
-    c.vars.emplace_back(mv);
+    c.vars.emplace_back(std::move(mv));
   }
 
   // Get static members that aren't caught by res->fields()
@@ -570,7 +559,7 @@ void hdoc::indexer::matchers::RecordMatcher::run(const clang::ast_matchers::Matc
         }
       }
 
-      c.vars.emplace_back(mv);
+      c.vars.emplace_back(std::move(mv));
     }
   }
 
@@ -579,30 +568,32 @@ void hdoc::indexer::matchers::RecordMatcher::run(const clang::ast_matchers::Matc
     processSymbolComment(c, comment, res->getASTContext());
   }
 
-  fillNamespace(c, res, this->cfg);
-  this->index->records.update(c.ID, c);
+  fillNamespace(c, res, this->detailNamespaces);
+  this->index->records.update(c.ID, std::move(c));
 }
 
 void hdoc::indexer::matchers::EnumMatcher::run(const clang::ast_matchers::MatchFinder::MatchResult& Result) {
-  const auto res = Result.Nodes.getNodeAs<clang::EnumDecl>("enum");
+  this->indexDecl(Result.Nodes.getNodeAs<clang::EnumDecl>("enum"));
+}
+
+void hdoc::indexer::matchers::EnumMatcher::indexDecl(const clang::EnumDecl* res) {
 
   // Count the number of classes matched
   this->index->enums.numMatches++;
 
   // Ignore invalid matches and anonymous enums
   if (res == nullptr || res->getNameAsString() == "" ||
-      isInIgnoreList(res, this->cfg) || isInAnonymousNamespace(res)) {
+      isInIgnoreList(res, this->files, this->ignoredNamespaces) || isInAnonymousNamespace(res)) {
     return;
   }
 
   const hdoc::types::SymbolID ID = buildID(res);
-  if (this->index->enums.contains(ID)) {
+  if (this->index->enums.claim(ID) == false) {
     return;
   }
-  this->index->enums.reserve(ID);
   hdoc::types::EnumSymbol e;
   e.ID = ID;
-  fillOutSymbol(e, res, this->cfg->rootDir);
+  fillOutSymbol(e, res, this->files);
 
   if (const auto* parent = llvm::dyn_cast<clang::CXXRecordDecl>(res->getParent())) {
     e.name = parent->getNameAsString() + "::" + e.name;
@@ -633,7 +624,7 @@ void hdoc::indexer::matchers::EnumMatcher::run(const clang::ast_matchers::MatchF
         }
       }
     }
-    e.members.emplace_back(em);
+    e.members.emplace_back(std::move(em));
   }
 
   const clang::comments::Comment* comment = res->getASTContext().getCommentForDecl(res, nullptr);
@@ -641,31 +632,40 @@ void hdoc::indexer::matchers::EnumMatcher::run(const clang::ast_matchers::MatchF
     processSymbolComment(e, comment, res->getASTContext());
   }
 
-  fillNamespace(e, res, this->cfg);
-  this->index->enums.update(e.ID, e);
+  fillNamespace(e, res, this->detailNamespaces);
+  this->index->enums.update(e.ID, std::move(e));
 }
 
 void hdoc::indexer::matchers::NamespaceMatcher::run(const clang::ast_matchers::MatchFinder::MatchResult& Result) {
-  const auto res = Result.Nodes.getNodeAs<clang::NamespaceDecl>("namespace");
+  this->indexDecl(Result.Nodes.getNodeAs<clang::NamespaceDecl>("namespace"));
+}
+
+void hdoc::indexer::matchers::NamespaceMatcher::indexDecl(const clang::NamespaceDecl* res) {
 
   // Count the number of namespaces matched
   this->index->namespaces.numMatches++;
 
   // Ignore invalid matches and anonymous enums
   if (res == nullptr || res->getNameAsString() == "" ||
-      isInIgnoreList(res, this->cfg) || isInAnonymousNamespace(res)) {
+      isInIgnoreList(res, this->files, this->ignoredNamespaces) || isInAnonymousNamespace(res)) {
     return;
   }
 
   const hdoc::types::SymbolID ID = buildID(res);
-  if (this->index->namespaces.contains(ID)) {
+  if (this->index->namespaces.claim(ID) == false) {
     return;
   }
-  this->index->namespaces.reserve(ID);
   hdoc::types::NamespaceSymbol n;
   n.ID = ID;
-  fillOutSymbol(n, res, this->cfg->rootDir);
+  fillOutSymbol(n, res, this->files);
 
-  fillNamespace(n, res, this->cfg);
-  this->index->namespaces.update(n.ID, n);
+  fillNamespace(n, res, this->detailNamespaces);
+  this->index->namespaces.update(n.ID, std::move(n));
+}
+
+std::unique_ptr<clang::ASTConsumer> hdoc::indexer::matchers::IndexMatchers::newASTConsumer() {
+  if (this->cfg->pruneAST == true) {
+    return hdoc::indexer::newIndexingConsumer(*this);
+  }
+  return this->finder.newASTConsumer();
 }
@@ -7,145 +7,212 @@
 #include "clang/ASTMatchers/ASTMatchers.h"
 #include "clang/ASTMatchers/ASTMatchersMacros.h"
 
+#include "indexer/FileCache.hpp"
+#include "indexer/HeaderRegistry.hpp"
+#include "indexer/NamespaceCache.hpp"
 #include "types/Config.hpp"
 #include "types/Index.hpp"
 
 #include <filesystem>
+#include <initializer_list>
+#include <memory>
 
 namespace hdoc::indexer::matchers {
 
-  namespace utils {
-    bool isEnclosingNamespaceInList(const clang::Decl* decl, const std::vector<std::string>& list);
-  }
-
-AST_MATCHER_P(clang::Decl, shouldBeIgnored, const hdoc::types::Config*, cfg) {
+/// Matches decls in files in cfg->ignorePaths, or in namespaces in cfg->ignoreNamespaces.
+AST_MATCHER_P2(clang::Decl,
+               shouldBeIgnored,
+               hdoc::indexer::FileCache*,
+               files,
+               hdoc::indexer::NamespaceCache*,
+               ignoredNamespaces) {
   (void)Builder; // Avoid unused variable warning
 
   // handle file path based ignore
-  const auto& ignoreList = cfg->ignorePaths;
-  const auto& rootDir = cfg->rootDir;
-  if (ignoreList.size() == 0) {
-    return false;
-  }
-
   auto& sourceManager = Finder->getASTContext().getSourceManager();
   auto  expansionLoc  = sourceManager.getExpansionLoc(Node.getBeginLoc());
-  if (expansionLoc.isInvalid()) {
-    return false;
+  if (expansionLoc.isValid() && files->get(sourceManager, sourceManager.getFileID(expansionLoc)).isInIgnoreList) {
+    return true;
   }
 
-  auto fileEntry = sourceManager.getFileEntryForID(sourceManager.getFileID(expansionLoc));
-  if (!fileEntry) {
+  return ignoredNamespaces->isInMatchingNamespace(&Node);
+}
+
+/// Matches decls in files that another TU is responsible for indexing.
+/// This is checked before any of the other, more expensive, matchers and ignore checks.
+AST_MATCHER_P(clang::Decl, isInFileOwnedByOtherTU, const hdoc::indexer::OwnedFiles*, ownedFiles) {
+  (void)Builder; // Avoid unused variable warning
+  if (ownedFiles == nullptr) {
     return false;
   }
+  return ownedFiles->isOwned(Finder->getASTContext().getSourceManager(), &Node) == false;
+}
 
-  auto filename = std::filesystem::relative(std::filesystem::path(fileEntry->getName().str()), rootDir).string();
-  for (const auto& substr : ignoreList) {
-    if (filename.find(substr) != std::string::npos) {
-      return true;
-    }
+/// @brief State shared by all of hdoc's matchers: where matches are indexed to, and what they've learned about the
+/// files and namespaces of the current TU.
+class MatcherBase : public clang::ast_matchers::MatchFinder::MatchCallback {
+public:
+  MatcherBase(hdoc::types::Index*              index,
+              const hdoc::types::Config*       cfg,
+              const hdoc::indexer::OwnedFiles* ownedFiles = nullptr)
+      : index(index), cfg(cfg), ownedFiles(ownedFiles), files(cfg), ignoredNamespaces(cfg->ignoreNamespaces),
+        detailNamespaces(cfg->detailNamespaces) {}
+
+  hdoc::types::Index*              index;
+  const hdoc::types::Config*       cfg;
+  const hdoc::indexer::OwnedFiles* ownedFiles;        ///< Files this TU indexes, or nullptr to index all files
+  hdoc::indexer::FileCache         files;             ///< Paths and ignore verdicts of the files of the current TU
+  hdoc::indexer::NamespaceCache    ignoredNamespaces; ///< Namespaces of the current TU in cfg->ignoreNamespaces
+  hdoc::indexer::NamespaceCache    detailNamespaces;  ///< Namespaces of the current TU in cfg->detailNamespaces
+
+  /// The caches only hold entries of the current TU, so they're cleared when a new one starts
+  void onStartOfTranslationUnit() override {
+    this->files.clear();
+    this->ignoredNamespaces.clear();
+    this->detailNamespaces.clear();
   }
+};
 
-  return utils::isEnclosingNamespaceInList(&Node, cfg->ignoreNamespaces);
-}
-
-class RecordMatcher : public clang::ast_matchers::MatchFinder::MatchCallback {
+class RecordMatcher : public MatcherBase {
 public:
   virtual void run(const clang::ast_matchers::MatchFinder::MatchResult& Result);
-  RecordMatcher(hdoc::types::Index* index, const hdoc::types::Config* cfg) : index(index), cfg(cfg) {}
-  hdoc::types::Index*        index;
-  const hdoc::types::Config* cfg;
+  /// Index res, which may be nullptr. Called by run(), and directly by IndexingVisitor.
+  void indexDecl(const clang::CXXRecordDecl* res);
+  using MatcherBase::MatcherBase;
 
   clang::ast_matchers::DeclarationMatcher getMatcher() {
     return clang::ast_matchers::cxxRecordDecl(
                clang::ast_matchers::isDefinition(),
                clang::ast_matchers::unless(clang::ast_matchers::anyOf(
+                   hdoc::indexer::matchers::isInFileOwnedByOtherTU(this->ownedFiles),
                    clang::ast_matchers::hasAncestor(
                        clang::ast_matchers::namespaceDecl(clang::ast_matchers::isAnonymous())),
                    clang::ast_matchers::isImplicit(),
                    clang::ast_matchers::isExpansionInSystemHeader(),
                    clang::ast_matchers::isTemplateInstantiation(),
                    clang::ast_matchers::isInstantiated(),
-                   hdoc::indexer::matchers::shouldBeIgnored(this->cfg))))
+                   hdoc::indexer::matchers::shouldBeIgnored(&this->files, &this->ignoredNamespaces))))
         .bind("record");
   }
 };
 
-class FunctionMatcher : public clang::ast_matchers::MatchFinder::MatchCallback {
+class FunctionMatcher : public MatcherBase {
 public:
   virtual void run(const clang::ast_matchers::MatchFinder::MatchResult& Result);
-  FunctionMatcher(hdoc::types::Index* index, const hdoc::types::Config* cfg) : index(index), cfg(cfg) {}
-  hdoc::types::Index*        index;
-  const hdoc::types::Config* cfg;
+  /// Index res, which may be nullptr. Called by run(), and directly by IndexingVisitor.
+  void indexDecl(const clang::FunctionDecl* res);
+  using MatcherBase::MatcherBase;
 
   clang::ast_matchers::DeclarationMatcher getMatcher() {
     return clang::ast_matchers::functionDecl(
                clang::ast_matchers::unless(clang::ast_matchers::anyOf(
+                   hdoc::indexer::matchers::isInFileOwnedByOtherTU(this->ownedFiles),
                    clang::ast_matchers::hasAncestor(
                        clang::ast_matchers::namespaceDecl(clang::ast_matchers::isAnonymous())),
                    clang::ast_matchers::isImplicit(),
                    clang::ast_matchers::isExpansionInSystemHeader(),
                    clang::ast_matchers::isTemplateInstantiation(),
                    clang::ast_matchers::isInstantiated(),
-                   hdoc::indexer::matchers::shouldBeIgnored(this->cfg))))
+                   hdoc::indexer::matchers::shouldBeIgnored(&this->files, &this->ignoredNamespaces))))
         .bind("function");
   }
 };
 
-class UsingMatcher : public clang::ast_matchers::MatchFinder::MatchCallback {
+class UsingMatcher : public MatcherBase {
 public:
   virtual void run(const clang::ast_matchers::MatchFinder::MatchResult& Result);
-  UsingMatcher(hdoc::types::Index* index, const hdoc::types::Config* cfg) : index(index), cfg(cfg) {}
-  hdoc::types::Index*        index;
-  const hdoc::types::Config* cfg;
+  /// Index res, which may be nullptr. Called by run(), and directly by IndexingVisitor.
+  void indexDecl(const clang::NamedDecl* res);
+  using MatcherBase::MatcherBase;
 
   clang::ast_matchers::DeclarationMatcher getMatcher() {
     return clang::ast_matchers::namedDecl(
                clang::ast_matchers::unless(clang::ast_matchers::anyOf(
+                   hdoc::indexer::matchers::isInFileOwnedByOtherTU(this->ownedFiles),
                    clang::ast_matchers::hasAncestor(
                        clang::ast_matchers::namespaceDecl(clang::ast_matchers::isAnonymous())),
                    clang::ast_matchers::isImplicit(),
                    clang::ast_matchers::isExpansionInSystemHeader(),
                    clang::ast_matchers::isInstantiated(),
-                   hdoc::indexer::matchers::shouldBeIgnored(this->cfg))))
+                   hdoc::indexer::matchers::shouldBeIgnored(&this->files, &this->ignoredNamespaces))))
         .bind("using");
   }
 };
 
-class EnumMatcher : public clang::ast_matchers::MatchFinder::MatchCallback {
+class EnumMatcher : public MatcherBase {
 public:
   virtual void run(const clang::ast_matchers::MatchFinder::MatchResult& Result);
-  EnumMatcher(hdoc::types::Index* index, const hdoc::types::Config* cfg) : index(index), cfg(cfg) {}
-  hdoc::types::Index*                     index;
-  const hdoc::types::Config*              cfg;
+  /// Index res, which may be nullptr. Called by run(), and directly by IndexingVisitor.
+  void indexDecl(const clang::EnumDecl* res);
+  using MatcherBase::MatcherBase;
+
   clang::ast_matchers::DeclarationMatcher getMatcher() {
     return clang::ast_matchers::enumDecl(
                clang::ast_matchers::isDefinition(),
                clang::ast_matchers::unless(clang::ast_matchers::anyOf(
+                   hdoc::indexer::matchers::isInFileOwnedByOtherTU(this->ownedFiles),
                    clang::ast_matchers::hasAncestor(
                        clang::ast_matchers::namespaceDecl(clang::ast_matchers::isAnonymous())),
                    clang::ast_matchers::isExpansionInSystemHeader(),
                    clang::ast_matchers::isImplicit(),
-                   hdoc::indexer::matchers::shouldBeIgnored(this->cfg))))
+                   hdoc::indexer::matchers::shouldBeIgnored(&this->files, &this->ignoredNamespaces))))
         .bind("enum");
   }
 };
 
-class NamespaceMatcher : public clang::ast_matchers::MatchFinder::MatchCallback {
+class NamespaceMatcher : public MatcherBase {
 public:
   virtual void run(const clang::ast_matchers::MatchFinder::MatchResult& Result);
-  NamespaceMatcher(hdoc::types::Index* index, const hdoc::types::Config* cfg) : index(index), cfg(cfg) {}
-  hdoc::types::Index*                     index;
-  const hdoc::types::Config*              cfg;
+  /// Index res, which may be nullptr. Called by run(), and directly by IndexingVisitor.
+  void indexDecl(const clang::NamespaceDecl* res);
+  using MatcherBase::MatcherBase;
+
   clang::ast_matchers::DeclarationMatcher getMatcher() {
     return clang::ast_matchers::namespaceDecl(
                clang::ast_matchers::unless(clang::ast_matchers::anyOf(
+                   hdoc::indexer::matchers::isInFileOwnedByOtherTU(this->ownedFiles),
                    clang::ast_matchers::hasAncestor(
                        clang::ast_matchers::namespaceDecl(clang::ast_matchers::isAnonymous())),
                    clang::ast_matchers::isExpansionInSystemHeader(),
                    clang::ast_matchers::isImplicit(),
-                   hdoc::indexer::matchers::shouldBeIgnored(this->cfg))))
+                   hdoc::indexer::matchers::shouldBeIgnored(&this->files, &this->ignoredNamespaces))))
         .bind("namespace");
   }
 };
+
+/// All of hdoc's matchers, which index the decls they're given into one Index.
+struct IndexMatchers {
+  IndexMatchers(hdoc::types::Index* index, const hdoc::types::Config* cfg, const hdoc::indexer::OwnedFiles* ownedFiles)
+      : cfg(cfg), ownedFiles(ownedFiles), functionFinder(index, cfg, ownedFiles), recordFinder(index, cfg, ownedFiles),
+        enumFinder(index, cfg, ownedFiles), namespaceFinder(index, cfg, ownedFiles),
+        usingFinder(index, cfg, ownedFiles) {
+    this->finder.addMatcher(this->functionFinder.getMatcher(), &this->functionFinder);
+    this->finder.addMatcher(this->recordFinder.getMatcher(), &this->recordFinder);
+    this->finder.addMatcher(this->enumFinder.getMatcher(), &this->enumFinder);
+    this->finder.addMatcher(this->namespaceFinder.getMatcher(), &this->namespaceFinder);
+    this->finder.addMatcher(this->usingFinder.getMatcher(), &this->usingFinder);
+  }
+
+  /// @brief Clear what all matchers cached about the previous TU.
+  void onStartOfTranslationUnit() {
+    const std::initializer_list<MatcherBase*> all = {
+        &this->functionFinder, &this->recordFinder, &this->enumFinder, &this->namespaceFinder, &this->usingFinder};
+    for (MatcherBase* m : all) {
+      m->onStartOfTranslationUnit();
+    }
+  }
+
+  /// @brief Create an ASTConsumer that indexes a TU. It matches every decl of the TU with finder, or walks
+  /// the AST with an IndexingVisitor that skips ignored subtrees if cfg->pruneAST is true.
+  std::unique_ptr<clang::ASTConsumer> newASTConsumer();
+
+  const hdoc::types::Config*       cfg;
+  const hdoc::indexer::OwnedFiles* ownedFiles; ///< Files this TU indexes, or nullptr to index all files
+  FunctionMatcher                  functionFinder;
+  RecordMatcher                    recordFinder;
+  EnumMatcher                      enumFinder;
+  NamespaceMatcher                 namespaceFinder;
+  UsingMatcher                     usingFinder;
+  clang::ast_matchers::MatchFinder finder;
+};
 } // namespace hdoc::indexer::matchers
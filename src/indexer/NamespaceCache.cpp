@@ -0,0 +1,46 @@
+// Copyright 2019-2023 hdoc
+// SPDX-License-Identifier: AGPL-3.0-only
+
+#include "indexer/NamespaceCache.hpp"
+
+/// Get the innermost namespace that is or encloses dc, or nullptr if there is none.
+static const clang::NamespaceDecl* getEnclosingNamespace(const clang::DeclContext* dc) {
+  while (dc != nullptr) {
+    if (const auto* ns = llvm::dyn_cast<clang::NamespaceDecl>(dc)) {
+      return ns;
+    }
+    dc = dc->getParent();
+  }
+  return nullptr;
+}
+
+bool hdoc::indexer::NamespaceCache::isInMatchingNamespace(const clang::Decl* decl) {
+  if (this->substrings.empty()) {
+    return false;
+  }
+
+  // The namespace itself counts as its own parent
+  // This makes e.g. detail namespaces themselves also be considered detail
+  const clang::DeclContext* parent = decl->getDeclContext();
+  if (const auto* namespaceDecl = llvm::dyn_cast<clang::NamespaceDecl>(decl)) {
+    parent = namespaceDecl;
+  }
+  const clang::NamespaceDecl* ns = getEnclosingNamespace(parent);
+  return ns != nullptr && this->isMatchingNamespace(ns);
+}
+
+bool hdoc::indexer::NamespaceCache::isMatchingNamespace(const clang::NamespaceDecl* ns) {
+  if (const auto it = this->verdicts.find(ns); it != this->verdicts.end()) {
+    return it->second;
+  }
+
+  // Namespace names are plain identifiers, so getName() doesn't need to allocate like getNameAsString() does
+  bool verdict = ns->isAnonymousNamespace() == false && this->substrings.isMatch(ns->getName());
+  if (verdict == false) {
+    if (const clang::NamespaceDecl* enclosing = getEnclosingNamespace(ns->getParent())) {
+      verdict = this->isMatchingNamespace(enclosing);
+    }
+  }
+  this->verdicts.try_emplace(ns, verdict);
+  return verdict;
+}
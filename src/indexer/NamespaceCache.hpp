@@ -0,0 +1,42 @@
+// Copyright 2019-2023 hdoc
+// SPDX-License-Identifier: AGPL-3.0-only
+
+#pragma once
+
+#include "clang/AST/Decl.h"
+#include "llvm/ADT/DenseMap.h"
+
+#include "support/SubstringMatcher.hpp"
+
+#include <string>
+#include <vector>
+
+namespace hdoc::indexer {
+/// @brief Checks if decls are in a namespace whose name contains any of a list of substrings, such as
+/// cfg->ignoreNamespaces or cfg->detailNamespaces.
+///
+/// The verdict for each namespace, which includes the verdicts of the namespaces enclosing it, is remembered so that
+/// each namespace is only checked once no matter how many decls are in it.
+/// NamespaceDecls belong to one TU, so clear() must be called at the start of every TU.
+/// Only the matchers of one TU may use an instance.
+class NamespaceCache {
+public:
+  NamespaceCache(const std::vector<std::string>& substrings) : substrings(substrings) {}
+
+  /// @brief Check if decl is, or is enclosed by, a namespace whose name contains any of the substrings.
+  /// Anonymous namespaces never match.
+  bool isInMatchingNamespace(const clang::Decl* decl);
+
+  /// @brief Forget all namespaces. Must be called before the cache is used with decls of a different TU.
+  void clear() {
+    this->verdicts.clear();
+  }
+
+private:
+  /// Check if ns, or any namespace enclosing it, has a name that contains any of the substrings.
+  bool isMatchingNamespace(const clang::NamespaceDecl* ns);
+
+  hdoc::utils::SubstringMatcher                     substrings; ///< Compiled substrings
+  llvm::DenseMap<const clang::NamespaceDecl*, bool> verdicts;   ///< Namespaces that were checked so far
+};
+} // namespace hdoc::indexer
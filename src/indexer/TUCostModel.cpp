@@ -0,0 +1,103 @@
+// Copyright 2019-2023 hdoc
+// SPDX-License-Identifier: AGPL-3.0-only
+
+#include "indexer/TUCostModel.hpp"
+
+#include <algorithm>
+#include <cstdint>
+
+#include "spdlog/spdlog.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/raw_ostream.h"
+
+hdoc::indexer::TUCostModel::TUCostModel(const std::filesystem::path& cacheDir) {
+  if (cacheDir.empty()) {
+    return;
+  }
+  this->timingsPath = cacheDir / "timings";
+
+  auto buf = llvm::MemoryBuffer::getFile(this->timingsPath.string(), /*IsText=*/true);
+  if (!buf) {
+    return;
+  }
+
+  // Each line holds the number of seconds a TU took followed by its path
+  llvm::StringRef data = buf->get()->getBuffer();
+  while (data.empty() == false) {
+    auto [line, rest]       = data.split('\n');
+    auto [secondsStr, path] = line.split(' ');
+    data                    = rest;
+
+    double seconds = 0;
+    if (secondsStr.getAsDouble(seconds) || path.empty()) {
+      continue;
+    }
+    this->timings[path] = seconds;
+  }
+}
+
+void hdoc::indexer::TUCostModel::sortByDescendingCost(std::vector<std::string>& files) const {
+  std::vector<uint64_t> sizes(files.size(), 0);
+  for (uint64_t i = 0; i < files.size(); i++) {
+    std::error_code ec;
+    sizes[i] = std::filesystem::file_size(files[i], ec);
+    if (ec) {
+      sizes[i] = 0;
+    }
+  }
+
+  // Convert sizes to seconds using the median time per byte of the TUs with a known time,
+  // so that TUs with and without a known time can be compared
+  std::vector<double> secondsPerByte;
+  for (uint64_t i = 0; i < files.size(); i++) {
+    if (const auto it = this->timings.find(files[i]); it != this->timings.end() && sizes[i] > 0) {
+      secondsPerByte.emplace_back(it->second / sizes[i]);
+    }
+  }
+  double scale = 1;
+  if (secondsPerByte.size() > 0) {
+    const auto median = secondsPerByte.begin() + (secondsPerByte.size() - 1) / 2;
+    std::nth_element(secondsPerByte.begin(), median, secondsPerByte.end());
+    scale = *median;
+  }
+
+  std::vector<std::pair<double, std::string>> costs;
+  costs.reserve(files.size());
+  for (uint64_t i = 0; i < files.size(); i++) {
+    const auto it = this->timings.find(files[i]);
+    costs.emplace_back(it != this->timings.end() ? it->second : sizes[i] * scale, std::move(files[i]));
+  }
+  std::stable_sort(costs.begin(), costs.end(), [](const auto& a, const auto& b) { return a.first > b.first; });
+
+  for (uint64_t i = 0; i < files.size(); i++) {
+    files[i] = std::move(costs[i].second);
+  }
+}
+
+void hdoc::indexer::TUCostModel::record(const std::string& path, const double seconds) {
+  std::lock_guard<std::mutex> lock(this->mutex);
+  this->newTimings[path] = seconds;
+}
+
+void hdoc::indexer::TUCostModel::store() const {
+  std::lock_guard<std::mutex> lock(this->mutex);
+  if (this->timingsPath.empty() || this->newTimings.empty()) {
+    return;
+  }
+
+  // Keep timings of TUs that weren't parsed in this run, for example because they were loaded from the cache
+  llvm::StringMap<double> allTimings = this->timings;
+  for (const auto& entry : this->newTimings) {
+    allTimings[entry.getKey()] = entry.getValue();
+  }
+
+  if (auto err = llvm::writeToOutput(this->timingsPath.string(), [&](llvm::raw_ostream& os) {
+        for (const auto& entry : allTimings) {
+          os << llvm::format("%.3f", entry.getValue()) << " " << entry.getKey() << "\n";
+        }
+        return llvm::Error::success();
+      })) {
+    spdlog::warn("Unable to write TU timings to {}: {}", this->timingsPath.string(), llvm::toString(std::move(err)));
+  }
+}
@@ -0,0 +1,40 @@
+// Copyright 2019-2023 hdoc
+// SPDX-License-Identifier: AGPL-3.0-only
+
+#pragma once
+
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "llvm/ADT/StringMap.h"
+
+namespace hdoc::indexer {
+/// @brief Estimates how long each translation unit takes to index, so that the most expensive TUs can be started
+/// first instead of being left to run alone at the end.
+///
+/// Estimates are based on how long a TU took to index in previous runs, which are stored in a file in the
+/// index cache directory. TUs without a recorded time are estimated from the size of their source file.
+class TUCostModel {
+public:
+  /// Load the timings of previous runs from cacheDir. An empty cacheDir disables persistent timings.
+  TUCostModel(const std::filesystem::path& cacheDir);
+
+  /// @brief Reorder files so that the TUs that are expected to take longest come first.
+  /// TUs with the same estimate keep their relative order.
+  void sortByDescendingCost(std::vector<std::string>& files) const;
+
+  /// @brief Record that indexing the TU at path took seconds. Safe to call from multiple threads at once.
+  void record(const std::string& path, const double seconds);
+
+  /// @brief Write the recorded timings, along with the ones from previous runs, to the cache directory.
+  void store() const;
+
+private:
+  std::filesystem::path   timingsPath; ///< File holding the timings, empty if they aren't persisted
+  mutable std::mutex      mutex;       ///< Guards newTimings
+  llvm::StringMap<double> timings;     ///< Seconds each TU took in previous runs
+  llvm::StringMap<double> newTimings;  ///< Seconds each TU took in this run
+};
+} // namespace hdoc::indexer
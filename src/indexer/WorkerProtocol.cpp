@@ -0,0 +1,103 @@
+// Copyright 2019-2023 hdoc
+// SPDX-License-Identifier: AGPL-3.0-only
+
+#include "indexer/WorkerProtocol.hpp"
+#include "serde/BinarySerializer.hpp"
+#include "support/StringUtils.hpp"
+
+#include <charconv>
+
+/// First line of requests and results. Workers are always the same binary as their parent,
+/// so this only guards against reading truncated or unrelated files.
+static constexpr std::string_view requestHeader = "HDOCREQ1\n";
+static constexpr std::string_view resultHeader  = "HDOCRES1\n";
+
+std::string hdoc::indexer::serializeWorkerRequest(const WorkerRequest& request) {
+  std::string       data(requestHeader);
+  const std::string flags       = {request.cfg.ignorePrivateMembers ? '1' : '0',
+                                   request.cfg.pruneAST ? '1' : '0',
+                                   request.cfg.deduplicateHeaders ? '1' : '0'};
+  const std::string numCommands = std::to_string(request.commands.size());
+  hdoc::utils::appendLines(data, {request.tu, request.pchPath, request.cfg.rootDir.string(), flags, numCommands});
+  hdoc::utils::appendLines(data, request.claimedFiles);
+  hdoc::utils::appendLines(data, request.extraArgs);
+  hdoc::utils::appendLines(data, request.cfg.ignorePaths);
+  hdoc::utils::appendLines(data, request.cfg.ignoreNamespaces);
+  hdoc::utils::appendLines(data, request.cfg.detailNamespaces);
+  for (const auto& cmd : request.commands) {
+    hdoc::utils::appendLines(data, {cmd.Directory, cmd.Filename, cmd.Output});
+    hdoc::utils::appendLines(data, cmd.CommandLine);
+  }
+  return data;
+}
+
+bool hdoc::indexer::deserializeWorkerRequest(std::string_view data, WorkerRequest& request) {
+  std::vector<std::string> fields;
+  if (data.starts_with(requestHeader) == false) {
+    return false;
+  }
+  data.remove_prefix(requestHeader.size());
+  if (hdoc::utils::consumeLines(data, fields) == false || fields.size() != 5 || fields[3].size() != 3 ||
+      hdoc::utils::consumeLines(data, request.claimedFiles) == false ||
+      hdoc::utils::consumeLines(data, request.extraArgs) == false ||
+      hdoc::utils::consumeLines(data, request.cfg.ignorePaths) == false ||
+      hdoc::utils::consumeLines(data, request.cfg.ignoreNamespaces) == false ||
+      hdoc::utils::consumeLines(data, request.cfg.detailNamespaces) == false) {
+    return false;
+  }
+  request.tu                       = fields[0];
+  request.pchPath                  = fields[1];
+  request.cfg.rootDir              = fields[2];
+  request.cfg.ignorePrivateMembers = fields[3][0] == '1';
+  request.cfg.pruneAST             = fields[3][1] == '1';
+  request.cfg.deduplicateHeaders   = fields[3][2] == '1';
+
+  uint64_t   numCommands = 0;
+  const auto result      = std::from_chars(fields[4].data(), fields[4].data() + fields[4].size(), numCommands);
+  if (result.ec != std::errc() || result.ptr != fields[4].data() + fields[4].size()) {
+    return false;
+  }
+
+  request.commands.clear();
+  for (uint64_t i = 0; i < numCommands; i++) {
+    clang::tooling::CompileCommand cmd;
+    if (hdoc::utils::consumeLines(data, fields) == false || fields.size() != 3 ||
+        hdoc::utils::consumeLines(data, cmd.CommandLine) == false) {
+      return false;
+    }
+    cmd.Directory = fields[0];
+    cmd.Filename  = fields[1];
+    cmd.Output    = fields[2];
+    request.commands.emplace_back(std::move(cmd));
+  }
+  return data.empty();
+}
+
+std::string hdoc::indexer::serializeWorkerResult(const WorkerResult& result) {
+  std::string data(resultHeader);
+  data += result.success ? "1\n" : "0\n";
+  hdoc::utils::appendLines(data, result.deps);
+  hdoc::utils::appendLines(data, result.claimedFiles);
+  hdoc::utils::appendLines(data, result.skippedFiles);
+  data += hdoc::serde::serializeToBinary(result.index);
+  return data;
+}
+
+bool hdoc::indexer::deserializeWorkerResult(std::string_view data, WorkerResult& result) {
+  if (data.starts_with(resultHeader) == false) {
+    return false;
+  }
+  data.remove_prefix(resultHeader.size());
+  if (data.starts_with("1\n") == false && data.starts_with("0\n") == false) {
+    return false;
+  }
+  result.success = data.front() == '1';
+  data.remove_prefix(2);
+
+  if (hdoc::utils::consumeLines(data, result.deps) == false ||
+      hdoc::utils::consumeLines(data, result.claimedFiles) == false ||
+      hdoc::utils::consumeLines(data, result.skippedFiles) == false) {
+    return false;
+  }
+  return hdoc::serde::deserializeFromBinary(data, result.index);
+}
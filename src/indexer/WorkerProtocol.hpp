@@ -0,0 +1,49 @@
+// Copyright 2019-2023 hdoc
+// SPDX-License-Identifier: AGPL-3.0-only
+
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "clang/Tooling/CompilationDatabase.h"
+
+#include "types/Config.hpp"
+#include "types/Index.hpp"
+
+namespace hdoc::indexer {
+/// @brief Asks a worker process to index a single TU, see Indexer::indexTranslationUnitInWorker().
+/// Workers don't read .hdoc.toml or the compilation database, so the request carries everything needed to parse
+/// and index the TU.
+struct WorkerRequest {
+  std::string                                 tu;           ///< Path of the TU to index
+  std::string                                 pchPath;      ///< Precompiled header to include, empty if none
+  std::vector<std::string>                    claimedFiles; ///< Files that other TUs already claimed
+  std::vector<clang::tooling::CompileCommand> commands;     ///< Compile commands of the TU
+  std::vector<std::string>                    extraArgs;    ///< Include paths and other args appended to commands
+
+  /// Options that decide what's indexed. Only rootDir, ignorePaths, ignoreNamespaces, detailNamespaces,
+  /// ignorePrivateMembers, pruneAST, and deduplicateHeaders are sent to the worker.
+  hdoc::types::Config cfg;
+};
+
+/// @brief Everything a worker process found while indexing a TU.
+struct WorkerResult {
+  bool                     success = false; ///< Did clang parse the TU successfully?
+  hdoc::types::Index       index;           ///< Symbols in the TU
+  std::vector<std::string> deps;            ///< Absolute paths of all files the TU included
+  std::vector<std::string> claimedFiles;    ///< Files the TU claimed
+  std::vector<std::string> skippedFiles;    ///< Files the TU left for other TUs to index
+};
+
+std::string serializeWorkerRequest(const WorkerRequest& request);
+
+/// Returns false if data isn't a complete request.
+bool deserializeWorkerRequest(std::string_view data, WorkerRequest& request);
+
+std::string serializeWorkerResult(const WorkerResult& result);
+
+/// Returns false if data isn't a complete result. result.index must be empty.
+bool deserializeWorkerResult(std::string_view data, WorkerResult& result);
+} // namespace hdoc::indexer
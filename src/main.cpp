@@ -10,6 +10,7 @@
 #include "serde/HTMLWriter.hpp"
 #include "serde/SerdeUtils.hpp"
 #include "serde/Serialization.hpp"
+#include "support/Instrumentation.hpp"
 
 int main(int argc, char** argv) {
   // Print stack trace on failure
@@ -24,28 +25,37 @@ int main(int argc, char** argv) {
     return EXIT_FAILURE;
   }
 
-  llvm::ThreadPool       pool(llvm::hardware_concurrency(cfg.numThreads));
-  hdoc::indexer::Indexer indexer(&cfg, pool);
-  indexer.run();
-  indexer.pruneMethods();
-  indexer.pruneTypeRefs();
-  indexer.resolveNamespaces();
-  indexer.updateRecordNames();
-  indexer.updateMemberFunctions();
-  indexer.resolveFunctionOverloads();
+  // hdoc launches itself as a worker process to index a single TU when isolate_tus is enabled
+  if (cfg.workerRequest.empty() == false) {
+    return hdoc::indexer::Indexer::runWorker(cfg.workerRequest) ? EXIT_SUCCESS : EXIT_FAILURE;
+  }
+
+  hdoc::utils::Instrumentation instrumentation;
+  llvm::ThreadPool             pool(llvm::hardware_concurrency(cfg.numThreads));
+  hdoc::indexer::Indexer       indexer(&cfg, pool, &instrumentation);
+
+  instrumentation.measure("index", [&]() { indexer.run(); });
+  instrumentation.measure("postProcess", [&]() { indexer.postProcess(); });
   indexer.printStats();
   const hdoc::types::Index* index = indexer.dump();
+  instrumentation.recordIndex(*index);
 
   hdoc::serde::HTMLWriter htmlWriter(index, &cfg, pool);
-  htmlWriter.printFunctions();
-  htmlWriter.printAliases();
-  htmlWriter.printRecords();
-  htmlWriter.printNamespaces();
-  htmlWriter.printEnums();
+  instrumentation.measure("printFunctions", [&]() { htmlWriter.printFunctions(); });
+  instrumentation.measure("printAliases", [&]() { htmlWriter.printAliases(); });
+  instrumentation.measure("printRecords", [&]() { htmlWriter.printRecords(); });
+  instrumentation.measure("printNamespaces", [&]() { htmlWriter.printNamespaces(); });
+  instrumentation.measure("printEnums", [&]() { htmlWriter.printEnums(); });
   if(cfg.minimalOutput == false) {
-    htmlWriter.printSearchPage();
-    htmlWriter.processMarkdownFiles();
-    htmlWriter.printProjectIndex();
+    instrumentation.measure("printSearchPage", [&]() { htmlWriter.printSearchPage(); });
+    instrumentation.measure("processMarkdownFiles", [&]() { htmlWriter.processMarkdownFiles(); });
+    instrumentation.measure("printProjectIndex", [&]() { htmlWriter.printProjectIndex(); });
+  }
+
+  bool pagesWritten = false;
+  instrumentation.measure("writePages", [&]() { pagesWritten = htmlWriter.waitForPages(); });
+  if (pagesWritten == false) {
+    return EXIT_FAILURE;
   }
 
   // Ensure that cfg was properly initialized
@@ -57,5 +67,9 @@ int main(int argc, char** argv) {
     }
   }
 
+  if (cfg.debugPerfReport.empty() == false && instrumentation.write(cfg.debugPerfReport) == false) {
+    return EXIT_FAILURE;
+  }
+
   return EXIT_SUCCESS;
 }
@@ -0,0 +1,459 @@
+// Copyright 2019-2023 hdoc
+// SPDX-License-Identifier: AGPL-3.0-only
+
+#include "serde/BinarySerializer.hpp"
+
+#include <cstring>
+
+/// Bumped whenever the layout of the binary format or of the symbol types changes,
+/// which invalidates everything written by older versions.
+static constexpr uint64_t binaryFormatVersion = 2;
+static constexpr char     binaryFormatMagic[] = "HDOCIDX";
+
+namespace {
+/// Appends values to a byte buffer. Integers are stored as LEB128 varints since most of them
+/// (line numbers, enum values, sizes) are small, while SymbolIDs are stored as raw 64 bit values.
+class BinaryWriter {
+public:
+  explicit BinaryWriter(std::string& out) : out(out) {}
+
+  void u64(uint64_t v) {
+    while (v >= 0x80) {
+      out.push_back(static_cast<char>((v & 0x7f) | 0x80));
+      v >>= 7;
+    }
+    out.push_back(static_cast<char>(v));
+  }
+
+  void i64(const int64_t v) {
+    // Zigzag encoding keeps small negative values short
+    u64((static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63));
+  }
+
+  void boolean(const bool v) {
+    out.push_back(v ? 1 : 0);
+  }
+
+  void str(const std::string_view s) {
+    u64(s.size());
+    out.append(s.data(), s.size());
+  }
+
+  void id(const hdoc::types::SymbolID& id) {
+    char buf[sizeof(uint64_t)];
+    std::memcpy(buf, &id.hashValue, sizeof(buf));
+    out.append(buf, sizeof(buf));
+  }
+
+  void ids(const std::vector<hdoc::types::SymbolID>& v) {
+    u64(v.size());
+    for (const auto& i : v) {
+      id(i);
+    }
+  }
+
+private:
+  std::string& out;
+};
+
+/// Reads values written by BinaryWriter. Reads past the end of the buffer set `ok` to false and return
+/// default values, so callers only need to check `ok` once they are done.
+class BinaryReader {
+public:
+  explicit BinaryReader(const std::string_view in) : in(in) {}
+
+  uint64_t u64() {
+    uint64_t v     = 0;
+    uint32_t shift = 0;
+    while (pos < in.size() && shift < 64) {
+      const uint8_t byte = static_cast<uint8_t>(in[pos++]);
+      v |= static_cast<uint64_t>(byte & 0x7f) << shift;
+      if ((byte & 0x80) == 0) {
+        return v;
+      }
+      shift += 7;
+    }
+    ok = false;
+    return 0;
+  }
+
+  int64_t i64() {
+    const uint64_t v = u64();
+    return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1);
+  }
+
+  bool boolean() {
+    if (pos >= in.size()) {
+      ok = false;
+      return false;
+    }
+    return in[pos++] != 0;
+  }
+
+  std::string str() {
+    const uint64_t size = u64();
+    if (ok == false || size > in.size() - pos) {
+      ok = false;
+      return "";
+    }
+    std::string s(in.substr(pos, size));
+    pos += size;
+    return s;
+  }
+
+  hdoc::types::SymbolID id() {
+    if (in.size() - pos < sizeof(uint64_t)) {
+      ok = false;
+      return hdoc::types::SymbolID();
+    }
+    uint64_t v;
+    std::memcpy(&v, in.data() + pos, sizeof(v));
+    pos += sizeof(v);
+    return hdoc::types::SymbolID(v);
+  }
+
+  std::vector<hdoc::types::SymbolID> ids() {
+    std::vector<hdoc::types::SymbolID> v;
+    const uint64_t                     size = length();
+    v.reserve(size);
+    for (uint64_t i = 0; i < size; i++) {
+      v.emplace_back(id());
+    }
+    return v;
+  }
+
+  /// Read the length of a sequence, rejecting values that can't possibly fit in the remaining data.
+  /// This prevents huge allocations when reading corrupt files.
+  uint64_t length() {
+    const uint64_t size = u64();
+    if (size > in.size() - pos) {
+      ok = false;
+      return 0;
+    }
+    return size;
+  }
+
+  bool atEnd() const {
+    return pos == in.size();
+  }
+
+  bool ok = true;
+
+private:
+  std::string_view in;
+  std::size_t      pos = 0;
+};
+} // namespace
+
+static void write(BinaryWriter& w, const hdoc::types::Symbol& s) {
+  w.str(s.name);
+  w.str(s.briefComment);
+  w.str(s.docComment);
+  w.id(s.ID);
+  w.str(s.file);
+  w.u64(s.line);
+  w.id(s.parentNamespaceID);
+  w.boolean(s.isDetail);
+}
+
+static void read(BinaryReader& r, hdoc::types::Symbol& s) {
+  s.name              = r.str();
+  s.briefComment      = r.str();
+  s.docComment        = r.str();
+  s.ID                = r.id();
+  s.file              = r.str();
+  s.line              = r.u64();
+  s.parentNamespaceID = r.id();
+  s.isDetail          = r.boolean();
+}
+
+static void write(BinaryWriter& w, const hdoc::types::TypeRef& t) {
+  w.id(t.id);
+  w.str(t.name);
+}
+
+static void read(BinaryReader& r, hdoc::types::TypeRef& t) {
+  t.id   = r.id();
+  t.name = r.str();
+}
+
+static void write(BinaryWriter& w, const std::vector<hdoc::types::TemplateParam>& tparams) {
+  w.u64(tparams.size());
+  for (const auto& tparam : tparams) {
+    w.u64(static_cast<uint64_t>(tparam.templateType));
+    w.str(tparam.name);
+    w.str(tparam.type);
+    w.str(tparam.docComment);
+    w.str(tparam.defaultValue);
+    w.boolean(tparam.isParameterPack);
+    w.boolean(tparam.isTypename);
+    w.u64(tparam.depth);
+  }
+}
+
+static void read(BinaryReader& r, std::vector<hdoc::types::TemplateParam>& tparams) {
+  const uint64_t size = r.length();
+  tparams.resize(size);
+  for (auto& tparam : tparams) {
+    tparam.templateType    = static_cast<hdoc::types::TemplateParam::TemplateType>(r.u64());
+    tparam.name            = r.str();
+    tparam.type            = r.str();
+    tparam.docComment      = r.str();
+    tparam.defaultValue    = r.str();
+    tparam.isParameterPack = r.boolean();
+    tparam.isTypename      = r.boolean();
+    tparam.depth           = r.u64();
+  }
+}
+
+static void write(BinaryWriter& w, const hdoc::types::FunctionSymbol& f) {
+  write(w, static_cast<const hdoc::types::Symbol&>(f));
+  w.boolean(f.isRecordMember);
+  w.boolean(f.isHiddenFriend);
+  w.boolean(f.isConstexpr);
+  w.boolean(f.isConsteval);
+  w.boolean(f.isExplicit);
+  w.boolean(f.isInline);
+  w.boolean(f.isNoDiscard);
+  w.boolean(f.isNoReturn);
+  w.boolean(f.isConst);
+  w.boolean(f.isVolatile);
+  w.boolean(f.isRestrict);
+  w.boolean(f.isVirtual);
+  w.boolean(f.isVariadic);
+  w.boolean(f.isNoExcept);
+  w.boolean(f.hasTrailingReturn);
+  w.boolean(f.isCtorOrDtor);
+  w.boolean(f.isConversionOp);
+  w.u64(f.nameStart);
+  w.u64(f.postTemplate);
+  w.u64(f.access);
+  w.u64(f.storageClass);
+  w.u64(f.refQualifier);
+  w.str(f.proto);
+  write(w, f.returnType);
+  w.str(f.returnTypeDocComment);
+  w.u64(f.params.size());
+  for (const auto& param : f.params) {
+    w.str(param.name);
+    write(w, param.type);
+    w.str(param.docComment);
+    w.str(param.defaultValue);
+  }
+  write(w, f.templateParams);
+  w.str(f.freestandingID.name);
+  w.id(f.freestandingID.parentNamespaceID);
+}
+
+static void read(BinaryReader& r, hdoc::types::FunctionSymbol& f) {
+  read(r, static_cast<hdoc::types::Symbol&>(f));
+  f.isRecordMember    = r.boolean();
+  f.isHiddenFriend    = r.boolean();
+  f.isConstexpr       = r.boolean();
+  f.isConsteval       = r.boolean();
+  f.isExplicit        = r.boolean();
+  f.isInline          = r.boolean();
+  f.isNoDiscard       = r.boolean();
+  f.isNoReturn        = r.boolean();
+  f.isConst           = r.boolean();
+  f.isVolatile        = r.boolean();
+  f.isRestrict        = r.boolean();
+  f.isVirtual         = r.boolean();
+  f.isVariadic        = r.boolean();
+  f.isNoExcept        = r.boolean();
+  f.hasTrailingReturn = r.boolean();
+  f.isCtorOrDtor      = r.boolean();
+  f.isConversionOp    = r.boolean();
+  f.nameStart         = r.u64();
+  f.postTemplate      = r.u64();
+  f.access            = static_cast<clang::AccessSpecifier>(r.u64());
+  f.storageClass      = static_cast<clang::StorageClass>(r.u64());
+  f.refQualifier      = static_cast<clang::RefQualifierKind>(r.u64());
+  f.proto             = r.str();
+  read(r, f.returnType);
+  f.returnTypeDocComment = r.str();
+  f.params.resize(r.length());
+  for (auto& param : f.params) {
+    param.name = r.str();
+    read(r, param.type);
+    param.docComment   = r.str();
+    param.defaultValue = r.str();
+  }
+  read(r, f.templateParams);
+  f.freestandingID.name              = r.str();
+  f.freestandingID.parentNamespaceID = r.id();
+}
+
+static void write(BinaryWriter& w, const hdoc::types::RecordSymbol& c) {
+  write(w, static_cast<const hdoc::types::Symbol&>(c));
+  w.str(c.type);
+  w.str(c.proto);
+  w.u64(c.vars.size());
+  for (const auto& var : c.vars) {
+    w.boolean(var.isStatic);
+    w.str(var.name);
+    write(w, var.type);
+    w.str(var.defaultValue);
+    w.str(var.docComment);
+    w.u64(var.access);
+  }
+  w.ids(c.methodIDs);
+  w.u64(c.baseRecords.size());
+  for (const auto& base : c.baseRecords) {
+    w.id(base.id);
+    w.u64(base.access);
+    w.str(base.name);
+  }
+  write(w, c.templateParams);
+  w.ids(c.aliasIDs);
+  w.ids(c.hiddenFriendIDs);
+}
+
+static void read(BinaryReader& r, hdoc::types::RecordSymbol& c) {
+  read(r, static_cast<hdoc::types::Symbol&>(c));
+  c.type  = r.str();
+  c.proto = r.str();
+  c.vars.resize(r.length());
+  for (auto& var : c.vars) {
+    var.isStatic = r.boolean();
+    var.name     = r.str();
+    read(r, var.type);
+    var.defaultValue = r.str();
+    var.docComment   = r.str();
+    var.access       = static_cast<clang::AccessSpecifier>(r.u64());
+  }
+  c.methodIDs = r.ids();
+  c.baseRecords.resize(r.length());
+  for (auto& base : c.baseRecords) {
+    base.id     = r.id();
+    base.access = static_cast<clang::AccessSpecifier>(r.u64());
+    base.name   = r.str();
+  }
+  read(r, c.templateParams);
+  c.aliasIDs        = r.ids();
+  c.hiddenFriendIDs = r.ids();
+}
+
+static void write(BinaryWriter& w, const hdoc::types::EnumSymbol& e) {
+  write(w, static_cast<const hdoc::types::Symbol&>(e));
+  w.str(e.type);
+  w.u64(e.members.size());
+  for (const auto& member : e.members) {
+    w.i64(member.value);
+    w.str(member.name);
+    w.str(member.docComment);
+  }
+}
+
+static void read(BinaryReader& r, hdoc::types::EnumSymbol& e) {
+  read(r, static_cast<hdoc::types::Symbol&>(e));
+  e.type = r.str();
+  e.members.resize(r.length());
+  for (auto& member : e.members) {
+    member.value      = r.i64();
+    member.name       = r.str();
+    member.docComment = r.str();
+  }
+}
+
+static void write(BinaryWriter& w, const hdoc::types::NamespaceSymbol& n) {
+  write(w, static_cast<const hdoc::types::Symbol&>(n));
+  w.ids(n.records);
+  w.ids(n.namespaces);
+  w.ids(n.enums);
+  w.ids(n.usings);
+  w.ids(n.functions);
+}
+
+static void read(BinaryReader& r, hdoc::types::NamespaceSymbol& n) {
+  read(r, static_cast<hdoc::types::Symbol&>(n));
+  n.records    = r.ids();
+  n.namespaces = r.ids();
+  n.enums      = r.ids();
+  n.usings     = r.ids();
+  n.functions  = r.ids();
+}
+
+static void write(BinaryWriter& w, const hdoc::types::AliasSymbol& a) {
+  write(w, static_cast<const hdoc::types::Symbol&>(a));
+  write(w, a.target);
+  w.boolean(a.isRecordMember);
+  w.u64(a.access);
+  write(w, a.templateParams);
+  w.str(a.proto);
+}
+
+static void read(BinaryReader& r, hdoc::types::AliasSymbol& a) {
+  read(r, static_cast<hdoc::types::Symbol&>(a));
+  read(r, a.target);
+  a.isRecordMember = r.boolean();
+  a.access         = static_cast<clang::AccessSpecifier>(r.u64());
+  read(r, a.templateParams);
+  a.proto = r.str();
+}
+
+template <typename T> static void writeDatabase(BinaryWriter& w, const hdoc::types::Database<T>& db) {
+  w.u64(db.numMatches);
+  w.u64(db.entries.size());
+  for (const auto& [k, v] : db.entries) {
+    write(w, v);
+  }
+}
+
+template <typename T> static void readDatabase(BinaryReader& r, hdoc::types::Database<T>& db) {
+  db.numMatches       = r.u64();
+  const uint64_t size = r.length();
+  db.entries.reserve(size);
+  for (uint64_t i = 0; i < size && r.ok; i++) {
+    T s;
+    read(r, s);
+    db.entries.emplace(s.ID, std::move(s));
+  }
+}
+
+std::string hdoc::serde::serializeToBinary(const hdoc::types::Index& index) {
+  std::string  out;
+  BinaryWriter w(out);
+  w.str(binaryFormatMagic);
+  w.u64(binaryFormatVersion);
+
+  writeDatabase(w, index.functions);
+  writeDatabase(w, index.records);
+  writeDatabase(w, index.enums);
+  writeDatabase(w, index.namespaces);
+  writeDatabase(w, index.aliases);
+
+  w.u64(index.freestandingFunctions.size());
+  for (const auto& [id, group] : index.freestandingFunctions) {
+    w.str(id.name);
+    w.id(id.parentNamespaceID);
+    w.boolean(group.isDetail);
+    w.ids(group.functionIDs);
+  }
+  return out;
+}
+
+bool hdoc::serde::deserializeFromBinary(const std::string_view data, hdoc::types::Index& index) {
+  BinaryReader r(data);
+  if (r.str() != binaryFormatMagic || r.u64() != binaryFormatVersion || r.ok == false) {
+    return false;
+  }
+
+  readDatabase(r, index.functions);
+  readDatabase(r, index.records);
+  readDatabase(r, index.enums);
+  readDatabase(r, index.namespaces);
+  readDatabase(r, index.aliases);
+
+  const uint64_t numGroups = r.length();
+  for (uint64_t i = 0; i < numGroups && r.ok; i++) {
+    hdoc::types::FreestandingFunctionID id;
+    hdoc::types::FreestandingFunction   group;
+    id.name              = r.str();
+    id.parentNamespaceID = r.id();
+    group.isDetail       = r.boolean();
+    group.functionIDs    = r.ids();
+    index.freestandingFunctions.emplace(std::move(id), std::move(group));
+  }
+  return r.ok && r.atEnd();
+}
@@ -0,0 +1,20 @@
+// Copyright 2019-2023 hdoc
+// SPDX-License-Identifier: AGPL-3.0-only
+
+#pragma once
+
+#include <string>
+#include <string_view>
+
+#include "types/Index.hpp"
+
+namespace hdoc::serde {
+/// @brief Serialize hdoc's index into a compact binary representation.
+/// The format is private to hdoc and is only meant to be read back by the same build of hdoc, for example when
+/// loading cached translation units. Use serializeToJSON() for anything that leaves the machine.
+std::string serializeToBinary(const hdoc::types::Index& index);
+
+/// @brief Deserialize an index written by serializeToBinary() into index, which is expected to be empty.
+/// Returns false if the data is truncated, corrupt, or was written by an incompatible version of hdoc.
+bool deserializeFromBinary(const std::string_view data, hdoc::types::Index& index);
+} // namespace hdoc::serde
@@ -8,13 +8,14 @@
 #include "llvm/Support/JSON.h"
 
 #include <filesystem>
-#include <fstream>
+#include <set>
 #include <stack>
 #include <string>
 
 #include "serde/CppReferenceURLs.hpp"
 #include "serde/HTMLWriter.hpp"
 #include "serde/SerdeUtils.hpp"
+#include "support/HTMLStream.hpp"
 #include "support/MarkdownConverter.hpp"
 #include "support/StringUtils.hpp"
 #include "types/Symbols.hpp"
@@ -60,13 +61,30 @@ extern unsigned int ___assets_auto_render_min_js_len;
 extern unsigned int ___assets_highlight_min_js_len;
 extern unsigned int ___assets_index_min_js_len;
 
+/// Pages are rendered on the thread pool and written on these threads, so that rendering doesn't wait for the disk
+static constexpr uint32_t numWriterThreads = 2;
+/// Rendered pages that may wait to be written before rendering blocks, which bounds the memory they take
+static constexpr uint32_t maxQueuedPages = 256;
+
+static hdoc::serde::PageChrome renderPageChrome(const hdoc::types::Config& cfg, const bool topLevel);
+static std::string             renderSharedLayout(const hdoc::types::Config& cfg);
+
 hdoc::serde::HTMLWriter::HTMLWriter(const hdoc::types::Index*  index,
                                     const hdoc::types::Config* cfg,
                                     llvm::ThreadPool&          pool)
-    : index(index), cfg(cfg), pool(pool) {
+    : index(index), cfg(cfg), pool(pool), writer(numWriterThreads, maxQueuedPages) {
+
+  // Pack all files into a single archive instead of the output directory if requested
+  if (this->cfg->outputArchive.empty() == false) {
+    if (this->writer.openArchive(this->cfg->outputArchive, this->cfg->outputDir) == false) {
+      spdlog::error("Unable to write documentation to {}. Exiting.", this->cfg->outputArchive.string());
+      std::exit(1);
+    }
+  }
+
   // Create the directory where the HTML files will be placed
   std::error_code ec;
-  if (std::filesystem::exists(this->cfg->outputDir) == false) {
+  if (this->cfg->outputArchive.empty() && std::filesystem::exists(this->cfg->outputDir) == false) {
     if (std::filesystem::create_directories(this->cfg->outputDir, ec) == false) {
       spdlog::error("Creation of directory {} failed with the following error message: '{}'. Exiting.",
                     this->cfg->outputDir.string(),
@@ -100,19 +118,22 @@ hdoc::serde::HTMLWriter::HTMLWriter(const hdoc::types::Index*  index,
   };
 
   for (const auto& file : bundledFiles) {
-    std::ofstream out(file.path, std::ios::binary);
-    out.write((char*)file.file, file.len);
-    out.close();
+    this->writer.write(file.path, std::string(reinterpret_cast<const char*>(file.file), file.len));
+  }
+
+  if (this->cfg->minimalOutput == false) {
+    this->topLevelChrome = renderPageChrome(*this->cfg, true);
+    this->nestedChrome   = renderPageChrome(*this->cfg, false);
+    if (this->cfg->sharedLayout) {
+      this->writer.write(this->cfg->outputDir / "layout.js", renderSharedLayout(*this->cfg));
+    }
   }
 }
 
 std::string escapeForHTML(const std::string& in) {
-  std::string str = in;
-  str = hdoc::utils::replaceAll(str, "&", "&amp;");
-  str = hdoc::utils::replaceAll(str, "<", "&lt;");
-  str = hdoc::utils::replaceAll(str, ">", "&gt;");
-  str = hdoc::utils::replaceAll(str, "\"", "&quot;");
-  str = hdoc::utils::replaceAll(str, "'", "&apos;");
+  std::string str;
+  str.reserve(in.size());
+  hdoc::utils::appendEscapedHTML(str, in);
   return str;
 }
 
@@ -120,52 +141,105 @@ template<typename SymbolType>
 std::string entryPageUrl(bool topLevel) {
   const std::string suffix = "/index.html";
   const std::string prefix = topLevel ? "" : "../";
-  return prefix + SymbolType().directory() + suffix;
+  return prefix + std::string(SymbolType::directory()) + suffix;
 }
 
-void appendEntryPageLinks(CTML::Node& node, bool topLevel) {
-  node.AddChild(CTML::Node("li").AddChild(CTML::Node("a", "Namespaces").SetAttr("href", entryPageUrl<hdoc::types::NamespaceSymbol>(topLevel))));
-  node.AddChild(CTML::Node("li").AddChild(CTML::Node("a", "Records").SetAttr("href", entryPageUrl<hdoc::types::RecordSymbol>(topLevel))));
-  node.AddChild(CTML::Node("li").AddChild(CTML::Node("a", "Enums").SetAttr("href", entryPageUrl<hdoc::types::EnumSymbol>(topLevel))));
-  node.AddChild(CTML::Node("li").AddChild(CTML::Node("a", "Functions").SetAttr("href", entryPageUrl<hdoc::types::FunctionSymbol>(topLevel))));
-  node.AddChild(CTML::Node("li").AddChild(CTML::Node("a", "Aliases").SetAttr("href", entryPageUrl<hdoc::types::AliasSymbol>(topLevel))));
+void appendEntryPageLinks(hdoc::utils::HTMLStream& html, bool topLevel) {
+  const auto appendLink = [&](const std::string_view name, const std::string& url) {
+    html.open({"li"}).element({"a"}, name, {{"href", url}}).close({"li"});
+  };
+  appendLink("Namespaces", entryPageUrl<hdoc::types::NamespaceSymbol>(topLevel));
+  appendLink("Records", entryPageUrl<hdoc::types::RecordSymbol>(topLevel));
+  appendLink("Enums", entryPageUrl<hdoc::types::EnumSymbol>(topLevel));
+  appendLink("Functions", entryPageUrl<hdoc::types::FunctionSymbol>(topLevel));
+  appendLink("Aliases", entryPageUrl<hdoc::types::AliasSymbol>(topLevel));
 }
 
-/// Create a new HTML page with standard structure
-/// Optional sidebar, CSS styling, favicons, footer, etc.
-static void printNewPage(const hdoc::types::Config&   cfg,
-                         CTML::Node                   main,
-                         const std::filesystem::path& path,
-                         const std::string_view       pageTitle,
-                         CTML::Node                   breadcrumbs = CTML::Node(),
-                         bool topLevel = false) {
-  CTML::Document html;
-
-  // create path directories if they don't exist
-  std::filesystem::create_directories(path.parent_path());
-
-  if(!cfg.minimalOutput) {
-
-    std::string dirPrefix = topLevel ? "" : "../";
-
-    // Create the header, which includes Bulma CSS framework
-    html.AppendNodeToHead(CTML::Node("meta").SetAttr("charset", "utf-8"));
-    html.AppendNodeToHead(
-        CTML::Node("meta").SetAttr("name", "viewport").SetAttr("content", "width=device-width, initial-scale=1"));
-    html.AppendNodeToHead(CTML::Node("title", std::string(pageTitle)));
-
-    // Use our custom css which is a modified version of bulma
-    html.AppendNodeToHead(CTML::Node("link").SetAttr("rel", "stylesheet").SetAttr("href", dirPrefix + "styles.css"));
-
-    // highlight.js scripts
-    html.AppendNodeToHead(CTML::Node("script").SetAttr("src", dirPrefix + "highlight.min.js"));
-    html.AppendNodeToHead(CTML::Node("script", "hljs.highlightAll();"));
-
-    // KaTeX configuration
-    html.AppendNodeToHead(CTML::Node("link").SetAttr("rel", "stylesheet").SetAttr("href", dirPrefix + "katex.min.css"));
-    html.AppendNodeToHead(CTML::Node("script").SetAttr("src", dirPrefix + "katex.min.js"));
-    html.AppendNodeToHead(CTML::Node("script").SetAttr("src", dirPrefix + "auto-render.min.js"));
-    const char* katexConfiguration = R"(
+/// Buffers that a thread reuses for every page it prints, so that printing a page doesn't allocate once they've
+/// grown to the size of the largest page.
+struct PageBuffers {
+  std::string content;     ///< Contents of the page's <main> element
+  std::string breadcrumbs; ///< Breadcrumbs shown above the contents
+};
+
+/// Get the PageBuffers of this thread, with the contents and breadcrumbs of the previous page cleared.
+/// Only pages printed by the thread pool use them, the overview pages use their own strings.
+static PageBuffers& getPageBuffers() {
+  static thread_local PageBuffers buffers;
+  buffers.content.clear();
+  buffers.breadcrumbs.clear();
+  return buffers;
+}
+
+/// Append the navigation links of the sidebar, for a page in the output directory if topLevel is true and for a
+/// page in one of its subdirectories otherwise
+static void appendSidebar(hdoc::utils::HTMLStream& html, const hdoc::types::Config& cfg, const bool topLevel) {
+  const std::string dirPrefix = topLevel ? "" : "../";
+
+  html.open({"ul", "menu-list"});
+  html.element({"p", "is-size-4"}, cfg.projectName + (cfg.projectVersion == "" ? "" : " " + cfg.projectVersion));
+  html.element({"p", "menu-label"}, "Navigation");
+  html.open({"li"}).element({"a"}, "Home", {{"href", dirPrefix + "index.html"}}).close({"li"});
+  html.open({"li"}).element({"a"}, "Search", {{"href", dirPrefix + "search.html"}}).close({"li"});
+  if (cfg.gitRepoURL != "") {
+    html.open({"li"}).element({"a"}, "Repository", {{"href", cfg.gitRepoURL}}).close({"li"});
+  }
+
+  // Add paths to markdown pages converted to HTML, if any were provided
+  if (cfg.mdPaths.size() > 0) {
+    html.element({"p", "menu-label"}, "Pages");
+    for (const auto& f : cfg.mdPaths) {
+      std::string path = "doc" + f.filename().replace_extension("html").string();
+      std::string name = f.filename().stem().string();
+      html.open({"li"}).element({"a"}, name, {{"href", dirPrefix + path}}).close({"li"});
+    }
+  }
+
+  // Add links to all of the standard sections
+  html.element({"p", "menu-label"}, "API Documentation");
+  appendEntryPageLinks(html, topLevel);
+  html.close({"ul"});
+}
+
+/// Append the contents of the footer, with creation date and details
+static void appendFooter(hdoc::utils::HTMLStream& html, const hdoc::types::Config& cfg) {
+  html.element({"p"},
+               "Documentation for " + cfg.projectName +
+                   (cfg.projectVersion == "" ? "." : " " + cfg.projectVersion + "."));
+  html.open({"p"}).text("Generated by ");
+  html.open({"a"}, {{"href", "https://github.com/PeterTh/hdoc"}}).raw("&#129388;doc").close({"a"});
+  html.text(" version " + cfg.hdocVersion + " on " + cfg.timestamp + ".").close({"p"});
+  html.element({"p", "has-text-grey-light"}, "19AD43E11B2996");
+}
+
+/// Render the layout that every page at one directory depth shares: the header with scripts and favicons, the
+/// sidebar, and the footer. Only the title, breadcrumbs and contents differ between pages, so they're left out.
+static hdoc::serde::PageChrome renderPageChrome(const hdoc::types::Config& cfg, const bool topLevel) {
+  hdoc::serde::PageChrome chrome;
+  const std::string       dirPrefix = topLevel ? "" : "../";
+
+  // Create the header, which includes Bulma CSS framework
+  hdoc::utils::HTMLStream head(chrome.head);
+  head.raw("<!DOCTYPE html>").open({"html"}).open({"head"});
+  head.voidElement({"meta"}, {{"charset", "utf-8"}});
+  head.voidElement({"meta"}, {{"name", "viewport"}, {"content", "width=device-width, initial-scale=1"}});
+  head.open({"title"});
+
+  hdoc::utils::HTMLStream html(chrome.sidebar);
+  html.close({"title"});
+
+  // Use our custom css which is a modified version of bulma
+  html.voidElement({"link"}, {{"rel", "stylesheet"}, {"href", dirPrefix + "styles.css"}});
+
+  // highlight.js scripts
+  html.open({"script"}, {{"src", dirPrefix + "highlight.min.js"}}).close({"script"});
+  html.element({"script"}, "hljs.highlightAll();");
+
+  // KaTeX configuration
+  html.voidElement({"link"}, {{"rel", "stylesheet"}, {"href", dirPrefix + "katex.min.css"}});
+  html.open({"script"}, {{"src", dirPrefix + "katex.min.js"}}).close({"script"});
+  html.open({"script"}, {{"src", dirPrefix + "auto-render.min.js"}}).close({"script"});
+  const char* katexConfiguration = R"(
       document.addEventListener("DOMContentLoaded", function() {
         renderMathInElement(document.body, {
           delimiters: [
@@ -175,87 +249,122 @@ static void printNewPage(const hdoc::types::Config&   cfg,
         });
       });
     )";
-    html.AppendNodeToHead(CTML::Node("script").AppendRawHTML(katexConfiguration));
-
-    // Favicons
-    html.AppendNodeToHead(CTML::Node("link")
-                              .SetAttr("rel", "apple-touch-icon")
-                              .SetAttr("sizes", "180x180")
-                              .SetAttr("href", dirPrefix + "apple-touch-icon.png"));
-    html.AppendNodeToHead(CTML::Node("link")
-                              .SetAttr("rel", "icon")
-                              .SetAttr("type", "image/png")
-                              .SetAttr("sizes", "32x32")
-                              .SetAttr("href", dirPrefix + "favicon-32x32.png"));
-    html.AppendNodeToHead(CTML::Node("link")
-                              .SetAttr("rel", "icon")
-                              .SetAttr("type", "image/png")
-                              .SetAttr("sizes", "16x16")
-                              .SetAttr("href", dirPrefix + "favicon-16x16.png"));
-
-    CTML::Node wrapperDiv   = CTML::Node("div#wrapper");
-    CTML::Node section      = CTML::Node("section.section");
-    CTML::Node containerDiv = CTML::Node("div.container");
-
-    // Create a sidebar with navigation links etc
-    auto columnsDiv = CTML::Node("div.columns");
-    auto mainColumn = CTML::Node("div.column").SetAttr("style", "overflow-x: auto");
-    auto aside      = CTML::Node("aside.column is-one-fifth");
-    auto menuUL     = CTML::Node("ul.menu-list");
-
-    menuUL.AddChild(CTML::Node("p.is-size-4", cfg.projectName + (cfg.projectVersion == "" ? "" : " " + cfg.projectVersion)));
-    menuUL.AddChild(CTML::Node("p.menu-label", "Navigation"));
-    menuUL.AddChild(CTML::Node("li").AddChild(CTML::Node("a", "Home").SetAttr("href", dirPrefix + "index.html")));
-    menuUL.AddChild(CTML::Node("li").AddChild(CTML::Node("a", "Search").SetAttr("href", dirPrefix + "search.html")));
-    if (cfg.gitRepoURL != "") {
-      menuUL.AddChild(CTML::Node("li").AddChild(CTML::Node("a", "Repository").SetAttr("href", cfg.gitRepoURL)));
-    }
+  html.open({"script"}).raw(katexConfiguration).close({"script"});
+
+  // Favicons
+  html.voidElement({"link"},
+                   {{"rel", "apple-touch-icon"}, {"sizes", "180x180"}, {"href", dirPrefix + "apple-touch-icon.png"}});
+  html.voidElement(
+      {"link"},
+      {{"rel", "icon"}, {"type", "image/png"}, {"sizes", "32x32"}, {"href", dirPrefix + "favicon-32x32.png"}});
+  html.voidElement(
+      {"link"},
+      {{"rel", "icon"}, {"type", "image/png"}, {"sizes", "16x16"}, {"href", dirPrefix + "favicon-16x16.png"}});
+
+  // The sidebar and footer are filled in by layout.js, which browsers only have to fetch once for the whole site
+  if (cfg.sharedLayout) {
+    html.open({"script"}, {{"src", dirPrefix + "layout.js"}, {"data-root", dirPrefix}, {"defer", ""}});
+    html.close({"script"});
+  }
+  html.close({"head"}).open({"body"});
+
+  html.open({"div"}, {{"id", "wrapper"}}).open({"section", "section"}).open({"div", "container"});
+
+  // Create a sidebar with navigation links etc
+  html.open({"div", "columns"});
+  if (cfg.sharedLayout) {
+    html.open({"aside", "column is-one-fifth"}, {{"id", "hdoc-sidebar"}}).close({"aside"});
+  } else {
+    html.open({"aside", "column is-one-fifth"});
+    appendSidebar(html, cfg, topLevel);
+    html.close({"aside"});
+  }
+  html.open({"div", "column"}, {{"style", "overflow-x: auto"}});
+
+  hdoc::utils::HTMLStream footer(chrome.footer);
+  footer.close({"div"}).close({"div"});
+  footer.close({"div"}).close({"section"}).close({"div"});
 
-    // Add paths to markdown pages converted to HTML, if any were provided
-    if (cfg.mdPaths.size() > 0) {
-      menuUL.AddChild(CTML::Node("p.menu-label", "Pages"));
-      for (const auto& f : cfg.mdPaths) {
-        std::string path = "doc" + f.filename().replace_extension("html").string();
-        std::string name = f.filename().stem().string();
-        menuUL.AddChild(CTML::Node("li").AddChild(CTML::Node("a", name).SetAttr("href", dirPrefix + path)));
+  // Create footer with creation date and details
+  if (cfg.sharedLayout) {
+    footer.open({"footer", "footer"}, {{"id", "hdoc-footer"}}).close({"footer"});
+  } else {
+    footer.open({"footer", "footer"});
+    appendFooter(footer, cfg);
+    footer.close({"footer"});
+  }
+  footer.close({"body"}).close({"html"});
+  return chrome;
+}
+
+/// Render layout.js, which fills in the sidebar and footer of every page when the shared layout is enabled.
+/// The links in the sidebar are relative to the output directory, so the script prefixes them with the path from
+/// the page to the output directory, which each page passes in the data-root attribute of its script tag.
+static std::string renderSharedLayout(const hdoc::types::Config& cfg) {
+  std::string             sidebar;
+  std::string             footer;
+  hdoc::utils::HTMLStream sidebarHTML(sidebar);
+  hdoc::utils::HTMLStream footerHTML(footer);
+  appendSidebar(sidebarHTML, cfg, true);
+  appendFooter(footerHTML, cfg);
+
+  const char* loader = R"(
+  const fill = function(id, html) {
+    const element = document.getElementById(id);
+    element.innerHTML = html;
+    element.querySelectorAll("a[href]").forEach(function(a) {
+      const href = a.getAttribute("href");
+      if (/^([a-z][a-z0-9+.-]*:|\/|#)/i.test(href) === false) {
+        a.setAttribute("href", root + href);
       }
-    }
+    });
+  };
+  fill("hdoc-sidebar", sidebar);
+  fill("hdoc-footer", footer);
+})();
+)";
+
+  std::string              js;
+  llvm::raw_string_ostream out(js);
+  out << "(function() {\n";
+  out << "  const root    = document.currentScript.dataset.root;\n";
+  out << "  const sidebar = " << llvm::json::Value(sidebar) << ";\n";
+  out << "  const footer  = " << llvm::json::Value(footer) << ";\n";
+  out << loader;
+  out.flush();
+  return js;
+}
 
-    // Add links to all of the standard sections
-    menuUL.AddChild(CTML::Node("p.menu-label", "API Documentation"));
-    appendEntryPageLinks(menuUL, topLevel);
-    aside.AddChild(menuUL);
-
-    columnsDiv.AddChild(aside);
-    columnsDiv.AddChild(mainColumn.AddChild(breadcrumbs).AddChild(main.SetAttr("class", "content")));
-    containerDiv.AddChild(columnsDiv);
-    section.AddChild(containerDiv);
-    wrapperDiv.AddChild(section);
-    html.AppendNodeToBody(wrapperDiv);
-
-    // Create footer with creation date and details
-    CTML::Node p1 = CTML::Node(
-        "p", "Documentation for " + cfg.projectName + (cfg.projectVersion == "" ? "." : " " + cfg.projectVersion + "."));
-    CTML::Node p2 = CTML::Node("p", "Generated by ")
-                        .AddChild(CTML::Node("a").SetAttr("href", "https://github.com/PeterTh/hdoc").AppendRawHTML("&#129388;doc"))
-                        .AppendText(" version " + cfg.hdocVersion + " on " + cfg.timestamp + ".");
-    CTML::Node p3 = CTML::Node("p.has-text-grey-light", "19AD43E11B2996");
-    html.AppendNodeToBody(CTML::Node("footer.footer").AddChild(p1).AddChild(p2).AddChild(p3));
-
-    // Dump to a file
-    std::ofstream(path) << html.ToString();
+/// Create a new HTML page with standard structure around content, which is the HTML inside of its <main> element
+/// Optional sidebar, CSS styling, favicons, footer, etc.
+void hdoc::serde::HTMLWriter::printNewPage(const std::string_view       content,
+                                           const std::filesystem::path& path,
+                                           const std::string_view       pageTitle,
+                                           const std::string_view       breadcrumbs,
+                                           const bool                   topLevel) const {
+  std::string             page = this->writer.takeBuffer();
+  hdoc::utils::HTMLStream html(page);
+
+  if (!this->cfg->minimalOutput) {
+    const PageChrome& chrome = topLevel ? this->topLevelChrome : this->nestedChrome;
+    html.raw(chrome.head).text(pageTitle).raw(chrome.sidebar).raw(breadcrumbs);
+    html.open({"main", "content"}).raw(content).close({"main"});
+    html.raw(chrome.footer);
   } else {
     // prevent breadcrumbs from showing if they are empty
     // (i.e. on top level pages or unsupported contexts - provide info in the latter case so that can be fixed)
-    std::string crumbsHTML = breadcrumbs.ToString();
-    if(crumbsHTML == "<></>") {
-      crumbsHTML = "";
-      if(!topLevel && path.filename() != "index.html") {
-        spdlog::warn("No breadcrumbs found for page '{}'", path.generic_string());
-      }
+    if(breadcrumbs.empty() && !topLevel && path.filename() != "index.html") {
+      spdlog::warn("No breadcrumbs found for page '{}'", path.generic_string());
     }
-    std::ofstream(path) << crumbsHTML << std::endl << main.ToString();
+    html.raw(breadcrumbs).raw("\n").open({"main"}).raw(content).close({"main"});
   }
+
+  // Hand the page off to the writer threads, which create its directory if needed
+  this->writer.write(path, std::move(page));
+}
+
+bool hdoc::serde::HTMLWriter::waitForPages() const {
+  return this->writer.closeArchive();
 }
 
 /// Return a short string describing a symbol for its entry in the overview list
@@ -415,173 +524,186 @@ std::string hdoc::serde::HTMLWriter::getHyperlinkedTypeName(const hdoc::types::T
   }
 }
 
-/// Returns an HTML node indicating where the s is declared.
-/// A hyperlink to the exact line in the source file (for GitHub and GitLab) is returned
+/// Prints where s is declared.
+/// A hyperlink to the exact line in the source file (for GitHub and GitLab) is printed
 /// if gitRepoURL is provided.
-static CTML::Node getDeclaredAtNode(const hdoc::types::Symbol& s,
-                                    const std::string_view     gitRepoURL       = "",
-                                    const std::string_view     gitDefaultBranch = "") {
-  auto p = CTML::Node("p", "Declared at: ");
+static void printDeclaredAt(hdoc::utils::HTMLStream&   html,
+                            const hdoc::types::Symbol& s,
+                            const std::string_view     gitRepoURL       = "",
+                            const std::string_view     gitDefaultBranch = "") {
+  const std::string location = s.file.str() + ":" + std::to_string(s.line);
+  html.open({"p"}).text("Declared at: ");
   if (gitRepoURL == "") {
-    return p.AddChild(CTML::Node("span.is-family-code", s.file + ":" + std::to_string(s.line)));
+    html.element({"span", "is-family-code"}, location);
   } else {
-    return p.AddChild(CTML::Node("a.is-family-code", s.file + ":" + std::to_string(s.line))
-                          .SetAttr("href",
-                                   std::string(gitRepoURL) + "blob/" + std::string(gitDefaultBranch) + "/" + s.file +
-                                       "#L" + std::to_string(s.line)));
+    html.element({"a", "is-family-code"},
+                 location,
+                 {{"href",
+                   std::string(gitRepoURL) + "blob/" + std::string(gitDefaultBranch) + "/" + s.file.str() + "#L" +
+                       std::to_string(s.line)}});
   }
+  html.close({"p"});
 }
 
-/// Creates a Bulma breadcrumb node to make the provenance of the current symbol more clear and aid in navigation.
-CTML::Node hdoc::serde::HTMLWriter::getBreadcrumbNode(const std::string&         prefix,
-                                                      const hdoc::types::Symbol& s,
-                                                      const hdoc::types::Index&  index) const {
+/// Prints a Bulma breadcrumb to make the provenance of the current symbol more clear and aid in navigation.
+void hdoc::serde::HTMLWriter::printBreadcrumbs(hdoc::utils::HTMLStream&   html,
+                                               const std::string&         prefix,
+                                               const hdoc::types::Symbol& s,
+                                               const hdoc::types::Index&  index) const {
   // Symbols that have no parents don't have any breadcrumbs.
   if (s.parentNamespaceID.raw() == 0) {
-    return CTML::Node();
+    return;
   }
 
-  auto nav = CTML::Node("nav.breadcrumb has-arrow-separator").SetAttr("aria-label", "breadcrumbs");
-  auto ul  = CTML::Node("ul");
-
   struct ParentSymbol {
-    std::string         symbolType;
-    hdoc::types::Symbol symbol;
+    std::string_view           symbolType;
+    const hdoc::types::Symbol* symbol;
   };
 
   // Construct a LIFO stack of parents for the current symbol.
   // LIFO is used because we need to print the nodes into HTML in reverse order.
-  std::stack<ParentSymbol> stack;
-  hdoc::types::Symbol      parent = s;
+  std::stack<ParentSymbol>   stack;
+  const hdoc::types::Symbol* parent = &s;
   while (true) {
-    if (index.namespaces.contains(parent.parentNamespaceID)) {
-      const auto& newParent = index.namespaces.entries.at(parent.parentNamespaceID);
-      stack.push({"namespace", newParent});
-      parent = newParent;
-    } else if (index.records.contains(parent.parentNamespaceID)) {
-      const auto& newParent = index.records.entries.at(parent.parentNamespaceID);
-      stack.push({newParent.type, newParent});
-      parent = newParent;
+    if (index.namespaces.contains(parent->parentNamespaceID)) {
+      const auto& newParent = index.namespaces.entries.at(parent->parentNamespaceID);
+      stack.push({"namespace", &newParent});
+      parent = &newParent;
+    } else if (index.records.contains(parent->parentNamespaceID)) {
+      const auto& newParent = index.records.entries.at(parent->parentNamespaceID);
+      stack.push({newParent.type, &newParent});
+      parent = &newParent;
     } else {
       break;
     }
   }
 
-  // Create the HTML nodes for the parent symbols of the current node.
+  html.open({"nav", "breadcrumb has-arrow-separator"}, {{"aria-label", "breadcrumbs"}}).open({"ul"});
+
+  // Print the parent symbols of the current symbol.
   while (!stack.empty()) {
     const auto parent = stack.top();
     stack.pop();
 
-    auto li = CTML::Node("li");
-    auto a  = CTML::Node();
+    std::string href;
     if (parent.symbolType == "namespace") {
-      a = CTML::Node("a").SetAttr("href", entryPageUrl<hdoc::types::NamespaceSymbol>(false) + "#" + parent.symbol.ID.str());
+      href = entryPageUrl<hdoc::types::NamespaceSymbol>(false) + "#" + parent.symbol->ID.str();
     } else {
-      a = CTML::Node("a").SetAttr("href", getURLForSymbol(parent.symbol.ID, true));
+      href = getURLForSymbol(parent.symbol->ID, true);
     }
-    auto span = CTML::Node("span", parent.symbolType + " " + parent.symbol.name);
-
-    ul.AddChild(li.AddChild(a.AddChild(span)));
+    html.open({"li"}).open({"a"}, {{"href", href}});
+    html.open({"span"}).text(parent.symbolType).text(" ").text(parent.symbol->name).close({"span"});
+    html.close({"a"}).close({"li"});
   }
 
   // Add the final breadcrumb, which is the actual symbol itself.
-  auto li   = CTML::Node("li.is-active");
-  auto a    = CTML::Node("a").SetAttr("aria-current", "page" + s.ID.str());
-  auto span = CTML::Node("span", prefix + " " + s.name);
-  ul.AddChild(li.AddChild(a.AddChild(span)));
+  html.open({"li", "is-active"}).open({"a"}, {{"aria-current", "page" + s.ID.str()}});
+  html.open({"span"}).text(prefix).text(" ").text(s.name).close({"span"});
+  html.close({"a"}).close({"li"});
 
-  return nav.AddChild(ul);
+  html.close({"ul"}).close({"nav"});
 }
 
-void appendAsMarkdown(const std::string comment, CTML::Node& node) {
+void appendAsMarkdown(const std::string& comment, hdoc::utils::HTMLStream& html) {
   if (comment != "") {
     hdoc::utils::MarkdownConverter converter(comment);
-    auto htmlstring = converter.getHTMLString();
+    const std::string& htmlstring = converter.getHTMLString();
     if(!htmlstring.empty()) {
-      node.AddChild(CTML::Node("p").AppendRawHTML(htmlstring));
+      html.open({"p"}).raw(htmlstring).close({"p"});
     } else {
-      node.AddChild(CTML::Node("p", comment));
+      html.element({"p"}, comment);
     }
   }
 }
 
-/// Print a function to main
+/// Print template parameters (with type, name, default value, and comment) as a list
+/// The type is escaped if escapeType is true, and printed as raw HTML otherwise
+static void printTemplateParams(hdoc::utils::HTMLStream&                       html,
+                                const std::vector<hdoc::types::TemplateParam>& templateParams,
+                                const bool                                     escapeType) {
+  html.open({"dl"});
+  for (const auto& tparam : templateParams) {
+    html.open({"dt", "is-family-code"});
+    if (escapeType) {
+      html.text(tparam.type);
+    } else {
+      html.raw(tparam.type);
+    }
+    html.open({"b"}).text(" ").text(tparam.name).close({"b"});
+
+    if (tparam.defaultValue != "") {
+      html.text(" = ").text(tparam.defaultValue);
+    }
+    html.close({"dt"});
+    if (tparam.docComment != "") {
+      html.element({"dd"}, tparam.docComment);
+    }
+  }
+  html.close({"dl"});
+}
+
+/// Print a function to html
 void hdoc::serde::HTMLWriter::printFunction(const hdoc::types::FunctionSymbol& f,
-                                            CTML::Node&                        main,
+                                            hdoc::utils::HTMLStream&           html,
                                             const std::string_view             gitRepoURL,
                                             const std::string_view             gitDefaultBranch) const {
   // Print function return type, name, and parameters as section header
-  std::string proto = getHyperlinkedFunctionProto(hdoc::serde::clangFormat(f.proto), f);
-  auto        inner = CTML::Node("code.hdoc-function-code.language-cpp").AppendRawHTML(proto);
-  main.AddChild(CTML::Node("h3#" + f.ID.str())
-                    .AddChild(CTML::Node("pre.p-0.hdoc-pre-parent")
-                                  .AddChild(CTML::Node("a.is-size-4", "¶")
-                                                .SetAttr("class", "hdoc-permalink-icon")
-                                                .SetAttr("href", "#" + f.ID.str()))
-                                  .AddChild(inner)));
+  const std::string id    = f.ID.str();
+  const std::string proto = getHyperlinkedFunctionProto(hdoc::serde::clangFormat(f.proto), f);
+  html.open({"h3"}, {{"id", id}}).open({"pre", "p-0 hdoc-pre-parent"});
+  html.element({"a", "hdoc-permalink-icon"}, "¶", {{"href", "#" + id}});
+  html.open({"code", "hdoc-function-code language-cpp"}).raw(proto).close({"code"});
+  html.close({"pre"}).close({"h3"});
 
   // Print function description only if there's an associated comment
   if (f.briefComment != "" || f.docComment != "") {
-    main.AddChild(CTML::Node("h4", "Description"));
+    html.element({"h4"}, "Description");
   }
-  appendAsMarkdown(f.briefComment, main);
-  appendAsMarkdown(f.docComment, main);
+  appendAsMarkdown(f.briefComment, html);
+  appendAsMarkdown(f.docComment, html);
 
-  main.AddChild(getDeclaredAtNode(f, gitRepoURL, gitDefaultBranch));
+  printDeclaredAt(html, f, gitRepoURL, gitDefaultBranch);
 
   // Print function template parameters (with type, name, default value, and comment) as a list
   if (f.templateParams.size() > 0) {
-    main.AddChild(CTML::Node("h4", "Template Parameters"));
-    CTML::Node dl("dl");
-
-    for (auto tparam : f.templateParams) {
-      auto dt = CTML::Node("dt.is-family-code").AppendRawHTML(escapeForHTML(tparam.type));
-      dt.AddChild(CTML::Node("b", " " + tparam.name));
-
-      if (tparam.defaultValue != "") {
-        dt.AppendText(" = " + tparam.defaultValue);
-      }
-      dl.AddChild(dt);
-      if (tparam.docComment != "") {
-        dl.AddChild(CTML::Node("dd", tparam.docComment));
-      }
-    }
-    main.AddChild(dl);
+    html.element({"h4"}, "Template Parameters");
+    printTemplateParams(html, f.templateParams, true);
   }
 
   // Print function parameters (with type, name, default value, and comment) as a list
   if (f.params.size() > 0) {
-    main.AddChild(CTML::Node("h4", "Parameters"));
-    CTML::Node dl("dl");
+    html.element({"h4"}, "Parameters");
+    html.open({"dl"});
 
-    for (auto param : f.params) {
-      auto dt = CTML::Node("dt.is-family-code").AppendRawHTML(getHyperlinkedTypeName(param.type));
-      dt.AddChild(CTML::Node("b", " " + param.name));
+    for (const auto& param : f.params) {
+      html.open({"dt", "is-family-code"}).raw(getHyperlinkedTypeName(param.type));
+      html.open({"b"}).text(" ").text(param.name).close({"b"});
 
       if (param.defaultValue != "") {
-        dt.AppendText(" = " + param.defaultValue);
+        html.text(" = ").text(param.defaultValue);
       }
-      dl.AddChild(dt);
+      html.close({"dt"});
       if (param.docComment != "") {
-        dl.AddChild(CTML::Node("dd", param.docComment));
+        html.element({"dd"}, param.docComment);
       }
     }
-    main.AddChild(dl);
+    html.close({"dl"});
   }
 
   // Return value description
   if (f.returnTypeDocComment != "") {
-    main.AddChild(CTML::Node("h4", "Returns"));
-    main.AddChild(CTML::Node("p", f.returnTypeDocComment));
+    html.element({"h4"}, "Returns");
+    html.element({"p"}, f.returnTypeDocComment);
   }
 
-  main.AddChild(CTML::Node("hr.member-fun-separator"));
+  html.voidElement({"hr", "member-fun-separator"});
 }
 
 /// Print all of the functions that aren't record members in a project
 void hdoc::serde::HTMLWriter::printFunctions() const {
-  CTML::Node main("main");
-  main.AddChild(CTML::Node("h1", "Functions"));
+  std::string             content;
+  hdoc::utils::HTMLStream html(content);
+  html.element({"h1"}, "Functions");
 
   // get and sort the list of freestanding function groups
   std::vector<types::FreestandingFunctionID> sortedFunctionGroups;
@@ -599,149 +721,129 @@ void hdoc::serde::HTMLWriter::printFunctions() const {
   });
 
   // Print a bullet list of functions
-  uint64_t   numFunctions = 0; // Number of functions that aren't methods
-  CTML::Node ul("ul");
+  html.element({"h2"}, "Overview");
+  if (sortedFunctionGroups.size() == 0) {
+    html.element({"p"}, "No functions were declared in this project.");
+  } else {
+    html.open({"ul"});
+  }
   for (const auto& id : sortedFunctionGroups) {
     const auto& funs = this->index->freestandingFunctions.at(id);
-    numFunctions += 1;
-    auto li = CTML::Node("li")
-                    .AddChild(CTML::Node("a.is-family-code", id.name).SetAttr("href", getFunctionGroupURL(id, true)))
-                    .AppendText(getSymbolBlurb(funs, *this->index));
-    if (funs.isDetail) li.ToggleClass("hdoc-detail");
-    ul.AddChild(li);
-    CTML::Node page("main");
-    this->pool.async(
-        [&](const hdoc::types::FreestandingFunction& func, CTML::Node pg) {
-          for (const auto individualFunctionID : func.functionIDs) {
-            printFunction(this->index->functions.entries.at(individualFunctionID),
-                          pg,
-                          this->cfg->gitRepoURL,
-                          this->cfg->gitDefaultBranch);
-          }
-          // use first symbol for breadcrumb, it doesn't matter
-          const auto firstSymbol = this->index->functions.entries.at(func.functionIDs.front());
-          printNewPage(*this->cfg,
-                       pg,
-                       this->cfg->outputDir / getFunctionGroupURL(id, false),
-                       "function " + id.name + ": " + this->cfg->getPageTitleSuffix(),
-                       getBreadcrumbNode("function", firstSymbol, *this->index));
-        },
-        funs,
-        page);
+    html.open({"li"}, {}, funs.isDetail ? "hdoc-detail" : "");
+    html.element({"a", "is-family-code"}, id.name, {{"href", getFunctionGroupURL(id, true)}});
+    html.text(getSymbolBlurb(funs, *this->index)).close({"li"});
+    this->pool.async([this, &id, &funs]() {
+      PageBuffers&            buffers = getPageBuffers();
+      hdoc::utils::HTMLStream page(buffers.content);
+      for (const auto individualFunctionID : funs.functionIDs) {
+        printFunction(this->index->functions.entries.at(individualFunctionID),
+                      page,
+                      this->cfg->gitRepoURL,
+                      this->cfg->gitDefaultBranch);
+      }
+      // use first symbol for breadcrumb, it doesn't matter
+      const auto&             firstSymbol = this->index->functions.entries.at(funs.functionIDs.front());
+      hdoc::utils::HTMLStream breadcrumbs(buffers.breadcrumbs);
+      printBreadcrumbs(breadcrumbs, "function", firstSymbol, *this->index);
+      this->printNewPage(buffers.content,
+                         this->cfg->outputDir / getFunctionGroupURL(id, false),
+                         "function " + id.name + ": " + this->cfg->getPageTitleSuffix(),
+                         buffers.breadcrumbs);
+    });
+  }
+  if (sortedFunctionGroups.size() > 0) {
+    html.close({"ul"});
   }
   this->pool.wait();
-  main.AddChild(CTML::Node("h2", "Overview"));
-  if (numFunctions == 0) {
-    main.AddChild(CTML::Node("p", "No functions were declared in this project."));
-  } else {
-    main.AddChild(ul);
-  }
-  printNewPage(*this->cfg,
-               main,
-               this->cfg->outputDir / entryPageUrl<types::FunctionSymbol>(true),
-               "Functions: " + this->cfg->getPageTitleSuffix());
+  this->printNewPage(content,
+                     this->cfg->outputDir / entryPageUrl<types::FunctionSymbol>(true),
+                     "Functions: " + this->cfg->getPageTitleSuffix());
 }
 
 static std::string getAliasHTML(const hdoc::types::AliasSymbol& a) {
-  auto str = fmt::format("{} = {};", a.proto, a.target.name);
+  auto str = fmt::format("{} = {};", a.proto, a.target.name.str());
   str = hdoc::serde::clangFormat(str);
   str = escapeForHTML(str);
   return str;
 }
 
-/// Print an alias to main
+/// Print an alias to html
 void hdoc::serde::HTMLWriter::printAlias(const hdoc::types::AliasSymbol& a,
-                                         CTML::Node&                     main,
+                                         hdoc::utils::HTMLStream&        html,
                                          const std::string_view          gitRepoURL,
                                          const std::string_view          gitDefaultBranch) const {
-  auto        inner = CTML::Node("code.hdoc-function-code.language-cpp").AppendRawHTML(getAliasHTML(a));
-  main.AddChild(CTML::Node("h3#" + a.ID.str())
-                    .AddChild(CTML::Node("pre.p-0.hdoc-pre-parent")
-                                  .AddChild(CTML::Node("a.is-size-4", "¶")
-                                                .SetAttr("class", "hdoc-permalink-icon")
-                                                .SetAttr("href", "#" + a.ID.str()))
-                                  .AddChild(inner)));
+  const std::string id = a.ID.str();
+  html.open({"h3"}, {{"id", id}}).open({"pre", "p-0 hdoc-pre-parent"});
+  html.element({"a", "hdoc-permalink-icon"}, "¶", {{"href", "#" + id}});
+  html.open({"code", "hdoc-function-code language-cpp"}).raw(getAliasHTML(a)).close({"code"});
+  html.close({"pre"}).close({"h3"});
 
   // Print description only if there's an associated comment
   if (a.briefComment != "" || a.docComment != "") {
-    main.AddChild(CTML::Node("h4", "Description"));
+    html.element({"h4"}, "Description");
   }
-  appendAsMarkdown(a.briefComment, main);
-  appendAsMarkdown(a.docComment, main);
+  appendAsMarkdown(a.briefComment, html);
+  appendAsMarkdown(a.docComment, html);
 
-  main.AddChild(getDeclaredAtNode(a, gitRepoURL, gitDefaultBranch));
+  printDeclaredAt(html, a, gitRepoURL, gitDefaultBranch);
 
   // Print template parameters (with type, name, default value, and comment) as a list
-  // TODO this is duplicated from printRecord()
   if (a.templateParams.size() > 0) {
-    main.AddChild(CTML::Node("h2", "Template Parameters"));
-    CTML::Node dl("dl");
-
-    for (auto tparam : a.templateParams) {
-      auto dt = CTML::Node("dt.is-family-code").AppendRawHTML(tparam.type);
-      dt.AddChild(CTML::Node("b", " " + tparam.name));
-
-      if (tparam.defaultValue != "") {
-        dt.AppendText(" = " + tparam.defaultValue);
-      }
-      dl.AddChild(dt);
-      if (tparam.docComment != "") {
-        dl.AddChild(CTML::Node("dd", tparam.docComment));
-      }
-    }
-    main.AddChild(dl);
+    html.element({"h2"}, "Template Parameters");
+    printTemplateParams(html, a.templateParams, false);
   }
 
   // If we have a symbol, link it
   if (a.target.id.raw() != 0) {
-    main.AddChild(CTML::Node("h4", "Target"));
-    main.AddChild(CTML::Node("p", "The target of this alias is ").AppendRawHTML(getHyperlinkedTypeName(a.target)));
+    html.element({"h4"}, "Target");
+    html.open({"p"}).text("The target of this alias is ").raw(getHyperlinkedTypeName(a.target)).close({"p"});
   }
 }
 
 /// Print all of the aliases that aren't record members in a project
 void hdoc::serde::HTMLWriter::printAliases() const {
-  CTML::Node main("main");
-  main.AddChild(CTML::Node("h1", "Aliases"));
+  std::string             content;
+  hdoc::utils::HTMLStream html(content);
+  html.element({"h1"}, "Aliases");
 
-  // Print a bullet list of usings
-  uint64_t   numUsings = 0; // Number of usings that aren't methods
-  CTML::Node ul("ul");
+  std::vector<hdoc::types::SymbolID> ids;
   for (const auto& id : getSortedIDs(map2vec(this->index->aliases), this->index->aliases)) {
-    const auto& u = this->index->aliases.entries.at(id);
-    if (u.isRecordMember) {
-      continue;
+    if (this->index->aliases.entries.at(id).isRecordMember == false) {
+      ids.emplace_back(id);
     }
-    numUsings += 1;
-    auto li = CTML::Node("li")
-                    .AddChild(CTML::Node("a.is-family-code", u.name).SetAttr("href", u.relativeUrl()))
-                    .AppendText(getSymbolBlurb(u));
-    if (u.isDetail) li.ToggleClass("hdoc-detail");
-    ul.AddChild(li);
-    CTML::Node page("main");
-    this->pool.async(
-        [&](const hdoc::types::AliasSymbol& alias, CTML::Node pg) {
-          printAlias(alias, pg, this->cfg->gitRepoURL, this->cfg->gitDefaultBranch);
-          printNewPage(*this->cfg,
-                       pg,
-                       this->cfg->outputDir / alias.url(),
-                       "alias " + alias.name + ": " + this->cfg->getPageTitleSuffix(),
-                       getBreadcrumbNode("alias", alias, *this->index));
-        },
-        u,
-        page);
   }
-  this->pool.wait();
-  main.AddChild(CTML::Node("h2", "Overview"));
-  if (numUsings == 0) {
-    main.AddChild(CTML::Node("p", "No namespace-level aliases were declared in this project."));
+
+  // Print a bullet list of usings
+  html.element({"h2"}, "Overview");
+  if (ids.size() == 0) {
+    html.element({"p"}, "No namespace-level aliases were declared in this project.");
   } else {
-    main.AddChild(ul);
+    html.open({"ul"});
   }
-  printNewPage(*this->cfg,
-               main,
-               this->cfg->outputDir / entryPageUrl<types::AliasSymbol>(true),
-               "Aliases: " + this->cfg->getPageTitleSuffix());
+  for (const auto& id : ids) {
+    const auto& u = this->index->aliases.entries.at(id);
+    html.open({"li"}, {}, u.isDetail ? "hdoc-detail" : "");
+    html.element({"a", "is-family-code"}, u.name, {{"href", u.relativeUrl()}});
+    html.text(getSymbolBlurb(u)).close({"li"});
+    this->pool.async([this, &u]() {
+      PageBuffers&            buffers = getPageBuffers();
+      hdoc::utils::HTMLStream page(buffers.content);
+      printAlias(u, page, this->cfg->gitRepoURL, this->cfg->gitDefaultBranch);
+      hdoc::utils::HTMLStream breadcrumbs(buffers.breadcrumbs);
+      printBreadcrumbs(breadcrumbs, "alias", u, *this->index);
+      this->printNewPage(buffers.content,
+                         this->cfg->outputDir / u.url(),
+                         "alias " + u.name + ": " + this->cfg->getPageTitleSuffix(),
+                         buffers.breadcrumbs);
+    });
+  }
+  if (ids.size() > 0) {
+    html.close({"ul"});
+  }
+  this->pool.wait();
+  this->printNewPage(content,
+                     this->cfg->outputDir / entryPageUrl<types::AliasSymbol>(true),
+                     "Aliases: " + this->cfg->getPageTitleSuffix());
 }
 
 static std::vector<hdoc::types::RecordSymbol::BaseRecord> getInheritedSymbols(const hdoc::types::Index*        index,
@@ -781,70 +883,71 @@ static std::vector<hdoc::types::RecordSymbol::BaseRecord> getInheritedSymbols(co
 }
 
 void hdoc::serde::HTMLWriter::printMemberVariables(const hdoc::types::RecordSymbol& c,
-                                                   CTML::Node&                      main,
+                                                   hdoc::utils::HTMLStream&         html,
                                                    const bool&                      isInherited) const {
-  CTML::Node dl("dl");
-  uint64_t   numVars = 0;
-
   // sort member variables by access level
-  std::vector<hdoc::types::MemberVariable> sortedVars = c.vars;
-  std::stable_sort(sortedVars.begin(), sortedVars.end(), [](const hdoc::types::MemberVariable& a, const hdoc::types::MemberVariable& b) {
-    return a.access < b.access;
-  });
-
-  for (const hdoc::types::MemberVariable& var : sortedVars) {
+  std::vector<const hdoc::types::MemberVariable*> sortedVars;
+  for (const hdoc::types::MemberVariable& var : c.vars) {
     if (isInherited == true && var.access == clang::AS_private) {
       continue;
     }
+    sortedVars.emplace_back(&var);
+  }
+  std::stable_sort(sortedVars.begin(),
+                   sortedVars.end(),
+                   [](const hdoc::types::MemberVariable* a, const hdoc::types::MemberVariable* b) {
+                     return a->access < b->access;
+                   });
+
+  if (sortedVars.size() == 0) {
+    return;
+  }
+  if (isInherited) {
+    html.open({"p"}).text("Inherited from ").element({"a"}, c.name, {{"href", c.relativeUrl()}}).text(":").close({"p"});
+  }
+
+  html.open({"dl"});
+  for (const hdoc::types::MemberVariable* var : sortedVars) {
+    std::string_view preamble = var->isStatic ? " static " : " ";
 
-    std::string preamble = var.isStatic ? " static " : " ";
+    std::string_view accessClass = "";
+    if(var->access == clang::AS_protected) accessClass = "hdoc-protected";
+    if(var->access == clang::AS_private) accessClass = "hdoc-private";
 
-    CTML::Node dt;
     // Print the access, type, name, and doc comment if it exists
     if (isInherited == false) {
-      dt     = CTML::Node("dt.is-family-code").AppendRawHTML(preamble + " " + getHyperlinkedTypeName(var.type) + " ");
-      auto b = CTML::Node("b", var.name);
-      dt.AddChild(b);
-      dt.SetAttr("id", "var_" + var.name);
+      html.open({"dt", "is-family-code"}, {{"id", "var_" + var->name}}, accessClass);
+      html.raw(preamble).raw(" ").raw(getHyperlinkedTypeName(var->type)).raw(" ");
+      html.element({"b"}, var->name);
     }
     // Inherited variables get a bullet point and link to the description in the parent record
     else {
-      dt = CTML::Node("dt.is-family-code");
-      const auto a =
-          CTML::Node("a", preamble).SetAttr("href", c.relativeUrl() + "#var_" + var.name).AddChild(CTML::Node("b", var.name));
-      dt.AddChild(a);
+      html.open({"dt", "is-family-code"}, {}, accessClass);
+      html.open({"a"}, {{"href", c.relativeUrl() + "#var_" + var->name}}).text(preamble);
+      html.element({"b"}, var->name).close({"a"});
     }
-    if (var.defaultValue != "") {
-      dt.AppendText(" = " + var.defaultValue);
+    if (var->defaultValue != "") {
+      html.text(" = ").text(var->defaultValue);
     }
+    html.close({"dt"});
 
-    if(var.access == clang::AS_protected) dt.ToggleClass("hdoc-protected");
-    if(var.access == clang::AS_private) dt.ToggleClass("hdoc-private");
-
-    dl.AddChild(dt);
-
-    if (isInherited == false && var.docComment != "") {
-      dl.AddChild(CTML::Node("dd", var.docComment));
+    if (isInherited == false && var->docComment != "") {
+      html.element({"dd"}, var->docComment);
     }
-
-    numVars += 1;
-  }
-
-  if (numVars > 0) {
-    if (isInherited) {
-      main.AddChild(CTML::Node("p", "Inherited from ")
-                        .AddChild(CTML::Node("a", c.name).SetAttr("href", c.relativeUrl()))
-                        .AppendText(":"));
-    }
-    main.AddChild(dl);
   }
+  html.close({"dl"});
 }
 
 /// Print a list of inherited methods for the given record, truncating the method declaration
-static void
-printInheritedMethods(const hdoc::types::Index* index, const hdoc::types::RecordSymbol& c, CTML::Node& main) {
-  auto ul = CTML::Node("ul");
+static void printInheritedMethods(const hdoc::types::Index*        index,
+                                  const hdoc::types::RecordSymbol& c,
+                                  hdoc::utils::HTMLStream&         html) {
+  if (c.methodIDs.size() == 0) {
+    return;
+  }
+  html.open({"p"}).text("Inherited from ").element({"a"}, c.name, {{"href", c.relativeUrl()}}).text(":").close({"p"});
 
+  html.open({"ul"});
   for (const auto& methodID : getSortedIDs(c.methodIDs, index->functions)) {
     const auto& f = index->functions.entries.at(methodID);
     // Skip private functions and ctors/dtors that aren't inherited
@@ -852,118 +955,103 @@ printInheritedMethods(const hdoc::types::Index* index, const hdoc::types::Record
       continue;
     }
 
-    const auto li = CTML::Node("li.is-family-code")
-                        .AddChild(CTML::Node("a", to_string(f.access) + " ")
-                                      .SetAttr("href", c.relativeUrl() + "#" + f.ID.str())
-                                      .AddChild(CTML::Node("b", f.name)));
-    ul.AddChild(li);
-  }
-
-  if (c.methodIDs.size() > 0) {
-    main.AddChild(
-        CTML::Node("p", "Inherited from ").AddChild(CTML::Node("a", c.name).SetAttr("href", c.relativeUrl())).AppendText(":"));
-    main.AddChild(ul);
+    html.open({"li", "is-family-code"}).open({"a"}, {{"href", c.relativeUrl() + "#" + f.ID.str()}});
+    html.text(to_string(f.access)).text(" ").element({"b"}, f.name);
+    html.close({"a"}).close({"li"});
   }
+  html.close({"ul"});
 }
 
-static CTML::Node printFunctionOverview(const std::vector<hdoc::types::SymbolID>& ids,
-                                        const hdoc::types::Index&                 index) {
-  CTML::Node ul("ul");
+static void printFunctionOverview(hdoc::utils::HTMLStream&                  html,
+                                  const std::vector<hdoc::types::SymbolID>& ids,
+                                  const hdoc::types::Index&                 index) {
+  html.open({"ul"});
   for (auto fnID : ids) {
-    const hdoc::types::FunctionSymbol m = index.functions.entries.at(fnID);
+    const hdoc::types::FunctionSymbol& m = index.functions.entries.at(fnID);
 
     // Divide up the full function declaration so its name can be bold in the HTML
     // and to reformat it for the overview list with trailing return type
-    const uint64_t    nameLen      = m.name.size();
-    const std::string templatePart = m.proto.substr(0, m.postTemplate);
-    std::string       retTypePart  = m.proto.substr(m.postTemplate, m.nameStart - m.postTemplate);
-    const std::string inlineMarker = "inline";
+    const std::string_view proto        = m.proto;
+    const uint64_t         nameLen      = m.name.size();
+    const std::string_view templatePart = proto.substr(0, m.postTemplate);
+    std::string            retTypePart  = m.proto.substr(m.postTemplate, m.nameStart - m.postTemplate);
+    const std::string      inlineMarker = "inline";
     if (retTypePart.starts_with(inlineMarker)) {
       retTypePart = retTypePart.substr(inlineMarker.size());
     }
     hdoc::utils::trim(retTypePart);
-    const std::string postName = m.proto.substr(m.nameStart + nameLen, m.proto.size() - m.nameStart - nameLen);
+    const std::string_view postName = proto.substr(m.nameStart + nameLen, proto.size() - m.nameStart - nameLen);
 
-    auto li = CTML::Node("li.is-family-code");
+    std::string_view accessClass = "";
+    if (m.access == clang::AS_private) accessClass = "hdoc-private";
+    if (m.access == clang::AS_protected) accessClass = "hdoc-protected";
+
+    html.open({"li", "is-family-code"}, {}, accessClass);
     if (!templatePart.empty())
-      li.AddChild(CTML::Node("span.hdoc-overview-template", templatePart)).AppendRawHTML("<br>");
-    li.AddChild(CTML::Node("a").SetAttr("href", "#" + m.ID.str()).AddChild(CTML::Node("b", m.name)));
-    li.AppendText(postName);
-    if (!retTypePart.empty()) li.AppendRawHTML(" &rarr; ").AppendText(retTypePart);
-    if (m.access == clang::AS_private) li.ToggleClass("hdoc-private");
-    if (m.access == clang::AS_protected) li.ToggleClass("hdoc-protected");
-    ul.AddChild(li);
-  }
-  return ul;
+      html.element({"span", "hdoc-overview-template"}, templatePart).voidElement({"br"});
+    html.open({"a"}, {{"href", "#" + m.ID.str()}}).element({"b"}, m.name).close({"a"});
+    html.text(postName);
+    if (!retTypePart.empty()) html.raw(" &rarr; ").text(retTypePart);
+    html.close({"li"});
+  }
+  html.close({"ul"});
 }
 
-/// Print a record to main
+/// Print a record to its own page
 void hdoc::serde::HTMLWriter::printRecord(const hdoc::types::RecordSymbol& c) const {
-  CTML::Node main("main");
+  PageBuffers&            buffers = getPageBuffers();
+  hdoc::utils::HTMLStream html(buffers.content);
 
   const std::string pageTitle = c.type + " " + c.name;
-  main.AddChild(CTML::Node("h1", pageTitle));
+  html.element({"h1"}, pageTitle);
 
   // Full declaration
-  main.AddChild(CTML::Node("h2", "Declaration"));
-  main.AddChild(CTML::Node("pre.p-0").AddChild(
-      CTML::Node("code.hdoc-record-code.language-cpp",
-                 hdoc::serde::clangFormat(c.proto, 70) + " { /* full declaration omitted */ };")));
+  html.element({"h2"}, "Declaration");
+  html.open({"pre", "p-0"});
+  html.open({"code", "hdoc-record-code language-cpp"});
+  html.text(hdoc::serde::clangFormat(c.proto, 70)).text(" { /* full declaration omitted */ };");
+  html.close({"code"}).close({"pre"});
 
   if (c.briefComment != "" || c.docComment != "") {
-    main.AddChild(CTML::Node("h2", "Description"));
+    html.element({"h2"}, "Description");
   }
-  appendAsMarkdown(c.briefComment, main);
-  appendAsMarkdown(c.docComment, main);
+  appendAsMarkdown(c.briefComment, html);
+  appendAsMarkdown(c.docComment, html);
 
-  main.AddChild(getDeclaredAtNode(c, this->cfg->gitRepoURL, this->cfg->gitDefaultBranch));
+  printDeclaredAt(html, c, this->cfg->gitRepoURL, this->cfg->gitDefaultBranch);
 
   // Base records
   uint64_t count = 0;
   if (c.baseRecords.size() > 0) {
-    auto baseP = CTML::Node("p", "Inherits from: ");
+    html.open({"p"}).text("Inherits from: ");
     for (const auto& baseRecord : c.baseRecords) {
       if (count > 0) {
-        baseP.AppendText(", ");
+        html.text(", ");
       }
       // Check if type is a string, indicating it's a std record that isn't in the DB
       if (this->index->records.contains(baseRecord.id) == false) {
-        baseP.AppendText(baseRecord.name);
+        html.text(baseRecord.name);
       } else {
         const auto& p = this->index->records.entries.at(baseRecord.id);
-        baseP.AddChild(CTML::Node("a", p.name).SetAttr("href", p.relativeUrl()));
+        html.element({"a"}, p.name, {{"href", p.relativeUrl()}});
       }
       count++;
     }
-    main.AddChild(baseP);
+    html.close({"p"});
   }
 
   // Print template parameters (with type, name, default value, and comment) as a list
   if (c.templateParams.size() > 0) {
-    main.AddChild(CTML::Node("h2", "Template Parameters"));
-    CTML::Node dl("dl");
-
-    for (auto tparam : c.templateParams) {
-      auto dt = CTML::Node("dt.is-family-code").AppendRawHTML(tparam.type);
-      dt.AddChild(CTML::Node("b", " " + tparam.name));
-
-      if (tparam.defaultValue != "") {
-        dt.AppendText(" = " + tparam.defaultValue);
-      }
-      dl.AddChild(dt);
-      if (tparam.docComment != "") {
-        dl.AddChild(CTML::Node("dd", tparam.docComment));
-      }
-    }
-    main.AddChild(dl);
+    html.element({"h2"}, "Template Parameters");
+    printTemplateParams(html, c.templateParams, false);
   }
 
   // Print regular member variables
   bool hasMemberVariableHeading = false;
   if (c.vars.size() > 0) {
-    main.AddChild(CTML::Node("h2", "Member Variables"));
+    html.element({"h2"}, "Member Variables");
     hasMemberVariableHeading = true;
-    printMemberVariables(c, main, false);
+    printMemberVariables(c, html, false);
   }
 
   // Print inherited member variables
@@ -971,55 +1059,55 @@ void hdoc::serde::HTMLWriter::printRecord(const hdoc::types::RecordSymbol& c) co
   for (const auto& base : inheritedRecords) {
     const auto& ic = this->index->records.entries.at(base.id);
     if (hasMemberVariableHeading == false && ic.vars.size() > 0) {
-      main.AddChild(CTML::Node("h2", "Member Variables"));
+      html.element({"h2"}, "Member Variables");
       hasMemberVariableHeading = true;
     }
-    printMemberVariables(ic, main, true);
+    printMemberVariables(ic, html, true);
   }
 
   // Print type aliases
   if(c.aliasIDs.size() > 0) {
-    main.AddChild(CTML::Node("h2", "Member Aliases"));
-    CTML::Node ul("ul");
+    html.element({"h2"}, "Member Aliases");
+    html.open({"ul"});
     for (const auto& aliasID : getSortedIDs(c.aliasIDs, this->index->aliases)) {
       const auto& a = this->index->aliases.entries.at(aliasID);
-      auto li = CTML::Node("li.is-family-code").AppendRawHTML(getAliasHTML(a));
-      if(a.access == clang::AS_private) li.ToggleClass("hdoc-private");
-      if(a.access == clang::AS_protected) li.ToggleClass("hdoc-protected");
-      ul.AddChild(li);
+      std::string_view accessClass = "";
+      if(a.access == clang::AS_private) accessClass = "hdoc-private";
+      if(a.access == clang::AS_protected) accessClass = "hdoc-protected";
+      html.open({"li", "is-family-code"}, {}, accessClass).raw(getAliasHTML(a)).close({"li"});
     }
-    main.AddChild(ul);
+    html.close({"ul"});
   }
 
   // Method overview in list form
   const auto& sortedMethodIDs          = getSortedIDs(c.methodIDs, this->index->functions);
   bool        hasMethodOverviewHeading = false;
   if (sortedMethodIDs.size() > 0) {
-    main.AddChild(CTML::Node("h2", "Member Function Overview"));
+    html.element({"h2"}, "Member Function Overview");
     hasMethodOverviewHeading = true;
-    main.AddChild(printFunctionOverview(sortedMethodIDs, *this->index));
+    printFunctionOverview(html, sortedMethodIDs, *this->index);
   }
 
   // Add inherited methods to the list
   for (const auto& base : inheritedRecords) {
     const auto& ic = this->index->records.entries.at(base.id);
     if (hasMethodOverviewHeading == false && c.methodIDs.size() > 0) {
-      main.AddChild(CTML::Node("h2", "Member Function Overview"));
+      html.element({"h2"}, "Member Function Overview");
       hasMethodOverviewHeading = true;
     }
-    printInheritedMethods(this->index, ic, main);
+    printInheritedMethods(this->index, ic, html);
   }
 
   // Hidden-friend function overview in list form
   const auto& sortedHiddenFriendIDs = getSortedIDs(c.hiddenFriendIDs, this->index->functions);
   if (sortedHiddenFriendIDs.size() > 0) {
-    main.AddChild(CTML::Node("h2", "Friend Function Overview"));
-    main.AddChild(printFunctionOverview(sortedHiddenFriendIDs, *this->index));
+    html.element({"h2"}, "Friend Function Overview");
+    printFunctionOverview(html, sortedHiddenFriendIDs, *this->index);
   }
 
   // List of methods with full information
   if (sortedMethodIDs.size() > 0) {
-    main.AddChild(CTML::Node("h2", "Member Functions"));
+    html.element({"h2"}, "Member Functions");
     for (const auto& methodID : sortedMethodIDs) {
       // TODO: get to the bottom of what's causing empty method decls to appear in Writer.hpp
       // For now this hack just avoids printing them, but this shouldn't be necessary
@@ -1027,70 +1115,69 @@ void hdoc::serde::HTMLWriter::printRecord(const hdoc::types::RecordSymbol& c) co
         continue;
       }
       printFunction(
-          this->index->functions.entries.at(methodID), main, this->cfg->gitRepoURL, this->cfg->gitDefaultBranch);
+          this->index->functions.entries.at(methodID), html, this->cfg->gitRepoURL, this->cfg->gitDefaultBranch);
     }
   }
 
   // List hidden friend functions with full information
   if (sortedHiddenFriendIDs.size() > 0) {
-    main.AddChild(CTML::Node("h2", "Friend Functions"));
+    html.element({"h2"}, "Friend Functions");
     for (const auto& friendID : sortedHiddenFriendIDs) {
       printFunction(
-          this->index->functions.entries.at(friendID), main, this->cfg->gitRepoURL, this->cfg->gitDefaultBranch);
+          this->index->functions.entries.at(friendID), html, this->cfg->gitRepoURL, this->cfg->gitDefaultBranch);
     }
   }
 
-  printNewPage(*this->cfg,
-               main,
-               this->cfg->outputDir / c.url(),
-               pageTitle + ": " + this->cfg->getPageTitleSuffix(),
-               getBreadcrumbNode(c.type, c, *this->index));
+  hdoc::utils::HTMLStream breadcrumbs(buffers.breadcrumbs);
+  printBreadcrumbs(breadcrumbs, c.type, c, *this->index);
+  this->printNewPage(buffers.content,
+                     this->cfg->outputDir / c.url(),
+                     pageTitle + ": " + this->cfg->getPageTitleSuffix(),
+                     buffers.breadcrumbs);
 }
 
 /// Print all of the records in a project
 void hdoc::serde::HTMLWriter::printRecords() const {
-  CTML::Node main("main");
-  main.AddChild(CTML::Node("h1", "Records"));
+  std::string             content;
+  hdoc::utils::HTMLStream html(content);
+  html.element({"h1"}, "Records");
 
   // List of all the records defined, with links to the individual record HTML
-  CTML::Node ul("ul");
-  for (const auto& id : getSortedIDs(map2vec(this->index->records), this->index->records)) {
-    const auto& c = this->index->records.entries.at(id);
-    auto li = CTML::Node("li")
-                    .AddChild(CTML::Node("a.is-family-code", c.type + " " + c.name).SetAttr("href", c.relativeUrl()))
-                    .AppendText(getSymbolBlurb(c));
-    if (c.isDetail) li.ToggleClass("hdoc-detail");
-    ul.AddChild(li);
-    this->pool.async([&](const hdoc::types::RecordSymbol& cls) { printRecord(cls); }, c);
-  }
-  this->pool.wait();
-  main.AddChild(CTML::Node("h2", "Overview"));
+  html.element({"h2"}, "Overview");
   if (this->index->records.entries.size() == 0) {
-    main.AddChild(CTML::Node("p", "No records were declared in this project."));
+    html.element({"p"}, "No records were declared in this project.");
   } else {
-    main.AddChild(ul);
+    html.open({"ul"});
+    for (const auto& id : getSortedIDs(map2vec(this->index->records), this->index->records)) {
+      const auto& c = this->index->records.entries.at(id);
+      html.open({"li"}, {}, c.isDetail ? "hdoc-detail" : "");
+      html.open({"a", "is-family-code"}, {{"href", c.relativeUrl()}}).text(c.type).text(" ").text(c.name).close({"a"});
+      html.text(getSymbolBlurb(c)).close({"li"});
+      this->pool.async([this, &c]() { printRecord(c); });
+    }
+    html.close({"ul"});
   }
-  printNewPage(*this->cfg,
-               main,
-               this->cfg->outputDir / entryPageUrl<types::RecordSymbol>(true),
-               "Records: " + this->cfg->getPageTitleSuffix());
+  this->pool.wait();
+  this->printNewPage(content,
+                     this->cfg->outputDir / entryPageUrl<types::RecordSymbol>(true),
+                     "Records: " + this->cfg->getPageTitleSuffix());
 }
 
 /// Recursively print an single namespace and all of its children
-/// Should be tail-call optimized
-CTML::Node hdoc::serde::HTMLWriter::printNamespace(const hdoc::types::NamespaceSymbol& ns) const {
+void hdoc::serde::HTMLWriter::printNamespace(hdoc::utils::HTMLStream&            html,
+                                             const hdoc::types::NamespaceSymbol& ns) const {
   // Base case: stop recursion when namespace has no further children
-  // and return an empty node, which will not be appended since we have a custom version of CTML
   if (ns.records.size() == 0 && ns.enums.size() == 0 && ns.namespaces.size() == 0 && ns.usings.size() == 0) {
-    return CTML::Node("");
+    return;
   }
 
-  auto enclosingDetails = CTML::Node("details");
-  enclosingDetails.AddChild(CTML::Node("summary.is-family-code#" + ns.ID.str(), ns.name));
-  if(!ns.isDetail) {
-    enclosingDetails.SetAttr("open", "true");
+  if (ns.isDetail) {
+    html.open({"details"});
+  } else {
+    html.open({"details"}, {{"open", "true"}});
   }
-  auto subUL = CTML::Node("ul");
+  html.element({"summary", "is-family-code"}, ns.name, {{"id", ns.ID.str()}});
+  html.open({"ul"});
 
   const std::vector<hdoc::types::SymbolID> childNamespaces = getSortedIDs(ns.namespaces, index->namespaces);
   const std::vector<hdoc::types::SymbolID> childRecords    = getSortedIDs(ns.records, index->records);
@@ -1098,176 +1185,178 @@ CTML::Node hdoc::serde::HTMLWriter::printNamespace(const hdoc::types::NamespaceS
   const std::vector<hdoc::types::SymbolID> childAliases    = getSortedIDs(ns.usings, index->aliases);
   const std::vector<hdoc::types::SymbolID> childFunctions  = getSortedIDs(ns.functions, index->functions);
 
+  // Print a link to a child symbol, labeled with its kind and name
+  const auto printChild = [&](const std::string_view kind, const std::string_view name, const std::string& url) {
+    html.open({"li", "is-family-code"}).open({"a"}, {{"href", url}}).text(kind).text(" ").text(name);
+    html.close({"a"}).close({"li"});
+  };
+
   for (const auto& childID : childNamespaces) {
-    if (index->namespaces.contains(childID == false)) {
+    if (index->namespaces.contains(childID) == false) {
       continue;
     }
-    auto childNode = printNamespace(index->namespaces.entries.at(childID));
-    subUL.AddChild(childNode);
+    printNamespace(html, index->namespaces.entries.at(childID));
   }
   for (const auto& childID : childRecords) {
-    if (index->records.contains(childID == false)) {
+    if (index->records.contains(childID) == false) {
       continue;
     }
-    const hdoc::types::RecordSymbol s = index->records.entries.at(childID);
-    subUL.AddChild(
-        CTML::Node("li.is-family-code").AddChild(CTML::Node("a", s.type + " " + s.name).SetAttr("href", s.relativeUrl())));
+    const hdoc::types::RecordSymbol& s = index->records.entries.at(childID);
+    printChild(s.type, s.name, s.relativeUrl());
   }
   for (const auto& childID : childEnums) {
-    if (index->enums.contains(childID == false)) {
+    if (index->enums.contains(childID) == false) {
       continue;
     }
-    const hdoc::types::EnumSymbol s = index->enums.entries.at(childID);
-    subUL.AddChild(
-        CTML::Node("li.is-family-code").AddChild(CTML::Node("a", s.type + " " + s.name).SetAttr("href", s.relativeUrl())));
+    const hdoc::types::EnumSymbol& s = index->enums.entries.at(childID);
+    printChild(s.type, s.name, s.relativeUrl());
   }
   for (const auto& childID : childAliases) {
-    if (index->aliases.contains(childID == false)) {
+    if (index->aliases.contains(childID) == false) {
       continue;
     }
-    const hdoc::types::AliasSymbol s = index->aliases.entries.at(childID);
-    subUL.AddChild(
-        CTML::Node("li.is-family-code").AddChild(CTML::Node("a", "using " + s.name).SetAttr("href", s.relativeUrl())));
+    const hdoc::types::AliasSymbol& s = index->aliases.entries.at(childID);
+    printChild("using", s.name, s.relativeUrl());
   }
   // Function groups in this namespace
   std::set<types::FreestandingFunctionID> alreadyIncludedGroups;
   for (const auto& childID : childFunctions) {
-    if (index->functions.contains(childID == false)) {
+    if (index->functions.contains(childID) == false) {
       continue;
     }
-    const hdoc::types::FunctionSymbol s = index->functions.entries.at(childID);
+    const hdoc::types::FunctionSymbol& s = index->functions.entries.at(childID);
     if (s.freestandingID == types::notFreeStanding || alreadyIncludedGroups.contains(s.freestandingID)) {
       continue;
     }
     alreadyIncludedGroups.insert(s.freestandingID);
-    subUL.AddChild(
-        CTML::Node("li.is-family-code").AddChild(CTML::Node("a", "function " + s.name).SetAttr("href", getFunctionGroupURL(s.freestandingID, true))));
+    printChild("function", s.name, getFunctionGroupURL(s.freestandingID, true));
   }
-  return enclosingDetails.AddChild(subUL);
+  html.close({"ul"}).close({"details"});
 }
 
 /// Print all of the namespaces in a project in a nice tree-view
 void hdoc::serde::HTMLWriter::printNamespaces() const {
-  CTML::Node main("main");
-  main.AddChild(CTML::Node("h1", "Namespaces"));
-
-  CTML::Node namespaceTree("ul");
+  std::string             content;
+  hdoc::utils::HTMLStream html(content);
+  html.element({"h1"}, "Namespaces");
 
-  for (const auto& id : getSortedIDs(map2vec(this->index->namespaces), this->index->namespaces)) {
-    const auto& ns = this->index->namespaces.entries.at(id);
-    // Only recurse root namespaces (that have no parents)
-    if (ns.parentNamespaceID.raw() != 0) {
-      continue;
-    }
-    namespaceTree.AddChild(printNamespace(ns));
-  }
   if (this->index->namespaces.entries.size() == 0) {
-    main.AddChild(CTML::Node("p", "No namespaces were declared in this project."));
+    html.element({"p"}, "No namespaces were declared in this project.");
   } else {
-    main.AddChild(namespaceTree);
+    html.open({"ul"});
+    for (const auto& id : getSortedIDs(map2vec(this->index->namespaces), this->index->namespaces)) {
+      const auto& ns = this->index->namespaces.entries.at(id);
+      // Only recurse root namespaces (that have no parents)
+      if (ns.parentNamespaceID.raw() != 0) {
+        continue;
+      }
+      printNamespace(html, ns);
+    }
+    html.close({"ul"});
   }
-  printNewPage(*this->cfg,
-               main,
-               this->cfg->outputDir / entryPageUrl<types::NamespaceSymbol>(true),
-               "Namespaces: " + this->cfg->getPageTitleSuffix());
+  this->printNewPage(content,
+                     this->cfg->outputDir / entryPageUrl<types::NamespaceSymbol>(true),
+                     "Namespaces: " + this->cfg->getPageTitleSuffix());
 }
 
-/// Print an enum to main
+/// Print an enum to its own page
 void hdoc::serde::HTMLWriter::printEnum(const hdoc::types::EnumSymbol& e) const {
-  CTML::Node        main("main");
+  PageBuffers&            buffers = getPageBuffers();
+  hdoc::utils::HTMLStream html(buffers.content);
+
   const std::string pageTitle = e.type + " " + e.name;
-  main.AddChild(CTML::Node("h1", pageTitle));
+  html.element({"h1"}, pageTitle);
 
   // Description
   if (e.briefComment != "" || e.docComment != "") {
-    main.AddChild(CTML::Node("h2", "Description"));
+    html.element({"h2"}, "Description");
   }
-  appendAsMarkdown(e.briefComment, main);
-  appendAsMarkdown(e.docComment, main);
+  appendAsMarkdown(e.briefComment, html);
+  appendAsMarkdown(e.docComment, html);
 
-  main.AddChild(getDeclaredAtNode(e, this->cfg->gitRepoURL, this->cfg->gitDefaultBranch));
+  printDeclaredAt(html, e, this->cfg->gitRepoURL, this->cfg->gitDefaultBranch);
 
   // Enum members in table format
-  main.AddChild(CTML::Node("h2", "Enumerators"));
+  html.element({"h2"}, "Enumerators");
   if (e.members.size() > 0) {
-    // Table and table header nodes
-    CTML::Node table("table.table is-narrow is-hoverable");
-    CTML::Node table_header_row("tr");
-    table_header_row.AddChild(CTML::Node("th", "Name"));
-    table_header_row.AddChild(CTML::Node("th", "Value"));
-    table_header_row.AddChild(CTML::Node("th", "Comment"));
-    table.AddChild(table_header_row);
+    // Table and table header
+    html.open({"table", "table is-narrow is-hoverable"});
+    html.open({"tr"});
+    html.element({"th"}, "Name");
+    html.element({"th"}, "Value");
+    html.element({"th"}, "Comment");
+    html.close({"tr"});
 
     // Table rows: one row per enum member
     for (const auto& member : e.members) {
-      CTML::Node table_row("tr");
-      table_row.AddChild(CTML::Node("td.is-family-code", member.name));
-      table_row.AddChild(CTML::Node("td.is-family-code", std::to_string(member.value)));
-      table_row.AddChild(CTML::Node("td", member.docComment));
-      table.AddChild(table_row);
+      html.open({"tr"});
+      html.element({"td", "is-family-code"}, member.name);
+      html.element({"td", "is-family-code"}, std::to_string(member.value));
+      html.element({"td"}, member.docComment);
+      html.close({"tr"});
     }
-    main.AddChild(table);
+    html.close({"table"});
   }
 
-  printNewPage(*this->cfg,
-               main,
-               this->cfg->outputDir / e.url(),
-               pageTitle + ": " + this->cfg->getPageTitleSuffix(),
-               getBreadcrumbNode(e.type, e, *this->index));
+  hdoc::utils::HTMLStream breadcrumbs(buffers.breadcrumbs);
+  printBreadcrumbs(breadcrumbs, e.type, e, *this->index);
+  this->printNewPage(buffers.content,
+                     this->cfg->outputDir / e.url(),
+                     pageTitle + ": " + this->cfg->getPageTitleSuffix(),
+                     buffers.breadcrumbs);
 }
 
 /// Print all of the enums in a project
 void hdoc::serde::HTMLWriter::printEnums() const {
-  CTML::Node main("main");
-  main.AddChild(CTML::Node("h1", "Enums"));
-
-  CTML::Node ul("ul");
-  for (const auto& id : getSortedIDs(map2vec(this->index->enums), this->index->enums)) {
-    const auto& e = this->index->enums.entries.at(id);
-    auto li = CTML::Node("li")
-                    .AddChild(CTML::Node("a.is-family-code", e.type + " " + e.name).SetAttr("href", e.relativeUrl()))
-                    .AppendText(getSymbolBlurb(e));
-    if (e.isDetail) li.ToggleClass("hdoc-detail");
-    ul.AddChild(li);
-    this->pool.async([&](const hdoc::types::EnumSymbol& en) { printEnum(en); }, e);
-  }
-  this->pool.wait();
-  main.AddChild(CTML::Node("h2", "Overview"));
+  std::string             content;
+  hdoc::utils::HTMLStream html(content);
+  html.element({"h1"}, "Enums");
+
+  html.element({"h2"}, "Overview");
   if (this->index->enums.entries.size() == 0) {
-    main.AddChild(CTML::Node("p", "No enums were declared in this project."));
+    html.element({"p"}, "No enums were declared in this project.");
   } else {
-    main.AddChild(ul);
+    html.open({"ul"});
+    for (const auto& id : getSortedIDs(map2vec(this->index->enums), this->index->enums)) {
+      const auto& e = this->index->enums.entries.at(id);
+      html.open({"li"}, {}, e.isDetail ? "hdoc-detail" : "");
+      html.open({"a", "is-family-code"}, {{"href", e.relativeUrl()}}).text(e.type).text(" ").text(e.name).close({"a"});
+      html.text(getSymbolBlurb(e)).close({"li"});
+      this->pool.async([this, &e]() { printEnum(e); });
+    }
+    html.close({"ul"});
   }
-  printNewPage(*this->cfg,
-               main,
-               this->cfg->outputDir / entryPageUrl<types::EnumSymbol>(true),
-               "Enums: " + this->cfg->getPageTitleSuffix());
+  this->pool.wait();
+  this->printNewPage(content,
+                     this->cfg->outputDir / entryPageUrl<types::EnumSymbol>(true),
+                     "Enums: " + this->cfg->getPageTitleSuffix());
 }
 
 void hdoc::serde::HTMLWriter::printSearchPage() const {
-  CTML::Node main("main");
+  std::string             content;
+  hdoc::utils::HTMLStream html(content);
 
-  main.AddChild(CTML::Node("h1", "Search"));
+  html.element({"h1"}, "Search");
   const auto noscriptTagText = R"(Search requires Javascript to be enabled.
 No data leaves your machine as part of the search process.
 We have left the Javascript code unminified so that you are able to inspect it yourself should you choose to do so.)";
-  main.AddChild(CTML::Node("noscript").AddChild(CTML::Node("p", noscriptTagText)));
-  const auto input = CTML::Node("input.input is-primary#search")
-                         .SetAttr("type", "search")
-                         .SetAttr("autocomplete", "off")
-                         .SetAttr("onkeyup", "updateSearchResults()")
-                         .SetAttr("style", "display: none");
-  main.AddChild(input);
-  main.AddChild(CTML::Node("div#loader").AddChild(CTML::Node("span.loader")));
-  main.AddChild(CTML::Node("p#info", "Loading index of all symbols. This may take time for large codebases."));
-  main.AddChild(CTML::Node("div.panel is-hoverable#results").SetAttr("style", "display: none"));
-  main.AddChild(CTML::Node("script").SetAttr("src", "index.min.js"));
-  main.AddChild(CTML::Node("script").SetAttr("src", "search.js"));
-  printNewPage(*this->cfg, main, this->cfg->outputDir / "search.html", "Search: " + this->cfg->getPageTitleSuffix());
-
-  std::error_code      ec;
-  llvm::raw_fd_ostream jsonPath((cfg->outputDir / "index.json").string(), ec);
-  llvm::json::OStream  json(jsonPath);
+  html.open({"noscript"}).element({"p"}, noscriptTagText).close({"noscript"});
+  html.voidElement({"input", "input is-primary"},
+                   {{"id", "search"},
+                    {"type", "search"},
+                    {"autocomplete", "off"},
+                    {"onkeyup", "updateSearchResults()"},
+                    {"style", "display: none"}});
+  html.open({"div"}, {{"id", "loader"}}).element({"span", "loader"}, "").close({"div"});
+  html.element({"p"}, "Loading index of all symbols. This may take time for large codebases.", {{"id", "info"}});
+  html.element({"div", "panel is-hoverable"}, "", {{"id", "results"}, {"style", "display: none"}});
+  html.element({"script"}, "", {{"src", "index.min.js"}});
+  html.element({"script"}, "", {{"src", "search.js"}});
+  this->printNewPage(content, this->cfg->outputDir / "search.html", "Search: " + this->cfg->getPageTitleSuffix());
+
+  std::string              searchIndex;
+  llvm::raw_string_ostream searchIndexStream(searchIndex);
+  llvm::json::OStream      json(searchIndexStream);
 
   json.array([&] {
     for (const auto& s : this->index->functions.entries)
@@ -1316,36 +1405,38 @@ We have left the Javascript code unminified so that you are able to inspect it y
       }
     }
   });
+  searchIndexStream.flush();
+  this->writer.write(this->cfg->outputDir / "index.json", std::move(searchIndex));
 }
 
 /// Print the homepage of the documentation
 void hdoc::serde::HTMLWriter::printProjectIndex() const {
-  CTML::Node main("main");
+  std::string             content;
+  hdoc::utils::HTMLStream html(content);
 
   // If index markdown page was supplied, convert it to markdown and print it
   if (this->cfg->homepage != "") {
     hdoc::utils::MarkdownConverter converter(this->cfg->homepage);
-    main = converter.getHTMLNode();
+    html.raw(converter.getHTMLString());
   }
   // Otherwise, create a simple page with links to the documentation
   else {
-    main.AddChild(CTML::Node("h1", this->cfg->getPageTitleSuffix()));
-    CTML::Node ul("ul");
-    appendEntryPageLinks(ul, true);
-    main.AddChild(ul);
+    html.element({"h1"}, this->cfg->getPageTitleSuffix());
+    html.open({"ul"});
+    appendEntryPageLinks(html, true);
+    html.close({"ul"});
   }
 
-  printNewPage(*this->cfg, main, this->cfg->outputDir / "index.html", this->cfg->getPageTitleSuffix(), CTML::Node(), true);
+  this->printNewPage(content, this->cfg->outputDir / "index.html", this->cfg->getPageTitleSuffix(), "", true);
 }
 
 void hdoc::serde::HTMLWriter::processMarkdownFiles() const {
   for (const auto& f : this->cfg->mdPaths) {
     spdlog::info("Processing markdown file {}", f.string());
     hdoc::utils::MarkdownConverter converter(f);
-    CTML::Node                     main      = converter.getHTMLNode();
     std::string                    filename  = "doc" + f.filename().replace_extension("html").string();
     std::string                    pageTitle = f.filename().stem().string();
-    printNewPage(*this->cfg, main, this->cfg->outputDir / filename, pageTitle, CTML::Node(), true);
+    this->printNewPage(converter.getHTMLString(), this->cfg->outputDir / filename, pageTitle, "", true);
   }
 }
 
@@ -1369,13 +1460,13 @@ std::string hdoc::serde::HTMLWriter::getNamespaceString(const hdoc::types::Symbo
 }
 
 std::string getRecordUrl(const hdoc::types::SymbolID& id, bool relative) {
-  return (relative?"../":"") + hdoc::types::RecordSymbol().directory() + "/" + id.str() + ".html";
+  return (relative?"../":"") + std::string(hdoc::types::RecordSymbol::directory()) + "/" + id.str() + ".html";
 };
 std::string getEnumURL(const hdoc::types::SymbolID& id, bool relative) {
-  return (relative?"../":"") + hdoc::types::EnumSymbol().directory() + "/" + id.str() + ".html";
+  return (relative?"../":"") + std::string(hdoc::types::EnumSymbol::directory()) + "/" + id.str() + ".html";
 };
 std::string getAliasURL(const hdoc::types::SymbolID& id, bool relative) {
-  return (relative?"../":"") + hdoc::types::AliasSymbol().directory() + "/" + id.str() + ".html";
+  return (relative?"../":"") + std::string(hdoc::types::AliasSymbol::directory()) + "/" + id.str() + ".html";
 };
 
 std::string hdoc::serde::HTMLWriter::getURLForSymbol(const hdoc::types::SymbolID& id, bool relative) const {
@@ -3,15 +3,28 @@
 
 #pragma once
 
-#include "ctml.hpp"
+#include <filesystem>
+#include <string>
+#include <string_view>
+
 #include "llvm/Support/ThreadPool.h"
 
+#include "support/AsyncFileWriter.hpp"
+#include "support/HTMLStream.hpp"
 #include "types/Config.hpp"
 #include "types/Index.hpp"
 
 namespace hdoc {
 namespace serde {
 
+/// @brief Layout shared by all pages in one directory, rendered once so that printing a page only adds its title,
+/// breadcrumbs, and contents.
+struct PageChrome {
+  std::string head;    ///< Everything before the page's title
+  std::string sidebar; ///< Everything between the title and the breadcrumbs, including the sidebar
+  std::string footer;  ///< Everything after the page's <main> element
+};
+
 /// @brief Serialize hdoc's index to HTML files
 class HTMLWriter {
 public:
@@ -33,17 +46,31 @@ public:
   /// @brief Convert Markdown files to HTML and save them to the filesystem
   void processMarkdownFiles() const;
 
+  /// @brief Wait until all printed pages have been written to disk, and finish the archive if output goes to one.
+  /// Returns false if any of them couldn't be written.
+  bool waitForPages() const;
+
 private:
-  const hdoc::types::Index*  index;
-  const hdoc::types::Config* cfg;
-  llvm::ThreadPool&          pool;
+  const hdoc::types::Index*            index;
+  const hdoc::types::Config*           cfg;
+  llvm::ThreadPool&                    pool;
+  PageChrome                           topLevelChrome; ///< Chrome of pages in the output directory
+  PageChrome                           nestedChrome;   ///< Chrome of pages in subdirectories of the output directory
+  mutable hdoc::utils::AsyncFileWriter writer;         ///< Writes printed pages on threads of its own
+
+  /// @brief Write a page with the standard header, sidebar, and footer around content to path
+  void printNewPage(const std::string_view       content,
+                    const std::filesystem::path& path,
+                    const std::string_view       pageTitle,
+                    const std::string_view       breadcrumbs = "",
+                    const bool                   topLevel    = false) const;
 
   void printFunction(const hdoc::types::FunctionSymbol& f,
-                     CTML::Node&                        main,
+                     hdoc::utils::HTMLStream&           html,
                      const std::string_view             gitRepoURL,
                      const std::string_view             gitDefaultBranch) const;
 
-  CTML::Node printNamespace(const hdoc::types::NamespaceSymbol& ns) const;
+  void printNamespace(hdoc::utils::HTMLStream& html, const hdoc::types::NamespaceSymbol& ns) const;
 
   /// @brief Get a string representation of a namespace that can be used in a URL (i.e. replace '::' with '_')
   std::string getNamespaceString(const hdoc::types::SymbolID& n) const;
@@ -53,13 +80,18 @@ private:
   std::string getFunctionURL(const hdoc::types::SymbolID& f, bool relative) const;
   std::string getFunctionGroupURL(const hdoc::types::FreestandingFunctionID& f, bool relative) const;
 
-  void        printMemberVariables(const hdoc::types::RecordSymbol& c, CTML::Node& main, const bool& isInherited) const;
-  void        printAlias(const hdoc::types::AliasSymbol& a,
-                         CTML::Node&                     main,
-                         const std::string_view          gitRepoURL,
-                         const std::string_view          gitDefaultBranch) const;
-
-  CTML::Node  getBreadcrumbNode(const std::string& prefix, const hdoc::types::Symbol& s, const hdoc::types::Index& index) const;
+  void printMemberVariables(const hdoc::types::RecordSymbol& c,
+                            hdoc::utils::HTMLStream&         html,
+                            const bool&                      isInherited) const;
+  void printAlias(const hdoc::types::AliasSymbol& a,
+                  hdoc::utils::HTMLStream&        html,
+                  const std::string_view          gitRepoURL,
+                  const std::string_view          gitDefaultBranch) const;
+
+  void printBreadcrumbs(hdoc::utils::HTMLStream&   html,
+                        const std::string&         prefix,
+                        const hdoc::types::Symbol& s,
+                        const hdoc::types::Index&  index) const;
 
   std::string getHyperlinkedTypeName(const hdoc::types::TypeRef& type) const;
   std::string getHyperlinkedFunctionProto(const std::string_view proto, const hdoc::types::FunctionSymbol& f) const;
@@ -69,28 +69,28 @@ void JSONDeserializer::deserializeJSONPayload(const rapidjson::Document&
   for (auto it = functionsArray.begin(); it != functionsArray.End(); it++) {
     hdoc::types::FunctionSymbol s = this->deserializeFunctionSymbol(*it);
     idx.functions.reserve(s.ID);
-    idx.functions.update(s.ID, s);
+    idx.functions.update(s.ID, std::move(s));
   }
 
   const auto recordsArray = inputJSON["index"]["records"].GetArray();
   for (auto it = recordsArray.begin(); it != recordsArray.End(); it++) {
     hdoc::types::RecordSymbol s = this->deserializeRecordSymbol(*it);
     idx.records.reserve(s.ID);
-    idx.records.update(s.ID, s);
+    idx.records.update(s.ID, std::move(s));
   }
 
   const auto enumsArray = inputJSON["index"]["enums"].GetArray();
   for (auto it = enumsArray.begin(); it != enumsArray.End(); it++) {
     hdoc::types::EnumSymbol s = this->deserializeEnumSymbol(*it);
     idx.enums.reserve(s.ID);
-    idx.enums.update(s.ID, s);
+    idx.enums.update(s.ID, std::move(s));
   }
 
   const auto namespacesArray = inputJSON["index"]["namespaces"].GetArray();
   for (auto it = namespacesArray.begin(); it != namespacesArray.End(); it++) {
     hdoc::types::NamespaceSymbol s = this->deserializeNamespaceSymbol(*it);
     idx.namespaces.reserve(s.ID);
-    idx.namespaces.update(s.ID, s);
+    idx.namespaces.update(s.ID, std::move(s));
   }
 
   const auto markdownFilesArray = inputJSON["markdownFiles"].GetArray();
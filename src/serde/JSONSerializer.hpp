@@ -25,7 +25,7 @@ public:
     writer.String("briefComment");
     writer.String(sym.briefComment);
     writer.String("file");
-    writer.String(sym.file);
+    writer.String(sym.file.str());
     writer.String("line");
     writer.Uint64(sym.line);
     writer.String("parentNamespaceID");
@@ -37,7 +37,7 @@ public:
     writer.String("id");
     writer.Uint64(typeRef.id.hashValue);
     writer.String("name");
-    writer.String(typeRef.name);
+    writer.String(typeRef.name.str());
     writer.EndObject();
   }
 
@@ -50,7 +50,7 @@ public:
     writer.String("name");
     writer.String(tparam.name);
     writer.String("type");
-    writer.String(tparam.type);
+    writer.String(tparam.type.str());
     writer.String("docComment");
     writer.String(tparam.docComment);
     writer.String("isParameterPack");
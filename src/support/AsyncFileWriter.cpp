@@ -0,0 +1,128 @@
+// Copyright 2019-2023 hdoc
+// SPDX-License-Identifier: AGPL-3.0-only
+
+#include "support/AsyncFileWriter.hpp"
+
+#include <fstream>
+
+#include "llvm/Support/Threading.h"
+#include "spdlog/spdlog.h"
+
+hdoc::utils::AsyncFileWriter::AsyncFileWriter(const uint32_t numThreads, const uint32_t maxQueuedFiles)
+    : maxQueuedFiles(maxQueuedFiles), pool(llvm::hardware_concurrency(numThreads)) {}
+
+hdoc::utils::AsyncFileWriter::~AsyncFileWriter() {
+  this->pool.wait();
+}
+
+std::string hdoc::utils::AsyncFileWriter::takeBuffer() {
+  std::lock_guard<std::mutex> lock(this->mutex);
+  if (this->freeBuffers.empty()) {
+    return "";
+  }
+  std::string buf = std::move(this->freeBuffers.back());
+  this->freeBuffers.pop_back();
+  return buf;
+}
+
+void hdoc::utils::AsyncFileWriter::write(const std::filesystem::path& path, std::string contents) {
+  {
+    std::unique_lock<std::mutex> lock(this->mutex);
+    this->notFull.wait(lock, [&]() { return this->numQueuedFiles < this->maxQueuedFiles; });
+    this->numQueuedFiles += 1;
+  }
+
+  this->pool.async([this, path, contents = std::move(contents)]() mutable {
+    this->writeFile(path, contents);
+    this->release(std::move(contents));
+  });
+}
+
+bool hdoc::utils::AsyncFileWriter::wait() {
+  this->pool.wait();
+  return this->numFailed.load() == 0;
+}
+
+bool hdoc::utils::AsyncFileWriter::openArchive(const std::filesystem::path& archivePath,
+                                               const std::filesystem::path& root) {
+  const std::filesystem::path dir = archivePath.parent_path();
+  std::error_code             ec;
+  if (dir.empty() == false && std::filesystem::exists(dir) == false) {
+    std::filesystem::create_directories(dir, ec);
+    if (ec) {
+      spdlog::error("Creation of directory {} failed with the following error message: '{}'.",
+                    dir.string(),
+                    ec.message());
+      return false;
+    }
+  }
+
+  auto archive = std::make_unique<ZipWriter>();
+  if (archive->open(archivePath) == false) {
+    return false;
+  }
+  this->archive     = std::move(archive);
+  this->archiveRoot = root;
+  return true;
+}
+
+bool hdoc::utils::AsyncFileWriter::closeArchive() {
+  const bool written = this->wait();
+  if (this->archive == nullptr) {
+    return written;
+  }
+  const bool closed = this->archive->close();
+  spdlog::info("Wrote {} files to the archive.", this->archive->size());
+  this->archive.reset();
+  return closed && written;
+}
+
+void hdoc::utils::AsyncFileWriter::writeFile(const std::filesystem::path& path, std::string& contents) {
+  if (this->archive != nullptr) {
+    if (this->archive->add(path.lexically_relative(this->archiveRoot).generic_string(), contents) == false) {
+      this->numFailed += 1;
+    }
+    return;
+  }
+
+  const std::filesystem::path dir = path.parent_path();
+  if (dir.empty() == false) {
+    std::lock_guard<std::mutex> lock(this->directoriesMutex);
+    if (this->createdDirectories.contains(dir.string()) == false) {
+      std::error_code ec;
+      std::filesystem::create_directories(dir, ec);
+      if (ec) {
+        spdlog::error("Creation of directory {} failed with the following error message: '{}'.",
+                      dir.string(),
+                      ec.message());
+        this->numFailed += 1;
+        return;
+      }
+      this->createdDirectories.emplace(dir.string());
+    }
+  }
+
+  // The contents are already in memory, so they're written in a single call without going through the stream's
+  // own buffer
+  std::ofstream out(path, std::ios::binary);
+  out.write(contents.data(), contents.size());
+  // Closing flushes whatever the stream still holds, which is where errors like a full disk show up
+  out.close();
+  if (!out) {
+    spdlog::error("Failed to write {}.", path.string());
+    this->numFailed += 1;
+  }
+}
+
+void hdoc::utils::AsyncFileWriter::release(std::string&& buf) {
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->numQueuedFiles -= 1;
+    // Only keep as many buffers as can be in flight at once, so they don't pile up if a producer doesn't reuse them
+    if (this->freeBuffers.size() < this->maxQueuedFiles) {
+      buf.clear();
+      this->freeBuffers.emplace_back(std::move(buf));
+    }
+  }
+  this->notFull.notify_one();
+}
@@ -0,0 +1,77 @@
+// Copyright 2019-2023 hdoc
+// SPDX-License-Identifier: AGPL-3.0-only
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "llvm/Support/ThreadPool.h"
+
+#include "support/ZipWriter.hpp"
+
+namespace hdoc::utils {
+/// @brief Writes files on threads of its own, so that the threads producing the files don't wait for the disk.
+///
+/// At most maxQueuedFiles files wait to be written at any time, and write() blocks while the queue is full so that
+/// memory use stays bounded when files are produced faster than they're written. The directory of each file is
+/// created the first time a file is written to it. The buffers of written files are handed out again by
+/// takeBuffer(), so producers that keep writing similar files stop allocating once the buffers have grown.
+///
+/// Instead of writing each file separately, all files can be added to a single ZIP archive with openArchive().
+class AsyncFileWriter {
+public:
+  AsyncFileWriter(const uint32_t numThreads, const uint32_t maxQueuedFiles);
+
+  /// Waits for all queued files to be written.
+  ~AsyncFileWriter();
+
+  /// @brief Get an empty buffer, reusing the storage of a file that was already written if there is one.
+  std::string takeBuffer();
+
+  /// @brief Queue contents to be written to path, blocking while the queue is full.
+  /// Safe to call from multiple threads at once.
+  void write(const std::filesystem::path& path, std::string contents);
+
+  /// @brief Wait until all queued files have been written.
+  /// Returns false if any file written so far couldn't be written.
+  bool wait();
+
+  /// @brief Add all files written from now on to the ZIP archive at archivePath, named by their path relative to
+  /// root, instead of writing them to disk. Returns false if the archive couldn't be created.
+  /// Must not be called while files are being written.
+  bool openArchive(const std::filesystem::path& archivePath, const std::filesystem::path& root);
+
+  /// @brief Wait until all queued files have been written, then finish the archive if one is open.
+  /// Returns false if the archive couldn't be written, or if any file couldn't be written.
+  bool closeArchive();
+
+private:
+  /// Write contents to path, creating its directory if it's the first file in it, or add it to the archive.
+  void writeFile(const std::filesystem::path& path, std::string& contents);
+
+  /// Return the storage of buf to the free buffers and let a blocked write() continue.
+  void release(std::string&& buf);
+
+  const uint32_t                  maxQueuedFiles;
+  uint32_t                        numQueuedFiles = 0; ///< Files queued or being written
+  std::vector<std::string>        freeBuffers;        ///< Buffers of written files, ready to be reused
+  std::mutex                      mutex;              ///< Guards numQueuedFiles and freeBuffers
+  std::condition_variable         notFull;            ///< Signalled whenever a file has been written
+  std::mutex                      directoriesMutex;   ///< Guards createdDirectories
+  std::unordered_set<std::string> createdDirectories; ///< Directories known to exist
+  std::atomic<uint64_t>           numFailed = 0;      ///< Number of files that couldn't be written
+  std::unique_ptr<ZipWriter>      archive;            ///< Archive that files are added to, if any
+  std::filesystem::path           archiveRoot;        ///< Directory that names in the archive are relative to
+
+  /// Declared last so that its threads are joined before the state they use is destroyed
+  llvm::ThreadPool pool;
+};
+} // namespace hdoc::utils
@@ -0,0 +1,74 @@
+// Copyright 2019-2023 hdoc
+// SPDX-License-Identifier: AGPL-3.0-only
+
+#include "support/HTMLStream.hpp"
+
+void hdoc::utils::appendEscapedHTML(std::string& out, const std::string_view s) {
+  // Most strings don't need escaping, so runs of plain characters are appended at once
+  std::size_t start = 0;
+  for (std::size_t i = 0; i < s.size(); i++) {
+    std::string_view replacement;
+    switch (s[i]) {
+    case '&':
+      replacement = "&amp;";
+      break;
+    case '<':
+      replacement = "&lt;";
+      break;
+    case '>':
+      replacement = "&gt;";
+      break;
+    case '"':
+      replacement = "&quot;";
+      break;
+    case '\'':
+      replacement = "&apos;";
+      break;
+    default:
+      continue;
+    }
+    out.append(s.substr(start, i - start));
+    out.append(replacement);
+    start = i + 1;
+  }
+  out.append(s.substr(start));
+}
+
+hdoc::utils::HTMLStream& hdoc::utils::HTMLStream::open(const Tag&                  tag,
+                                                       std::initializer_list<Attr> attrs,
+                                                       const std::string_view      extraClasses) {
+  this->out += '<';
+  this->out.append(tag.name);
+  if (tag.classes.empty() == false || extraClasses.empty() == false) {
+    this->out += " class=\"";
+    this->out.append(tag.classes);
+    if (tag.classes.empty() == false && extraClasses.empty() == false) {
+      this->out += ' ';
+    }
+    this->out.append(extraClasses);
+    this->out += '"';
+  }
+  for (const Attr& attr : attrs) {
+    this->out += ' ';
+    this->out.append(attr.name);
+    this->out += "=\"";
+    appendEscapedHTML(this->out, attr.value);
+    this->out += '"';
+  }
+  this->out += '>';
+  return *this;
+}
+
+hdoc::utils::HTMLStream& hdoc::utils::HTMLStream::close(const Tag& tag) {
+  this->out += "</";
+  this->out.append(tag.name);
+  this->out += '>';
+  return *this;
+}
+
+hdoc::utils::HTMLStream& hdoc::utils::HTMLStream::element(const Tag&                  tag,
+                                                          const std::string_view      text,
+                                                          std::initializer_list<Attr> attrs,
+                                                          const std::string_view      extraClasses) {
+  return this->open(tag, attrs, extraClasses).text(text).close(tag);
+}
@@ -0,0 +1,68 @@
+// Copyright 2019-2023 hdoc
+// SPDX-License-Identifier: AGPL-3.0-only
+
+#pragma once
+
+#include <initializer_list>
+#include <string>
+#include <string_view>
+
+namespace hdoc::utils {
+/// @brief An HTML element and its classes, i.e. `Tag{"li", "is-family-code"}`.
+/// Tags are literals, so nothing has to be parsed or allocated to open one.
+struct Tag {
+  std::string_view name;         ///< Name of the element, i.e. "li"
+  std::string_view classes = ""; ///< Space-separated classes of the element
+};
+
+/// @brief An attribute of an element, i.e. `Attr{"href", url}`. The value is escaped when it's written.
+struct Attr {
+  std::string_view name;
+  std::string_view value;
+};
+
+/// @brief Append s to out with the characters that are special in HTML escaped.
+void appendEscapedHTML(std::string& out, const std::string_view s);
+
+/// @brief Writes HTML straight into a string as a page is generated, instead of building a tree of nodes and
+/// rendering it once the page is done.
+///
+/// Text and attribute values are escaped, raw HTML is appended as-is. Elements must be closed in the reverse order
+/// that they were opened in. The string isn't cleared first, so that a buffer can be reused for many pages.
+class HTMLStream {
+public:
+  HTMLStream(std::string& out) : out(out) {}
+
+  /// @brief Open tag with the given attributes. extraClasses are added to the classes of tag.
+  HTMLStream& open(const Tag& tag, std::initializer_list<Attr> attrs = {}, const std::string_view extraClasses = "");
+
+  /// @brief Close tag.
+  HTMLStream& close(const Tag& tag);
+
+  /// @brief Write tag with text as its only child.
+  HTMLStream& element(const Tag&                  tag,
+                      const std::string_view      text,
+                      std::initializer_list<Attr> attrs        = {},
+                      const std::string_view      extraClasses = "");
+
+  /// @brief Write an element that has no children or closing tag, like `<meta>` or `<br>`.
+  HTMLStream& voidElement(const Tag& tag, std::initializer_list<Attr> attrs = {}) {
+    return this->open(tag, attrs);
+  }
+
+  /// @brief Write text, escaping it.
+  HTMLStream& text(const std::string_view s) {
+    appendEscapedHTML(this->out, s);
+    return *this;
+  }
+
+  /// @brief Write HTML without escaping it.
+  HTMLStream& raw(const std::string_view s) {
+    this->out.append(s);
+    return *this;
+  }
+
+private:
+  std::string& out;
+};
+} // namespace hdoc::utils
@@ -0,0 +1,262 @@
+// Copyright 2019-2023 hdoc
+// SPDX-License-Identifier: AGPL-3.0-only
+
+#include "support/Instrumentation.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <sys/resource.h>
+
+#include "rapidjson/prettywriter.h"
+#include "rapidjson/stringbuffer.h"
+#include "spdlog/spdlog.h"
+
+#include "version.hpp"
+
+void hdoc::utils::Instrumentation::addPhase(const std::string&      name,
+                                            const llvm::TimeRecord& start,
+                                            const llvm::TimeRecord& end) {
+  std::lock_guard<std::mutex> lock(this->mutex);
+  this->phases.emplace_back(Phase{
+      name,
+      end.getWallTime() - start.getWallTime(),
+      end.getProcessTime() - start.getProcessTime(),
+      getPeakRSS(),
+  });
+}
+
+void hdoc::utils::Instrumentation::recordTranslationUnit(const std::string& path, const double seconds) {
+  std::lock_guard<std::mutex> lock(this->mutex);
+  this->translationUnits.emplace_back(path, seconds);
+}
+
+void hdoc::utils::Instrumentation::recordIndex(const hdoc::types::Index& index) {
+  const auto recordDatabase = [&]<typename T>(const char* name, const hdoc::types::Database<T>& db) {
+    this->databases.emplace_back(DatabaseStats{name, db.numMatches.load(), db.entries.size(), getHeapBytes(db)});
+  };
+
+  this->databases.clear();
+  recordDatabase("functions", index.functions);
+  recordDatabase("records", index.records);
+  recordDatabase("enums", index.enums);
+  recordDatabase("namespaces", index.namespaces);
+  recordDatabase("aliases", index.aliases);
+}
+
+bool hdoc::utils::Instrumentation::write(const std::filesystem::path& path) const {
+  std::vector<Phase>                          phases;
+  std::vector<std::pair<std::string, double>> tus;
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    phases = this->phases;
+    tus    = this->translationUnits;
+  }
+  // Slowest TUs first, which are the ones worth looking at
+  std::sort(tus.begin(), tus.end(), [](const auto& a, const auto& b) {
+    return a.second != b.second ? a.second > b.second : a.first < b.first;
+  });
+
+  rapidjson::StringBuffer                          buf;
+  rapidjson::PrettyWriter<rapidjson::StringBuffer> writer(buf);
+  writer.StartObject();
+  writer.String("hdocVersion");
+  writer.String(HDOC_VERSION);
+  writer.String("peakRSSBytes");
+  writer.Uint64(getPeakRSS());
+  writer.String("internedStrings");
+  writer.Uint64(hdoc::types::InternedString::getPoolSize());
+  writer.String("internedStringHeapBytes");
+  writer.Uint64(hdoc::types::InternedString::getPoolHeapBytes());
+
+  writer.String("phases");
+  writer.StartArray();
+  for (const auto& phase : phases) {
+    writer.StartObject();
+    writer.String("name");
+    writer.String(phase.name);
+    writer.String("wallSeconds");
+    writer.Double(phase.wallSeconds);
+    writer.String("cpuSeconds");
+    writer.Double(phase.cpuSeconds);
+    writer.String("peakRSSBytes");
+    writer.Uint64(phase.peakRSSBytes);
+    writer.EndObject();
+  }
+  writer.EndArray();
+
+  writer.String("translationUnits");
+  writer.StartArray();
+  for (const auto& [tu, seconds] : tus) {
+    writer.StartObject();
+    writer.String("path");
+    writer.String(tu);
+    writer.String("wallSeconds");
+    writer.Double(seconds);
+    writer.EndObject();
+  }
+  writer.EndArray();
+
+  writer.String("databases");
+  writer.StartArray();
+  for (const auto& db : this->databases) {
+    writer.StartObject();
+    writer.String("name");
+    writer.String(db.name);
+    writer.String("matches");
+    writer.Uint64(db.numMatches);
+    writer.String("entries");
+    writer.Uint64(db.numEntries);
+    writer.String("heapBytes");
+    writer.Uint64(db.heapBytes);
+    writer.EndObject();
+  }
+  writer.EndArray();
+  writer.EndObject();
+
+  std::ofstream out(path);
+  if (!out) {
+    spdlog::error("Failed to open performance report {}.", path.string());
+    return false;
+  }
+  out << buf.GetString();
+  // Closing flushes the rest of the report, which can fail just like writing it
+  out.close();
+  if (!out) {
+    spdlog::error("Failed to write performance report {}.", path.string());
+    return false;
+  }
+  spdlog::info("Performance report written to {}.", path.string());
+  return true;
+}
+
+uint64_t hdoc::utils::Instrumentation::getPeakRSS() {
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0) {
+    return 0;
+  }
+#ifdef __APPLE__
+  return static_cast<uint64_t>(usage.ru_maxrss);
+#else
+  // Linux reports the peak RSS in KiB
+  return static_cast<uint64_t>(usage.ru_maxrss) * 1024;
+#endif
+}
+
+// The heapBytes() overloads count the bytes an object owns outside of itself, so containers add the size of
+// their elements and then the heap bytes of each element.
+static uint64_t heapBytes(const std::string& s) {
+  // Short strings are stored inside the std::string itself and don't allocate
+  const char* data  = s.data();
+  const char* begin = reinterpret_cast<const char*>(&s);
+  if (data >= begin && data < begin + sizeof(s)) {
+    return 0;
+  }
+  return s.capacity() + 1;
+}
+
+// Interned strings are owned by the pool, which is reported separately
+static uint64_t heapBytes(const hdoc::types::InternedString&) {
+  return 0;
+}
+
+static uint64_t heapBytes(const hdoc::types::SymbolID&) {
+  return 0;
+}
+
+static uint64_t heapBytes(const hdoc::types::TypeRef& ref) {
+  return heapBytes(ref.name);
+}
+
+static uint64_t heapBytes(const hdoc::types::TemplateParam& p) {
+  return heapBytes(p.name) + heapBytes(p.type) + heapBytes(p.docComment) + heapBytes(p.defaultValue);
+}
+
+static uint64_t heapBytes(const hdoc::types::FunctionParam& p) {
+  return heapBytes(p.name) + heapBytes(p.type) + heapBytes(p.docComment) + heapBytes(p.defaultValue);
+}
+
+static uint64_t heapBytes(const hdoc::types::MemberVariable& v) {
+  return heapBytes(v.name) + heapBytes(v.type) + heapBytes(v.defaultValue) + heapBytes(v.docComment);
+}
+
+static uint64_t heapBytes(const hdoc::types::RecordSymbol::BaseRecord& b) {
+  return heapBytes(b.name);
+}
+
+static uint64_t heapBytes(const hdoc::types::EnumMember& m) {
+  return heapBytes(m.name) + heapBytes(m.docComment);
+}
+
+template <typename T> static uint64_t heapBytes(const std::vector<T>& v) {
+  uint64_t bytes = v.capacity() * sizeof(T);
+  for (const auto& e : v) {
+    bytes += heapBytes(e);
+  }
+  return bytes;
+}
+
+static uint64_t symbolHeapBytes(const hdoc::types::Symbol& s) {
+  return heapBytes(s.name) + heapBytes(s.briefComment) + heapBytes(s.docComment) + heapBytes(s.file);
+}
+
+static uint64_t heapBytes(const hdoc::types::FunctionSymbol& s) {
+  return symbolHeapBytes(s) + heapBytes(s.proto) + heapBytes(s.returnType) + heapBytes(s.returnTypeDocComment) +
+         heapBytes(s.params) + heapBytes(s.templateParams) + heapBytes(s.freestandingID.name);
+}
+
+static uint64_t heapBytes(const hdoc::types::RecordSymbol& s) {
+  return symbolHeapBytes(s) + heapBytes(s.type) + heapBytes(s.proto) + heapBytes(s.vars) + heapBytes(s.methodIDs) +
+         heapBytes(s.baseRecords) + heapBytes(s.templateParams) + heapBytes(s.aliasIDs) + heapBytes(s.hiddenFriendIDs);
+}
+
+static uint64_t heapBytes(const hdoc::types::EnumSymbol& s) {
+  return symbolHeapBytes(s) + heapBytes(s.type) + heapBytes(s.members);
+}
+
+static uint64_t heapBytes(const hdoc::types::NamespaceSymbol& s) {
+  return symbolHeapBytes(s) + heapBytes(s.records) + heapBytes(s.namespaces) + heapBytes(s.enums) +
+         heapBytes(s.usings) + heapBytes(s.functions);
+}
+
+static uint64_t heapBytes(const hdoc::types::AliasSymbol& s) {
+  return symbolHeapBytes(s) + heapBytes(s.target) + heapBytes(s.templateParams) + heapBytes(s.proto);
+}
+
+template <typename T> static uint64_t databaseHeapBytes(const hdoc::types::Database<T>& db) {
+  using ShardMap = std::unordered_map<hdoc::types::SymbolID, T>;
+
+  uint64_t bytes = 0;
+  for (uint32_t i = 0; i < hdoc::types::SymbolMap<T>::getNumShards(); i++) {
+    const ShardMap& shard = db.entries.getShard(i);
+    // Maps that never grew use a single bucket that's stored in the map itself
+    if (shard.bucket_count() > 1) {
+      bytes += shard.bucket_count() * sizeof(void*);
+    }
+    // Each entry lives in a separately allocated node that also holds a pointer to the next node
+    bytes += shard.size() * (sizeof(typename ShardMap::value_type) + sizeof(void*));
+    for (const auto& [id, symbol] : shard) {
+      bytes += heapBytes(symbol);
+    }
+  }
+  return bytes;
+}
+
+uint64_t hdoc::utils::getHeapBytes(const hdoc::types::Database<hdoc::types::FunctionSymbol>& db) {
+  return databaseHeapBytes(db);
+}
+
+uint64_t hdoc::utils::getHeapBytes(const hdoc::types::Database<hdoc::types::RecordSymbol>& db) {
+  return databaseHeapBytes(db);
+}
+
+uint64_t hdoc::utils::getHeapBytes(const hdoc::types::Database<hdoc::types::EnumSymbol>& db) {
+  return databaseHeapBytes(db);
+}
+
+uint64_t hdoc::utils::getHeapBytes(const hdoc::types::Database<hdoc::types::NamespaceSymbol>& db) {
+  return databaseHeapBytes(db);
+}
+
+uint64_t hdoc::utils::getHeapBytes(const hdoc::types::Database<hdoc::types::AliasSymbol>& db) {
+  return databaseHeapBytes(db);
+}
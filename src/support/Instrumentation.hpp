@@ -0,0 +1,87 @@
+// Copyright 2019-2023 hdoc
+// SPDX-License-Identifier: AGPL-3.0-only
+
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "llvm/Support/Timer.h"
+
+#include "types/Index.hpp"
+
+namespace hdoc::utils {
+/// @brief Collects the time and memory each phase of an hdoc run takes, and writes them to a JSON report
+/// so that performance regressions can be tracked across runs.
+///
+/// All measurements can be recorded from several threads at once. CPU time is measured for the whole process,
+/// so phases that run at the same time as others include the CPU time of the others.
+class Instrumentation {
+public:
+  /// @brief Wall and CPU time of a phase, along with the peak RSS of the process when it finished.
+  struct Phase {
+    std::string name;         ///< Name of the phase, i.e. "resolveNamespaces"
+    double      wallSeconds;  ///< Elapsed time
+    double      cpuSeconds;   ///< User and system time of all threads of the process
+    uint64_t    peakRSSBytes; ///< Peak resident set size of the process at the end of the phase
+  };
+
+  /// @brief Size of one of the Databases in the Index.
+  struct DatabaseStats {
+    std::string name;       ///< Name of the database, i.e. "functions"
+    uint64_t    numMatches; ///< Number of matches, including ones that weren't indexed
+    uint64_t    numEntries; ///< Number of indexed symbols
+    uint64_t    heapBytes;  ///< Bytes taken by the symbols, including strings and vectors they own
+  };
+
+  /// @brief Run f as the phase called name and record how long it took.
+  template <typename F> void measure(const std::string& name, F&& f) {
+    const llvm::TimeRecord start = llvm::TimeRecord::getCurrentTime(/*Start=*/true);
+    f();
+    this->addPhase(name, start, llvm::TimeRecord::getCurrentTime(/*Start=*/false));
+  }
+
+  /// @brief Record that indexing the TU at path took seconds. Safe to call from multiple threads at once.
+  void recordTranslationUnit(const std::string& path, const double seconds);
+
+  /// @brief Record the size of each Database in index.
+  void recordIndex(const hdoc::types::Index& index);
+
+  /// @brief Write all recorded measurements and the size of the InternedString pool to path as JSON.
+  /// Returns false if the file couldn't be written.
+  bool write(const std::filesystem::path& path) const;
+
+  /// @brief Get the phases recorded so far, in the order they finished. Must not be called while phases run.
+  const std::vector<Phase>& getPhases() const {
+    return this->phases;
+  }
+
+  /// @brief Get the Databases recorded by the last call to recordIndex().
+  const std::vector<DatabaseStats>& getDatabases() const {
+    return this->databases;
+  }
+
+  /// @brief Get the peak resident set size of this process so far, or 0 if it can't be determined.
+  static uint64_t getPeakRSS();
+
+private:
+  void addPhase(const std::string& name, const llvm::TimeRecord& start, const llvm::TimeRecord& end);
+
+  std::vector<Phase>                          phases;           ///< Phases in the order they ran
+  std::vector<DatabaseStats>                  databases;        ///< Size of each Database
+  mutable std::mutex                          mutex;            ///< Guards phases and translationUnits
+  std::vector<std::pair<std::string, double>> translationUnits; ///< Seconds each TU took to index
+};
+
+/// @brief Get the number of heap bytes taken by the symbols in db, including the strings and vectors they own
+/// and the nodes and buckets of the hash maps that hold them. Allocator overhead isn't included.
+uint64_t getHeapBytes(const hdoc::types::Database<hdoc::types::FunctionSymbol>& db);
+uint64_t getHeapBytes(const hdoc::types::Database<hdoc::types::RecordSymbol>& db);
+uint64_t getHeapBytes(const hdoc::types::Database<hdoc::types::EnumSymbol>& db);
+uint64_t getHeapBytes(const hdoc::types::Database<hdoc::types::NamespaceSymbol>& db);
+uint64_t getHeapBytes(const hdoc::types::Database<hdoc::types::AliasSymbol>& db);
+} // namespace hdoc::utils
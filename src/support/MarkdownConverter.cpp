@@ -55,13 +55,3 @@ hdoc::utils::MarkdownConverter::~MarkdownConverter() {
   cmark_node_free(this->markdownDoc);
   free(this->htmlBuf);
 }
-
-CTML::Node hdoc::utils::MarkdownConverter::getHTMLNode() const {
-  if (this->initialized == false) {
-    return CTML::Node();
-  }
-
-  CTML::Node main("main");
-  main.AppendRawHTML(this->html);
-  return main;
-}
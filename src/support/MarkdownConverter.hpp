@@ -7,7 +7,6 @@
 #include <string>
 
 #include "cmark-gfm.h"
-#include "ctml.hpp"
 #include "spdlog/spdlog.h"
 
 namespace hdoc::utils {
@@ -19,10 +18,8 @@ public:
   MarkdownConverter(const std::string& mdContent);
   ~MarkdownConverter();
 
-  /// Get the HTML node containing the Markdown contents
-  CTML::Node getHTMLNode() const;
-
-  std::string getHTMLString() const { return this->html; }
+  /// Get the Markdown contents as HTML, or an empty string if the conversion failed
+  const std::string& getHTMLString() const { return this->html; }
 
 private:
   void convertString(const std::string& mdContent);
@@ -1,62 +1,175 @@
 // Copyright 2019-2023 hdoc
 // SPDX-License-Identifier: AGPL-3.0-only
 
+#include <algorithm>
+
 #include "support/ParallelExecutor.hpp"
 #include "spdlog/spdlog.h"
 
+#include "clang/Basic/DiagnosticFrontend.h"
+#include "clang/Basic/DiagnosticIDs.h"
+#include "clang/Tooling/CompilationDatabase.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Path.h"
 #include "llvm/Support/VirtualFileSystem.h"
 
-void hdoc::indexer::ParallelExecutor::execute(std::unique_ptr<clang::tooling::FrontendActionFactory> action) {
+std::vector<std::string> hdoc::indexer::ParallelExecutor::getFiles() const {
+  std::vector<std::string> allFilesInCmpdb = this->cmpdb.getAllFiles();
+  std::sort(allFilesInCmpdb.begin(), allFilesInCmpdb.end());
+
+  if (this->debugLimitNumIndexedFiles > 0 && this->debugLimitNumIndexedFiles < allFilesInCmpdb.size()) {
+    allFilesInCmpdb.resize(this->debugLimitNumIndexedFiles);
+  }
+  return allFilesInCmpdb;
+}
+
+void hdoc::indexer::ParallelExecutor::execute(const std::function<void(const std::string& path)>& indexFile) {
+  this->execute(this->getFiles(), indexFile);
+}
+
+void hdoc::indexer::ParallelExecutor::execute(const std::vector<std::string>&                       files,
+                                              const std::function<void(const std::string& path)>& indexFile) {
   std::mutex mutex;
 
   // Add a counter to track progress
   uint32_t    i                = 0;
-  std::string totalNumFiles    = std::to_string(this->cmpdb.getAllFiles().size());
+  std::string totalNumFiles    = std::to_string(files.size());
   auto        incrementCounter = [&]() {
     std::unique_lock<std::mutex> lock(mutex);
     return ++i;
   };
 
-  std::vector<std::string> allFilesInCmpdb = this->cmpdb.getAllFiles();
-
-  if (this->debugLimitNumIndexedFiles > 0) {
-    allFilesInCmpdb.resize(this->debugLimitNumIndexedFiles);
-    totalNumFiles = std::to_string(this->debugLimitNumIndexedFiles);
-  }
-
-  for (const std::string& file : allFilesInCmpdb) {
+  for (const std::string& file : files) {
     this->pool.async(
         [&](const std::string path) {
           spdlog::info("[{}/{}] processing {}", incrementCounter(), totalNumFiles, path);
-
-          // Each thread gets an independent copy of a VFS to allow different concurrent working directories
-          llvm::IntrusiveRefCntPtr<llvm::vfs::FileSystem> FS = llvm::vfs::createPhysicalFileSystem().release();
-          clang::tooling::ClangTool Tool(this->cmpdb, {path}, std::make_shared<clang::PCHContainerOperations>(), FS);
-
-          // Append argument adjusters so that system includes and others are picked up on
-          // TODO: determine if the -fsyntax-only flag actually does anything
-          Tool.appendArgumentsAdjuster(clang::tooling::getClangStripOutputAdjuster());
-          Tool.appendArgumentsAdjuster(clang::tooling::getClangStripDependencyFileAdjuster());
-          Tool.appendArgumentsAdjuster(clang::tooling::getClangSyntaxOnlyAdjuster());
-          Tool.appendArgumentsAdjuster(clang::tooling::getInsertArgumentAdjuster(
-              this->includePaths, clang::tooling::ArgumentInsertPosition::END));
-
-          // Ignore all diagnostics that clang might throw. Clang often has weird diagnostic settings that don't
-          // match what's in compile_commands.json, resulting in spurious errors. Instead of trying to change clang's
-          // behavior, we'll ignore all diagnostics and assume that the user supplied a project that builds on their
-          // machine.
-          clang::IgnoringDiagConsumer ignore;
-          Tool.setDiagnosticConsumer(&ignore);
-
-          // Run the tool and print an error message if something goes wrong
-          if (Tool.run(action.get())) {
-            spdlog::error(
-                "Clang failed to parse source file: {}. Information from this file may be missing from hdoc's output",
-                path);
-          }
+          indexFile(path);
         },
         file);
   }
   // Make sure all tasks have finished before resetting the working directory
   this->pool.wait();
 }
+
+namespace {
+/// Ignores all diagnostics, but remembers if any of them was caused by a precompiled header that couldn't be loaded.
+class PCHFailureDiagConsumer : public clang::DiagnosticConsumer {
+public:
+  void HandleDiagnostic(clang::DiagnosticsEngine::Level level, const clang::Diagnostic& info) override {
+    const unsigned id = info.getID();
+    if (level >= clang::DiagnosticsEngine::Error &&
+        ((id >= clang::diag::DIAG_START_SERIALIZATION && id < clang::diag::DIAG_START_LEX) ||
+         id == clang::diag::err_fe_unable_to_load_pch)) {
+      this->pchUnusable = true;
+    }
+  }
+
+  bool pchUnusable = false;
+};
+} // namespace
+
+bool hdoc::indexer::ParallelExecutor::runClangTool(const clang::tooling::CompilationDatabase& db,
+                                                   const std::string&                         path,
+                                                   clang::tooling::FrontendActionFactory*     action,
+                                                   const std::vector<std::string>&            extraArgs,
+                                                   bool*                                      pchUnusable) const {
+  // Each thread gets an independent copy of a VFS to allow different concurrent working directories
+  llvm::IntrusiveRefCntPtr<llvm::vfs::FileSystem> FS = llvm::vfs::createPhysicalFileSystem().release();
+  clang::tooling::ClangTool Tool(db, {path}, this->pchContainerOps, FS);
+
+  // Append argument adjusters so that system includes and others are picked up on
+  // TODO: determine if the -fsyntax-only flag actually does anything
+  Tool.appendArgumentsAdjuster(clang::tooling::getClangStripOutputAdjuster());
+  Tool.appendArgumentsAdjuster(clang::tooling::getClangStripDependencyFileAdjuster());
+  Tool.appendArgumentsAdjuster(clang::tooling::getClangSyntaxOnlyAdjuster());
+  Tool.appendArgumentsAdjuster(
+      clang::tooling::getInsertArgumentAdjuster(this->includePaths, clang::tooling::ArgumentInsertPosition::END));
+  if (extraArgs.size() > 0) {
+    Tool.appendArgumentsAdjuster(
+        clang::tooling::getInsertArgumentAdjuster(extraArgs, clang::tooling::ArgumentInsertPosition::END));
+  }
+
+  // Ignore all diagnostics that clang might throw. Clang often has weird diagnostic settings that don't
+  // match what's in compile_commands.json, resulting in spurious errors. Instead of trying to change clang's
+  // behavior, we'll ignore all diagnostics and assume that the user supplied a project that builds on their
+  // machine.
+  PCHFailureDiagConsumer ignore;
+  Tool.setDiagnosticConsumer(&ignore);
+
+  const bool success = Tool.run(action) == 0;
+  if (pchUnusable != nullptr) {
+    *pchUnusable = ignore.pchUnusable;
+  }
+  return success;
+}
+
+bool hdoc::indexer::ParallelExecutor::runClang(const std::string&                     path,
+                                               clang::tooling::FrontendActionFactory* action,
+                                               const std::function<void()>&           beforeRetry) const {
+  bool pchUnusable = true;
+  bool success     = false;
+  if (this->pchPath.empty() == false) {
+    const std::vector<std::string> pchArgs = {"-include-pch", this->pchPath};
+    success = this->runClangTool(this->cmpdb, path, action, pchArgs, &pchUnusable);
+    if (pchUnusable) {
+      spdlog::info("Precompiled header can't be used for {}, parsing it without the precompiled header", path);
+      if (beforeRetry != nullptr) {
+        beforeRetry();
+      }
+    }
+  }
+  if (pchUnusable) {
+    success = this->runClangTool(this->cmpdb, path, action, {}, nullptr);
+  }
+
+  // Print an error message if something went wrong
+  if (success == false) {
+    spdlog::error("Clang failed to parse source file: {}. Information from this file may be missing from hdoc's output",
+                  path);
+  }
+  return success;
+}
+
+bool hdoc::indexer::ParallelExecutor::runClangOnHeader(const std::string&                     header,
+                                                       const std::string&                     file,
+                                                       clang::tooling::FrontendActionFactory* action) const {
+  const std::vector<clang::tooling::CompileCommand> cmds = this->cmpdb.getCompileCommands(file);
+  if (cmds.empty()) {
+    spdlog::error("No compile command for {} in the compilation database", file);
+    return false;
+  }
+  const clang::tooling::CompileCommand& cmd = cmds.front();
+
+  // Keep the flags of the compile command, but drop the compiler, the source file, and its language
+  llvm::SmallString<256> source(cmd.Filename);
+  llvm::sys::fs::make_absolute(cmd.Directory, source);
+  llvm::sys::path::remove_dots(source, /*remove_dot_dot=*/true);
+
+  std::vector<std::string> flags = {"-xc++-header"};
+  for (uint64_t i = 1; i < cmd.CommandLine.size(); i++) {
+    const llvm::StringRef arg = cmd.CommandLine[i];
+    if (arg == "-x") {
+      i++;
+      continue;
+    }
+    if (arg.startswith("-x")) {
+      continue;
+    }
+
+    llvm::SmallString<256> argPath(arg);
+    llvm::sys::fs::make_absolute(cmd.Directory, argPath);
+    llvm::sys::path::remove_dots(argPath, /*remove_dot_dot=*/true);
+    if (argPath == source) {
+      continue;
+    }
+    flags.emplace_back(arg.str());
+  }
+
+  const clang::tooling::FixedCompilationDatabase headerCmpdb(cmd.Directory, flags);
+  if (this->runClangTool(headerCmpdb, header, action, {}, nullptr) == false) {
+    spdlog::error("Clang failed to parse header: {}", header);
+    return false;
+  }
+  return true;
+}
@@ -3,6 +3,8 @@
 
 #pragma once
 
+#include <functional>
+#include <memory>
 #include <string>
 
 #include "clang/Tooling/Execution.h"
@@ -10,8 +12,8 @@
 
 namespace hdoc::indexer {
 /// @brief A cut-down reimplementation of clang's AllTUsToolExecutor.
-/// Removes everything we don't need, leaving a simple mechanism that executes
-/// a frontend action over all files in the compilation database.
+/// Removes everything we don't need, leaving a simple mechanism that processes
+/// all files in the compilation database in parallel.
 class ParallelExecutor {
 public:
   /// Creates a parallel executor that will run over all files in the compilation database.
@@ -22,12 +24,54 @@ public:
                    const uint32_t                             debugLimitNumIndexedFiles)
       : cmpdb(cmpdb), includePaths(includePaths), pool(pool), debugLimitNumIndexedFiles(debugLimitNumIndexedFiles) {}
 
-  void execute(std::unique_ptr<clang::tooling::FrontendActionFactory> action);
+  /// Get the files in the compilation database that will be indexed, sorted by path.
+  std::vector<std::string> getFiles() const;
+
+  /// Call indexFile for every file in the compilation database, using the thread pool.
+  /// Blocks until all files have been processed.
+  void execute(const std::function<void(const std::string& path)>& indexFile);
+
+  /// Call indexFile for every file in files, using the thread pool. Files are started in the order they appear in,
+  /// each on the first thread that becomes free. Blocks until all files have been processed.
+  void execute(const std::vector<std::string>& files, const std::function<void(const std::string& path)>& indexFile);
+
+  /// Parse the file at path with clang and run the frontend action created by action over it.
+  /// Returns false if clang failed to parse the file. Safe to call from multiple threads at once.
+  /// If a precompiled header is in use, it's included in the file first. Should clang be unable to use it,
+  /// for example because the file is compiled with different flags, the file is parsed again without it.
+  /// beforeRetry is called before that, so that the caller can discard what the first attempt collected.
+  bool runClang(const std::string&                     path,
+                clang::tooling::FrontendActionFactory* action,
+                const std::function<void()>&           beforeRetry = nullptr) const;
+
+  /// Parse header with clang as a C++ header, using the compile flags of file in the compilation database,
+  /// and run the frontend action created by action over it. Returns false if clang failed to parse the header.
+  bool runClangOnHeader(const std::string&                     header,
+                        const std::string&                     file,
+                        clang::tooling::FrontendActionFactory* action) const;
+
+  /// Include the precompiled header at pchPath in all files parsed by runClang() from now on.
+  /// Must not be called while files are being parsed.
+  void usePrecompiledHeader(const std::string& pchPath) {
+    this->pchPath = pchPath;
+  }
 
 private:
+  /// Run a ClangTool over path using the compile commands in db with extraArgs appended.
+  /// If pchUnusable isn't nullptr, it's set to true if clang failed to load a precompiled header.
+  bool runClangTool(const clang::tooling::CompilationDatabase& db,
+                    const std::string&                         path,
+                    clang::tooling::FrontendActionFactory*     action,
+                    const std::vector<std::string>&            extraArgs,
+                    bool*                                      pchUnusable) const;
+
   const clang::tooling::CompilationDatabase& cmpdb;
   const std::vector<std::string>&            includePaths;
   llvm::ThreadPool&                          pool;
   const uint32_t                             debugLimitNumIndexedFiles = 0;
+  std::string                                pchPath; ///< Precompiled header included in every file, if any
+
+  /// Readers and writers of precompiled headers are stateless, so one set is shared by all threads
+  std::shared_ptr<clang::PCHContainerOperations> pchContainerOps = std::make_shared<clang::PCHContainerOperations>();
 };
 } // namespace hdoc::indexer
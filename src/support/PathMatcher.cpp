@@ -0,0 +1,181 @@
+// Copyright 2019-2023 hdoc
+// SPDX-License-Identifier: AGPL-3.0-only
+
+#include "support/PathMatcher.hpp"
+
+#include <utility>
+
+static bool isGlob(const std::string& pattern) {
+  return pattern.find_first_of("*?[") != std::string::npos;
+}
+
+static std::vector<std::string> getSubstrings(const std::vector<std::string>& patterns) {
+  std::vector<std::string> substrings;
+  for (const auto& pattern : patterns) {
+    if (isGlob(pattern) == false) {
+      substrings.emplace_back(pattern);
+    }
+  }
+  return substrings;
+}
+
+/// Split s on "/", skipping empty components.
+template <typename T> static std::vector<T> splitPath(const std::string_view s) {
+  std::vector<T> components;
+  std::size_t    start = 0;
+  while (start <= s.size()) {
+    std::size_t end = s.find('/', start);
+    if (end == std::string_view::npos) {
+      end = s.size();
+    }
+    if (end > start) {
+      components.emplace_back(s.substr(start, end - start));
+    }
+    start = end + 1;
+  }
+  return components;
+}
+
+/// Match the character class that starts at pattern[pos], which is a "[". Sets pos to the character after the
+/// closing "]". Returns false if the class doesn't match c, or if it isn't closed in which case "[" is a literal.
+static bool matchCharClass(const std::string_view pattern, std::size_t& pos, const char c) {
+  std::size_t i       = pos + 1;
+  const bool  negated = i < pattern.size() && (pattern[i] == '!' || pattern[i] == '^');
+  if (negated) {
+    i++;
+  }
+
+  bool matched = false;
+  // A "]" right after the opening "[" is part of the class
+  for (bool first = true; i < pattern.size() && (first || pattern[i] != ']'); first = false) {
+    const char lo = pattern[i];
+    char       hi = lo;
+    if (i + 2 < pattern.size() && pattern[i + 1] == '-' && pattern[i + 2] != ']') {
+      hi = pattern[i + 2];
+      i += 2;
+    }
+    matched = matched || (lo <= c && c <= hi);
+    i++;
+  }
+
+  if (i >= pattern.size()) {
+    // Unclosed class, so the "[" is matched literally
+    pos++;
+    return c == '[';
+  }
+  pos = i + 1;
+  return matched != negated;
+}
+
+bool hdoc::utils::isGlobMatch(const std::string_view pattern, const std::string_view s) {
+  std::size_t p     = 0;
+  std::size_t i     = 0;
+  std::size_t starP = std::string_view::npos; // Position in pattern after the last "*"
+  std::size_t starI = 0;                      // Position in s that the last "*" was matched up to
+
+  while (i < s.size()) {
+    if (p < pattern.size() && pattern[p] == '*') {
+      starP = ++p;
+      starI = i;
+      continue;
+    }
+    if (p < pattern.size()) {
+      std::size_t next    = p + 1;
+      bool        matched = false;
+      if (pattern[p] == '?') {
+        matched = true;
+      } else if (pattern[p] == '[') {
+        next    = p;
+        matched = matchCharClass(pattern, next, s[i]);
+      } else if (pattern[p] == '\\' && p + 1 < pattern.size()) {
+        next    = p + 2;
+        matched = pattern[p + 1] == s[i];
+      } else {
+        matched = pattern[p] == s[i];
+      }
+      if (matched) {
+        p = next;
+        i++;
+        continue;
+      }
+    }
+    // Let the last "*" match one more character and try again
+    if (starP == std::string_view::npos) {
+      return false;
+    }
+    p = starP;
+    i = ++starI;
+  }
+
+  while (p < pattern.size() && pattern[p] == '*') {
+    p++;
+  }
+  return p == pattern.size();
+}
+
+/// Match the glob components starting at g against the path components starting at c.
+static bool matchComponents(const std::vector<std::string>&      glob,
+                            std::size_t                          g,
+                            const std::vector<std::string_view>& path,
+                            std::size_t                          c) {
+  for (; g < glob.size(); g++, c++) {
+    if (glob[g] == "**") {
+      // A trailing "**" matches everything inside a directory, but not the directory itself
+      if (g + 1 == glob.size()) {
+        return c < path.size();
+      }
+      for (std::size_t skip = c; skip <= path.size(); skip++) {
+        if (matchComponents(glob, g + 1, path, skip)) {
+          return true;
+        }
+      }
+      return false;
+    }
+    if (c == path.size() || hdoc::utils::isGlobMatch(glob[g], path[c]) == false) {
+      return false;
+    }
+  }
+  return c == path.size();
+}
+
+hdoc::utils::PathMatcher::PathMatcher(const std::vector<std::string>& patterns) : substrings(getSubstrings(patterns)) {
+  for (const auto& pattern : patterns) {
+    if (isGlob(pattern) == false) {
+      continue;
+    }
+
+    const std::size_t      last    = pattern.find_last_not_of('/');
+    const std::string_view trimmed = std::string_view(pattern).substr(0, last + 1);
+
+    Glob glob;
+    glob.isDirOnly  = last + 1 < pattern.size();
+    glob.components = splitPath<std::string>(trimmed);
+    // Like in .gitignore, globs with a "/" before the last component are anchored to the root
+    if (trimmed.find('/') == std::string_view::npos) {
+      glob.components.insert(glob.components.begin(), "**");
+    }
+    glob.contents = glob.components;
+    glob.contents.emplace_back("**");
+    this->globs.emplace_back(std::move(glob));
+  }
+}
+
+bool hdoc::utils::PathMatcher::isMatch(const std::string_view path) const {
+  if (this->substrings.isMatch(path)) {
+    return true;
+  }
+  if (this->globs.empty()) {
+    return false;
+  }
+
+  const std::vector<std::string_view> components = splitPath<std::string_view>(path);
+  for (const auto& glob : this->globs) {
+    if (glob.isDirOnly == false && matchComponents(glob.components, 0, components, 0)) {
+      return true;
+    }
+    if (matchComponents(glob.contents, 0, components, 0)) {
+      return true;
+    }
+  }
+  return false;
+}
@@ -0,0 +1,53 @@
+// Copyright 2019-2023 hdoc
+// SPDX-License-Identifier: AGPL-3.0-only
+
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "support/SubstringMatcher.hpp"
+
+namespace hdoc::utils {
+/// @brief Checks if a path relative to the root of a project matches any of a list of ignore patterns.
+///
+/// Patterns without any of the glob characters `*`, `?`, or `[` match paths that contain them as a substring.
+/// All other patterns are gitignore-style globs:
+///  - `*` matches any characters except `/`, `?` matches one character except `/`, and `[...]` matches one
+///    character in a set, which can contain ranges like `a-z` and can be negated with a leading `!` or `^`.
+///  - `**` as a whole path component matches any number of directories.
+///  - A glob with a `/` at the start or in the middle is anchored to the root of the project. Otherwise it matches
+///    at any depth, so `*.pb.h` matches generated headers in every directory.
+///  - A glob matches a path if it matches the path itself or any of its parent directories. A glob that ends with
+///    `/` only matches directories.
+///
+/// Substrings are compiled into a single automaton, and globs are split into path components once when the
+/// PathMatcher is created. The same instance can be used from several threads at once.
+class PathMatcher {
+public:
+  PathMatcher(const std::vector<std::string>& patterns);
+
+  /// @brief Check if path matches any of the patterns.
+  bool isMatch(const std::string_view path) const;
+
+  /// @brief Check if there are no patterns, in which case nothing matches.
+  bool empty() const {
+    return this->substrings.empty() && this->globs.empty();
+  }
+
+private:
+  /// A glob split into path components
+  struct Glob {
+    std::vector<std::string> components; ///< Matched against the path, or against one of its parent directories
+    std::vector<std::string> contents;   ///< Components followed by `**`, to match files inside a directory
+    bool                     isDirOnly;  ///< Did the glob end with a `/`?
+  };
+
+  SubstringMatcher  substrings; ///< Patterns that aren't globs
+  std::vector<Glob> globs;      ///< Patterns that are globs
+};
+
+/// @brief Check if s matches the glob pattern, where `*` and `?` also match `/`. `**` isn't treated specially.
+bool isGlobMatch(const std::string_view pattern, const std::string_view s);
+} // namespace hdoc::utils
@@ -4,6 +4,9 @@
 #include "support/StringUtils.hpp"
 
 #include <algorithm>
+#include <charconv>
+
+#include "llvm/ADT/SmallVector.h"
 
 namespace hdoc::utils {
 void ltrim(std::string& s) {
@@ -39,4 +42,82 @@ std::size_t replaceFirst(std::string& str, const std::string& oldvalue, const st
   return index + newvalue.size();
 }
 
+bool replaceTemplateTypeParams(std::string&                                               str,
+                               std::string&                                               buf,
+                               llvm::function_ref<const std::string*(uint64_t, uint64_t)> getName,
+                               llvm::MutableArrayRef<uint64_t>                            offsets) {
+  static constexpr std::string_view prefix = "type-parameter-";
+
+  std::size_t pos = str.find(prefix);
+  if (pos == std::string::npos) {
+    return false;
+  }
+
+  // Offsets are compared against the original positions, and shifted by the difference in length of every
+  // placeholder that ends before them
+  const llvm::SmallVector<uint64_t, 4> original(offsets.begin(), offsets.end());
+  const char* const                    end    = str.data() + str.size();
+  std::size_t                          copied = 0; // Characters of str before this are already in buf
+  buf.clear();
+  while (pos != std::string::npos) {
+    uint64_t   depth = 0;
+    uint64_t   index = 0;
+    const auto d     = std::from_chars(str.data() + pos + prefix.size(), end, depth);
+    if (d.ec == std::errc() && d.ptr != end && *d.ptr == '-') {
+      const auto i = std::from_chars(d.ptr + 1, end, index);
+      if (i.ec == std::errc()) {
+        if (const std::string* name = getName(depth, index)) {
+          const std::size_t placeholderEnd = i.ptr - str.data();
+          for (std::size_t j = 0; j < offsets.size(); j++) {
+            if (original[j] >= placeholderEnd) {
+              offsets[j] = offsets[j] + name->size() - (placeholderEnd - pos);
+            }
+          }
+          buf.append(str, copied, pos - copied);
+          buf += *name;
+          copied = placeholderEnd;
+          pos    = str.find(prefix, copied);
+          continue;
+        }
+      }
+    }
+    pos = str.find(prefix, pos + prefix.size());
+  }
+
+  if (copied == 0) {
+    return false;
+  }
+  buf.append(str, copied);
+  str.swap(buf);
+  return true;
+}
+
+void appendLines(std::string& out, const std::vector<std::string>& lines) {
+  out += std::to_string(lines.size()) + "\n";
+  for (const auto& line : lines) {
+    out += line + "\n";
+  }
+}
+
+bool consumeLines(std::string_view& data, std::vector<std::string>& lines) {
+  std::size_t       count  = 0;
+  const auto        result = std::from_chars(data.data(), data.data() + data.size(), count);
+  const std::size_t digits = result.ptr - data.data();
+  if (result.ec != std::errc() || digits >= data.size() || data[digits] != '\n') {
+    return false;
+  }
+  data.remove_prefix(digits + 1);
+
+  lines.clear();
+  for (std::size_t i = 0; i < count; i++) {
+    const std::size_t end = data.find('\n');
+    if (end == std::string_view::npos) {
+      return false;
+    }
+    lines.emplace_back(data.substr(0, end));
+    data.remove_prefix(end + 1);
+  }
+  return true;
+}
+
 } // namespace hdoc::utils
@@ -3,7 +3,13 @@
 
 #pragma once
 
+#include <cstdint>
 #include <string>
+#include <string_view>
+#include <vector>
+
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/STLFunctionalExtras.h"
 
 namespace hdoc::utils {
 /// Trim any leading spaces in str.
@@ -22,4 +28,22 @@ std::string replaceAll(std::string& str, const std::string& oldvalue, const std:
 /// Optionally start the search after pos.
 std::size_t
 replaceFirst(std::string& str, const std::string& oldvalue, const std::string& newvalue, std::size_t pos = 0);
+
+/// Replace each "type-parameter-D-I" in str, which is how clang spells the I-th template type parameter at depth D
+/// when it can't name it, with the string returned by getName(D, I). Placeholders for which getName() returns nullptr
+/// are left as they are. All placeholders are replaced in a single scan, which uses buf as scratch space so that it
+/// can be reused across calls. The positions in offsets are moved along with the characters of str they point at.
+/// Returns true if str was changed.
+bool replaceTemplateTypeParams(std::string&                                               str,
+                               std::string&                                               buf,
+                               llvm::function_ref<const std::string*(uint64_t, uint64_t)> getName,
+                               llvm::MutableArrayRef<uint64_t>                            offsets = {});
+
+/// Append the number of lines in lines to out, followed by each of them on a separate line.
+/// None of the lines may contain a newline.
+void appendLines(std::string& out, const std::vector<std::string>& lines);
+
+/// Read lines written by appendLines() from the front of data and advance data past them.
+/// Returns false if data doesn't start with a complete list of lines.
+bool consumeLines(std::string_view& data, std::vector<std::string>& lines);
 } // namespace hdoc::utils
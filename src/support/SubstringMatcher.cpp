@@ -0,0 +1,70 @@
+// Copyright 2019-2023 hdoc
+// SPDX-License-Identifier: AGPL-3.0-only
+
+#include "support/SubstringMatcher.hpp"
+
+#include <deque>
+
+hdoc::utils::SubstringMatcher::SubstringMatcher(const std::vector<std::string>& substrings) : nodes(1) {
+  // Build a trie of all substrings
+  for (const auto& substr : substrings) {
+    uint32_t node = 0;
+    for (const char c : substr) {
+      uint32_t child = this->getChild(node, c);
+      if (child == 0) {
+        child = this->nodes.size();
+        this->nodes[node].children.emplace_back(c, child);
+        this->nodes.emplace_back();
+      }
+      node = child;
+    }
+    this->nodes[node].isMatch = true;
+  }
+
+  // Link each node to the node of its longest proper suffix, breadth-first so that the links of shorter
+  // prefixes are known before they're needed. A node also matches if its suffix does.
+  std::deque<uint32_t> queue;
+  for (const auto& [c, child] : this->nodes[0].children) {
+    queue.push_back(child);
+  }
+  while (queue.empty() == false) {
+    const uint32_t node = queue.front();
+    queue.pop_front();
+    for (const auto& [c, child] : this->nodes[node].children) {
+      uint32_t fail = this->nodes[node].fail;
+      while (fail != 0 && this->getChild(fail, c) == 0) {
+        fail = this->nodes[fail].fail;
+      }
+      this->nodes[child].fail = this->getChild(fail, c);
+      this->nodes[child].isMatch |= this->nodes[this->nodes[child].fail].isMatch;
+      queue.push_back(child);
+    }
+  }
+}
+
+uint32_t hdoc::utils::SubstringMatcher::getChild(const uint32_t node, const char c) const {
+  for (const auto& [childChar, child] : this->nodes[node].children) {
+    if (childChar == c) {
+      return child;
+    }
+  }
+  return 0;
+}
+
+bool hdoc::utils::SubstringMatcher::isMatch(const std::string_view s) const {
+  if (this->nodes[0].isMatch) {
+    return true;
+  }
+
+  uint32_t node = 0;
+  for (const char c : s) {
+    while (node != 0 && this->getChild(node, c) == 0) {
+      node = this->nodes[node].fail;
+    }
+    node = this->getChild(node, c);
+    if (this->nodes[node].isMatch) {
+      return true;
+    }
+  }
+  return false;
+}
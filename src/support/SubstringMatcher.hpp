@@ -0,0 +1,42 @@
+// Copyright 2019-2023 hdoc
+// SPDX-License-Identifier: AGPL-3.0-only
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace hdoc::utils {
+/// @brief Checks if a string contains any of a list of substrings, in a single pass over the string.
+///
+/// The substrings are compiled into an Aho-Corasick automaton, so the cost of a check depends on the length of the
+/// string rather than on the number of substrings. The same instance can be used from several threads at once.
+class SubstringMatcher {
+public:
+  SubstringMatcher(const std::vector<std::string>& substrings);
+
+  /// @brief Check if s contains any of the substrings. Always true if one of them is empty.
+  bool isMatch(const std::string_view s) const;
+
+  /// @brief Check if there are no substrings, in which case nothing matches.
+  bool empty() const {
+    return this->nodes.size() == 1 && this->nodes[0].isMatch == false;
+  }
+
+private:
+  /// A node of the trie of all substrings, which represents the prefix spelled by the path from the root to it.
+  struct Node {
+    std::vector<std::pair<char, uint32_t>> children;        ///< Next character and the node it leads to
+    uint32_t                               fail    = 0;     ///< Node of the longest proper suffix that's in the trie
+    bool                                   isMatch = false; ///< Does the prefix end with any of the substrings?
+  };
+
+  /// Get the child of node for character c, or 0 if there is none.
+  uint32_t getChild(const uint32_t node, const char c) const;
+
+  std::vector<Node> nodes; ///< Nodes of the trie, the root is nodes[0]
+};
+} // namespace hdoc::utils
@@ -0,0 +1,205 @@
+// Copyright 2019-2023 hdoc
+// SPDX-License-Identifier: AGPL-3.0-only
+
+#include "support/ZipWriter.hpp"
+
+#include <algorithm>
+
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/Support/CRC.h"
+#include "spdlog/spdlog.h"
+
+// Signatures and constants of the ZIP file format, see APPNOTE.TXT by PKWARE
+static constexpr uint32_t localFileHeaderSignature      = 0x04034b50;
+static constexpr uint32_t centralDirectorySignature     = 0x02014b50;
+static constexpr uint32_t endOfCentralDirSignature      = 0x06054b50;
+static constexpr uint32_t zip64EndOfCentralDirSignature = 0x06064b50;
+static constexpr uint32_t zip64LocatorSignature         = 0x07064b50;
+static constexpr uint16_t zip64ExtraFieldID             = 0x0001;
+static constexpr uint16_t versionNeeded                 = 20;            // 2.0, which added directories
+static constexpr uint16_t versionNeededZip64            = 45;            // 4.5, which added ZIP64
+static constexpr uint16_t versionMadeBy                 = (3 << 8) | 45; // Made on Unix
+static constexpr uint16_t flagUTF8Names                 = 1 << 11;
+static constexpr uint16_t methodStored                  = 0;
+static constexpr uint16_t dosDate                       = (1 << 5) | 1;   // 1980-01-01, the earliest possible date
+static constexpr uint32_t externalAttributes            = 0100644u << 16; // Regular file, rw-r--r--
+static constexpr uint32_t max32                         = 0xffffffff;
+static constexpr uint16_t max16                         = 0xffff;
+
+static void append16(std::string& out, const uint16_t v) {
+  out += static_cast<char>(v & 0xff);
+  out += static_cast<char>(v >> 8);
+}
+
+static void append32(std::string& out, const uint32_t v) {
+  append16(out, static_cast<uint16_t>(v & 0xffff));
+  append16(out, static_cast<uint16_t>(v >> 16));
+}
+
+static void append64(std::string& out, const uint64_t v) {
+  append32(out, static_cast<uint32_t>(v & 0xffffffff));
+  append32(out, static_cast<uint32_t>(v >> 32));
+}
+
+hdoc::utils::ZipWriter::~ZipWriter() {
+  if (this->pending.is_open()) {
+    this->pending.close();
+    std::error_code ec;
+    std::filesystem::remove(this->pendingPath, ec);
+  }
+}
+
+bool hdoc::utils::ZipWriter::open(const std::filesystem::path& path) {
+  this->out.open(path, std::ios::binary | std::ios::trunc);
+  if (!this->out) {
+    spdlog::error("Failed to create archive {}.", path.string());
+    return false;
+  }
+
+  this->pendingPath = path;
+  this->pendingPath += ".pending";
+  this->pending.open(this->pendingPath, std::ios::binary | std::ios::in | std::ios::out | std::ios::trunc);
+  if (!this->pending) {
+    spdlog::error("Failed to create {}.", this->pendingPath.string());
+    return false;
+  }
+  return true;
+}
+
+bool hdoc::utils::ZipWriter::add(const std::string_view name, const std::string_view contents) {
+  // Single files are pages and assets, which are far smaller than 4 GB, so only offsets may need ZIP64 fields
+  if (contents.size() >= max32 || name.size() >= max16) {
+    spdlog::error("{} is too large to be added to the archive.", name);
+    return false;
+  }
+
+  // The checksum is the expensive part, so it's computed before taking the lock
+  const uint32_t crc =
+      llvm::crc32(llvm::ArrayRef<uint8_t>(reinterpret_cast<const uint8_t*>(contents.data()), contents.size()));
+
+  std::lock_guard<std::mutex> lock(this->mutex);
+  // Readers of the archive would only find one of two files with the same name, and which one would depend on the
+  // order they were added in, so files with a name that's already taken are rejected
+  const auto [it, inserted] = this->names.insert(name);
+  if (inserted == false) {
+    spdlog::error("{} was already added to the archive.", name);
+    return false;
+  }
+  this->pending.write(contents.data(), contents.size());
+  if (!this->pending) {
+    spdlog::error("Failed to add {} to the archive.", name);
+    this->failed = true;
+    return false;
+  }
+  this->entries.emplace_back(Entry{it->getKey(), crc, contents.size(), this->pendingSize, 0});
+  this->pendingSize += contents.size();
+  return true;
+}
+
+bool hdoc::utils::ZipWriter::close() {
+  std::lock_guard<std::mutex> lock(this->mutex);
+
+  // Copy the contents of each file from the pending file, preceded by its local header, in the order of the names.
+  // Names are unique, so the order doesn't depend on the order files were added in.
+  std::sort(this->entries.begin(), this->entries.end(), [](const Entry& a, const Entry& b) { return a.name < b.name; });
+  uint64_t    offset = 0;
+  std::string buf;
+  this->pending.flush();
+  for (auto& e : this->entries) {
+    buf.clear();
+    append32(buf, localFileHeaderSignature);
+    append16(buf, versionNeeded);
+    append16(buf, flagUTF8Names);
+    append16(buf, methodStored);
+    append16(buf, 0); // Time
+    append16(buf, dosDate);
+    append32(buf, e.crc);
+    append32(buf, static_cast<uint32_t>(e.size)); // Compressed size
+    append32(buf, static_cast<uint32_t>(e.size)); // Uncompressed size
+    append16(buf, static_cast<uint16_t>(e.name.size()));
+    append16(buf, 0); // Extra field length
+    buf += e.name;
+
+    const uint64_t headerSize = buf.size();
+    buf.resize(headerSize + e.size);
+    this->pending.seekg(e.pendingOffset);
+    this->pending.read(buf.data() + headerSize, e.size);
+    this->out.write(buf.data(), buf.size());
+    e.offset = offset;
+    offset += buf.size();
+  }
+  if (!this->pending || !this->out) {
+    spdlog::error("Failed to copy files into the archive.");
+    this->failed = true;
+  }
+  this->pending.close();
+  std::error_code ec;
+  std::filesystem::remove(this->pendingPath, ec);
+
+  std::string    centralDir;
+  const uint64_t centralDirOffset = offset;
+  for (const auto& e : this->entries) {
+    const bool zip64 = e.offset >= max32;
+    append32(centralDir, centralDirectorySignature);
+    append16(centralDir, versionMadeBy);
+    append16(centralDir, zip64 ? versionNeededZip64 : versionNeeded);
+    append16(centralDir, flagUTF8Names);
+    append16(centralDir, methodStored);
+    append16(centralDir, 0); // Time
+    append16(centralDir, dosDate);
+    append32(centralDir, e.crc);
+    append32(centralDir, static_cast<uint32_t>(e.size)); // Compressed size
+    append32(centralDir, static_cast<uint32_t>(e.size)); // Uncompressed size
+    append16(centralDir, static_cast<uint16_t>(e.name.size()));
+    append16(centralDir, zip64 ? 12 : 0); // Extra field length
+    append16(centralDir, 0);              // Comment length
+    append16(centralDir, 0);              // Disk number
+    append16(centralDir, 0);              // Internal attributes
+    append32(centralDir, externalAttributes);
+    append32(centralDir, zip64 ? max32 : static_cast<uint32_t>(e.offset));
+    centralDir += e.name;
+    if (zip64) {
+      append16(centralDir, zip64ExtraFieldID);
+      append16(centralDir, 8);
+      append64(centralDir, e.offset);
+    }
+  }
+
+  const uint64_t centralDirSize = centralDir.size();
+  const uint64_t numEntries     = this->entries.size();
+  if (numEntries >= max16 || centralDirOffset >= max32 || centralDirSize >= max32) {
+    const uint64_t zip64EndOfCentralDirOffset = centralDirOffset + centralDirSize;
+    append32(centralDir, zip64EndOfCentralDirSignature);
+    append64(centralDir, 44); // Size of the rest of this record
+    append16(centralDir, versionMadeBy);
+    append16(centralDir, versionNeededZip64);
+    append32(centralDir, 0); // Number of this disk
+    append32(centralDir, 0); // Disk where the central directory starts
+    append64(centralDir, numEntries);
+    append64(centralDir, numEntries);
+    append64(centralDir, centralDirSize);
+    append64(centralDir, centralDirOffset);
+
+    append32(centralDir, zip64LocatorSignature);
+    append32(centralDir, 0); // Disk with the ZIP64 end of central directory record
+    append64(centralDir, zip64EndOfCentralDirOffset);
+    append32(centralDir, 1); // Number of disks
+  }
+
+  append32(centralDir, endOfCentralDirSignature);
+  append16(centralDir, 0); // Number of this disk
+  append16(centralDir, 0); // Disk where the central directory starts
+  append16(centralDir, numEntries >= max16 ? max16 : static_cast<uint16_t>(numEntries));
+  append16(centralDir, numEntries >= max16 ? max16 : static_cast<uint16_t>(numEntries));
+  append32(centralDir, centralDirSize >= max32 ? max32 : static_cast<uint32_t>(centralDirSize));
+  append32(centralDir, centralDirOffset >= max32 ? max32 : static_cast<uint32_t>(centralDirOffset));
+  append16(centralDir, 0); // Comment length
+
+  this->out.write(centralDir.data(), centralDir.size());
+  this->out.close();
+  if (!this->out || this->failed) {
+    spdlog::error("Failed to write the archive.");
+    return false;
+  }
+  return true;
+}
@@ -0,0 +1,67 @@
+// Copyright 2019-2023 hdoc
+// SPDX-License-Identifier: AGPL-3.0-only
+
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "llvm/ADT/StringRef.h"
+#include "llvm/ADT/StringSet.h"
+
+namespace hdoc::utils {
+/// @brief Writes files into a single uncompressed ZIP archive.
+///
+/// Files are stored as they are, so a server can send a file straight from the archive by looking up its offset in
+/// the central directory. ZIP64 records are added when the archive has more than 65535 files or grows past 4 GB.
+///
+/// Files are added from many threads in no particular order. Their contents are collected in a temporary file next
+/// to the archive, and close() copies them into the archive sorted by name. Together with giving all files the same
+/// timestamp, this makes archives of the same documentation identical.
+class ZipWriter {
+public:
+  /// Removes the pending file if the archive was never closed.
+  ~ZipWriter();
+
+  /// @brief Create the archive at path. Returns false if it couldn't be created.
+  bool open(const std::filesystem::path& path);
+
+  /// @brief Add contents to the archive as a file called name, which uses '/' to separate directories.
+  /// Returns false if it couldn't be written or if a file with the same name was already added, in which case the
+  /// archive keeps the first one. Safe to call from multiple threads at once.
+  bool add(const std::string_view name, const std::string_view contents);
+
+  /// @brief Write the files sorted by name and the central directory that indexes them, and close the archive.
+  /// Returns false if any part of the archive couldn't be written.
+  bool close();
+
+  /// @brief Get the number of files in the archive. Must not be called while files are being added.
+  uint64_t size() const {
+    return this->entries.size();
+  }
+
+private:
+  /// Location and checksum of a file, which go into its local header and the central directory
+  struct Entry {
+    llvm::StringRef name; ///< Points into names
+    uint32_t        crc;
+    uint64_t        size;
+    uint64_t        pendingOffset; ///< Offset of the contents in the pending file
+    uint64_t        offset;        ///< Offset of the local header in the archive, set by close()
+  };
+
+  std::ofstream         out;             ///< The archive, which is only written to by close()
+  std::filesystem::path pendingPath;     ///< Path of the file that collects the contents of files until close()
+  std::mutex            mutex;           ///< Guards everything below
+  std::fstream          pending;         ///< Contents of all files, in the order they were added
+  uint64_t              pendingSize = 0; ///< Number of bytes written to the pending file
+  std::vector<Entry>    entries;         ///< Files in the order they were added
+  llvm::StringSet<>     names;           ///< Names of all files, which must be unique
+  bool                  failed = false;  ///< Set if any write failed
+};
+} // namespace hdoc::utils
@@ -40,9 +40,23 @@ struct Config {
   std::filesystem::path    homepage;                     ///< Path to "homepage" markdown file
   std::vector<std::filesystem::path> mdPaths;            ///< Paths to markdown pages
   bool                     minimalOutput = false;        ///< Should the output be minimal? I.e. no sidebar, header etc, just the main content
+  bool                     sharedLayout = false;         ///< Load the sidebar and footer of all pages from layout.js
+  std::filesystem::path    outputArchive;                ///< ZIP archive that all output is packed into (empty == none)
+  std::filesystem::path    cacheDir;                     ///< Directory where indexed TUs are cached (empty == no caching)
+  bool                     deduplicateHeaders = false;   ///< Only index each header in the first TU that includes it
+  std::filesystem::path    precompiledHeader;            ///< Umbrella header precompiled once for all TUs (empty == none)
+  bool                     coveringTUsOnly = false;      ///< Only index the TUs needed to reach every header
+  bool                     skipFunctionBodies = false;   ///< Don't parse function bodies that aren't needed
+  bool                     pruneAST = false;             ///< Skip ignored subtrees of the AST while indexing
+  bool                     isolateTUs = false;           ///< Index each TU in a separate worker process
+  uint32_t                 workerMemoryLimit = 0;        ///< Memory limit of worker processes in MB (0 == no limit)
+  std::filesystem::path    executablePath;               ///< Path of the hdoc binary, used to launch workers
+  std::filesystem::path    workerRequest;                ///< Set if this process is a worker, see WorkerRequest
+  std::filesystem::path    coverageReport;               ///< Where to write which TUs reach each header (empty == none)
 
-  uint32_t debugLimitNumIndexedFiles;    ///< Limit the number of files to index (0 == index all files)
-  bool     debugDumpJSONPayload = false; ///< Dump JSON payload to current working directory
+  uint32_t              debugLimitNumIndexedFiles;    ///< Limit the number of files to index (0 == index all files)
+  bool                  debugDumpJSONPayload = false; ///< Dump JSON payload to current working directory
+  std::filesystem::path debugPerfReport;              ///< Where to write timing and memory usage (empty == none)
 
   /// @brief Returns a string with the form "PROJECT_NAME PROJECT_VERSION documentation"
   /// if this->projectVersion has a value, otherwise returns "PROJECT_NAME documentation".
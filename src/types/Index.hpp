@@ -4,44 +4,57 @@
 #pragma once
 
 #include <atomic>
-#include <mutex>
-#include <unordered_map>
+#include <map>
 #include <utility>
 #include <vector>
 
+#include "types/SymbolMap.hpp"
 #include "types/Symbols.hpp"
 
 namespace hdoc::types {
 /// @brief Stores values for a given type of Symbol
+///
+/// During indexing, matchers on many threads add symbols concurrently using claim() and update(), which only lock
+/// the shard of entries that the symbol belongs to. All other accesses happen once indexing is complete and
+/// don't lock at all.
 template <typename T> struct Database {
-  std::atomic<uint32_t>                        numMatches = 0; ///< Number of matches
-  std::unordered_map<hdoc::types::SymbolID, T> entries;        ///< Hashmap that stores the entries
+  std::atomic<uint32_t>     numMatches = 0; ///< Number of matches
+  hdoc::types::SymbolMap<T> entries;        ///< Sharded hashmap that stores the entries
+
+  /// @brief Atomically reserve an empty entry for the given SymbolID, to be filled in later with update().
+  /// Returns false if the SymbolID was already claimed, in which case the caller must not index the symbol again.
+  bool claim(const hdoc::types::SymbolID& id) {
+    const auto lock = this->entries.lock(id);
+    return this->entries.try_emplace(id).second;
+  }
 
   /// @brief Reserve a space for the given SymbolID, to be updated later
-  T& reserve(const hdoc::types::SymbolID& id) {
-    this->mutex.lock();
-    this->entries.insert(std::make_pair(id, T()));
-    this->mutex.unlock();
-    return this->entries[id];
+  void reserve(const hdoc::types::SymbolID& id) {
+    this->claim(id);
   }
 
   /// @brief Update the entry for a given SymbolID
   void update(const hdoc::types::SymbolID& id, const T& symbol) {
-    this->mutex.lock();
+    const auto lock   = this->entries.lock(id);
     this->entries[id] = symbol;
-    this->mutex.unlock();
   }
 
-  /// @brief Check if the Database contains a key
+  /// @brief Update the entry for a given SymbolID, taking ownership of symbol's strings and vectors
+  void update(const hdoc::types::SymbolID& id, T&& symbol) {
+    const auto lock   = this->entries.lock(id);
+    this->entries[id] = std::move(symbol);
+  }
+
+  /// @brief Check if the Database contains a key. Must not be called while symbols are being added.
   bool contains(const hdoc::types::SymbolID& id) const {
-    this->mutex.lock();
-    bool res = !(this->entries.find(id) == this->entries.end());
-    this->mutex.unlock();
-    return res;
+    return this->entries.contains(id);
   }
 
-  /// Locks the database during operations that may cause mutations
-  mutable std::mutex mutex;
+  /// @brief Remove all entries. Must not be called while symbols are being added.
+  void clear() {
+    this->numMatches = 0;
+    this->entries.clear();
+  }
 };
 
 /// @brief hdoc's index, aggregating information for all of the symbols in a codebase
@@ -52,5 +65,15 @@ struct Index {
   Database<hdoc::types::NamespaceSymbol> namespaces;
   Database<hdoc::types::AliasSymbol>     aliases;
   std::map<FreestandingFunctionID, FreestandingFunction> freestandingFunctions;
+
+  /// @brief Remove all symbols. Must not be called while symbols are being added.
+  void clear() {
+    this->functions.clear();
+    this->records.clear();
+    this->enums.clear();
+    this->namespaces.clear();
+    this->aliases.clear();
+    this->freestandingFunctions.clear();
+  }
 };
 } // namespace hdoc::types
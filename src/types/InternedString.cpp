@@ -0,0 +1,73 @@
+// Copyright 2019-2023 hdoc
+// SPDX-License-Identifier: AGPL-3.0-only
+
+#include "types/InternedString.hpp"
+
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+
+namespace {
+/// Strings are appended to a deque, which never moves its elements, so handles and the string_view keys that
+/// point into the strings stay valid. The pool is split into shards so that threads rarely wait for each other.
+struct PoolShard {
+  std::mutex                                               mutex;
+  std::deque<std::string>                                  strings;
+  std::unordered_map<std::string_view, const std::string*> index;
+};
+
+constexpr uint32_t numPoolShards = 64;
+
+PoolShard* getPoolShards() {
+  // Intentionally leaked so that handles stay valid while other static objects are destroyed
+  static PoolShard* shards = new PoolShard[numPoolShards];
+  return shards;
+}
+} // namespace
+
+const std::string* hdoc::types::InternedString::intern(const std::string_view s) {
+  if (s.empty()) {
+    return nullptr;
+  }
+
+  const std::size_t hash  = std::hash<std::string_view>{}(s);
+  PoolShard&        shard = getPoolShards()[hash % numPoolShards];
+
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  if (const auto it = shard.index.find(s); it != shard.index.end()) {
+    return it->second;
+  }
+  const std::string& pooled = shard.strings.emplace_back(s);
+  shard.index.emplace(pooled, &pooled);
+  return &pooled;
+}
+
+uint64_t hdoc::types::InternedString::getPoolSize() {
+  uint64_t size = 0;
+  for (uint32_t i = 0; i < numPoolShards; i++) {
+    PoolShard&                  shard = getPoolShards()[i];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    size += shard.strings.size();
+  }
+  return size;
+}
+
+uint64_t hdoc::types::InternedString::getPoolHeapBytes() {
+  using IndexEntry = std::pair<const std::string_view, const std::string*>;
+
+  uint64_t bytes = 0;
+  for (uint32_t i = 0; i < numPoolShards; i++) {
+    PoolShard&                  shard = getPoolShards()[i];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    bytes += shard.strings.size() * sizeof(std::string);
+    for (const auto& s : shard.strings) {
+      // Short strings are stored inside the std::string itself
+      if (s.capacity() > std::string().capacity()) {
+        bytes += s.capacity() + 1;
+      }
+    }
+    bytes += shard.index.bucket_count() * sizeof(void*) + shard.index.size() * (sizeof(IndexEntry) + sizeof(void*));
+  }
+  return bytes;
+}
@@ -0,0 +1,71 @@
+// Copyright 2019-2023 hdoc
+// SPDX-License-Identifier: AGPL-3.0-only
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace hdoc::types {
+/// @brief Handle to an immutable string that's stored once in a process-wide pool, no matter how many
+/// symbols refer to it.
+///
+/// Used for strings that repeat across huge numbers of symbols, like file paths and type names.
+/// A handle is the size of a pointer, so copying it doesn't allocate and comparing two handles is a pointer
+/// comparison. Strings in the pool are never freed. Handles can be created from any thread.
+class InternedString {
+public:
+  InternedString() = default;
+  InternedString(const std::string_view s) : ptr(intern(s)) {}
+  InternedString(const std::string& s) : ptr(intern(s)) {}
+  InternedString(const char* s) : ptr(intern(s)) {}
+
+  const std::string& str() const {
+    return this->ptr == nullptr ? emptyString : *this->ptr;
+  }
+
+  operator const std::string&() const {
+    return this->str();
+  }
+
+  operator std::string_view() const {
+    return this->str();
+  }
+
+  bool empty() const {
+    return this->ptr == nullptr;
+  }
+
+  std::size_t size() const {
+    return this->str().size();
+  }
+
+  /// Equal strings are interned to the same handle, so comparing handles is enough
+  bool operator==(const InternedString& rhs) const {
+    return this->ptr == rhs.ptr;
+  }
+
+  bool operator==(const std::string& rhs) const {
+    return this->str() == rhs;
+  }
+
+  bool operator==(const char* rhs) const {
+    return this->str() == rhs;
+  }
+
+  /// @brief Get the number of distinct strings in the pool.
+  static uint64_t getPoolSize();
+
+  /// @brief Get the number of heap bytes taken by the pool, including the strings it holds.
+  static uint64_t getPoolHeapBytes();
+
+private:
+  /// Get the pooled copy of s, adding s to the pool if it isn't there yet. Returns nullptr for empty strings.
+  static const std::string* intern(const std::string_view s);
+
+  static inline const std::string emptyString = "";
+
+  const std::string* ptr = nullptr; ///< The pooled string, nullptr for empty strings
+};
+} // namespace hdoc::types
@@ -0,0 +1,234 @@
+// Copyright 2019-2023 hdoc
+// SPDX-License-Identifier: AGPL-3.0-only
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+
+#include "types/Symbols.hpp"
+
+namespace hdoc::types {
+/// @brief A hash map from SymbolID to T that is split into shards which are locked independently.
+///
+/// Apart from lock(), the interface mirrors std::unordered_map and doesn't do any locking itself.
+/// Code that modifies the map while other threads access it must hold the lock of the shard it touches,
+/// which is only the case for the matchers during indexing. Everything else runs when no thread is writing.
+template <typename T> class SymbolMap {
+  using ShardMap = std::unordered_map<hdoc::types::SymbolID, T>;
+
+  /// SymbolIDs are truncated SHA1 hashes, so their top bits spread symbols evenly across shards.
+  /// The bottom bits are left to pick buckets within each shard.
+  static constexpr uint32_t shardBits = 8;
+  static constexpr uint32_t numShards = 1 << shardBits;
+
+  /// Shards are aligned to separate cache lines so that threads locking neighboring shards don't contend
+  struct alignas(64) Shard {
+    mutable std::mutex mutex;
+    ShardMap           map;
+  };
+
+  template <bool Const> class Iterator {
+    using ShardPtr = std::conditional_t<Const, const Shard*, Shard*>;
+    using InnerIt  = std::conditional_t<Const, typename ShardMap::const_iterator, typename ShardMap::iterator>;
+
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type        = typename ShardMap::value_type;
+    using difference_type   = std::ptrdiff_t;
+    using pointer           = std::conditional_t<Const, const value_type*, value_type*>;
+    using reference         = std::conditional_t<Const, const value_type&, value_type&>;
+
+    Iterator() = default;
+    Iterator(ShardPtr shards, const uint32_t shard, InnerIt it) : shards(shards), shard(shard), it(it) {
+      this->skipExhaustedShards();
+    }
+
+    /// Allow conversion of iterators to const_iterators
+    template <bool OtherConst, typename = std::enable_if_t<Const && !OtherConst>>
+    Iterator(const Iterator<OtherConst>& other) : shards(other.shards), shard(other.shard), it(other.it) {}
+
+    reference operator*() const {
+      return *this->it;
+    }
+
+    pointer operator->() const {
+      return &*this->it;
+    }
+
+    Iterator& operator++() {
+      ++this->it;
+      this->skipExhaustedShards();
+      return *this;
+    }
+
+    Iterator operator++(int) {
+      Iterator tmp = *this;
+      ++*this;
+      return tmp;
+    }
+
+    bool operator==(const Iterator& rhs) const {
+      return this->shard == rhs.shard && (this->shard == numShards || this->it == rhs.it);
+    }
+
+  private:
+    template <bool> friend class Iterator;
+
+    /// Move on to the first element of the next non-empty shard once the current one is exhausted
+    void skipExhaustedShards() {
+      while (this->shard < numShards && this->it == this->shards[this->shard].map.end()) {
+        if (++this->shard < numShards) {
+          this->it = this->shards[this->shard].map.begin();
+        }
+      }
+    }
+
+    ShardPtr shards = nullptr;
+    uint32_t shard  = numShards; ///< Index of the current shard, numShards for the end iterator
+    InnerIt  it     = {};
+  };
+
+  static uint32_t shardIndex(const hdoc::types::SymbolID& id) {
+    return static_cast<uint32_t>(id.raw() >> (64 - shardBits));
+  }
+
+  Shard& shardFor(const hdoc::types::SymbolID& id) {
+    return this->shards[shardIndex(id)];
+  }
+
+  const Shard& shardFor(const hdoc::types::SymbolID& id) const {
+    return this->shards[shardIndex(id)];
+  }
+
+  std::unique_ptr<Shard[]> shards = std::make_unique<Shard[]>(numShards);
+
+public:
+  using key_type       = hdoc::types::SymbolID;
+  using mapped_type    = T;
+  using value_type     = typename ShardMap::value_type;
+  using iterator       = Iterator<false>;
+  using const_iterator = Iterator<true>;
+
+  /// @brief Get the number of shards. A SymbolID is in the same shard in every SymbolMap.
+  static constexpr uint32_t getNumShards() {
+    return numShards;
+  }
+
+  /// @brief Get the map that stores the entries of shard i.
+  /// Different shards can be modified by different threads without locking.
+  std::unordered_map<hdoc::types::SymbolID, T>& getShard(const uint32_t i) {
+    return this->shards[i].map;
+  }
+
+  const std::unordered_map<hdoc::types::SymbolID, T>& getShard(const uint32_t i) const {
+    return this->shards[i].map;
+  }
+
+  /// @brief Lock the shard that id belongs to, see the class description for when this is needed
+  std::unique_lock<std::mutex> lock(const hdoc::types::SymbolID& id) const {
+    return std::unique_lock<std::mutex>(this->shardFor(id).mutex);
+  }
+
+  iterator begin() {
+    return iterator(this->shards.get(), 0, this->shards[0].map.begin());
+  }
+
+  iterator end() {
+    return iterator();
+  }
+
+  const_iterator begin() const {
+    return const_iterator(this->shards.get(), 0, this->shards[0].map.begin());
+  }
+
+  const_iterator end() const {
+    return const_iterator();
+  }
+
+  std::size_t size() const {
+    std::size_t size = 0;
+    for (uint32_t i = 0; i < numShards; i++) {
+      size += this->shards[i].map.size();
+    }
+    return size;
+  }
+
+  bool empty() const {
+    return this->size() == 0;
+  }
+
+  /// @brief Spread capacity for n elements evenly across all shards
+  void reserve(const std::size_t n) {
+    for (uint32_t i = 0; i < numShards; i++) {
+      this->shards[i].map.reserve(n / numShards + 1);
+    }
+  }
+
+  void clear() {
+    for (uint32_t i = 0; i < numShards; i++) {
+      this->shards[i].map.clear();
+    }
+  }
+
+  bool contains(const hdoc::types::SymbolID& id) const {
+    return this->shardFor(id).map.contains(id);
+  }
+
+  iterator find(const hdoc::types::SymbolID& id) {
+    auto& shard = this->shardFor(id);
+    auto  it    = shard.map.find(id);
+    return it == shard.map.end() ? this->end() : iterator(this->shards.get(), shardIndex(id), it);
+  }
+
+  const_iterator find(const hdoc::types::SymbolID& id) const {
+    const auto& shard = this->shardFor(id);
+    const auto  it    = shard.map.find(id);
+    return it == shard.map.end() ? this->end() : const_iterator(this->shards.get(), shardIndex(id), it);
+  }
+
+  T& at(const hdoc::types::SymbolID& id) {
+    return this->shardFor(id).map.at(id);
+  }
+
+  const T& at(const hdoc::types::SymbolID& id) const {
+    return this->shardFor(id).map.at(id);
+  }
+
+  T& operator[](const hdoc::types::SymbolID& id) {
+    return this->shardFor(id).map[id];
+  }
+
+  template <typename... Args> std::pair<iterator, bool> try_emplace(const hdoc::types::SymbolID& id, Args&&... args) {
+    auto [it, inserted] = this->shardFor(id).map.try_emplace(id, std::forward<Args>(args)...);
+    return {iterator(this->shards.get(), shardIndex(id), it), inserted};
+  }
+
+  std::pair<iterator, bool> emplace(const hdoc::types::SymbolID& id, T&& value) {
+    return this->try_emplace(id, std::move(value));
+  }
+
+  std::pair<iterator, bool> insert(const value_type& value) {
+    return this->try_emplace(value.first, value.second);
+  }
+
+  std::size_t erase(const hdoc::types::SymbolID& id) {
+    return this->shardFor(id).map.erase(id);
+  }
+
+  /// @brief Move the elements of other whose keys aren't in this map into this map, locking each pair of shards
+  /// while doing so. Safe to call from multiple threads as long as other isn't accessed by any other thread.
+  void merge(SymbolMap<T>& other) {
+    for (uint32_t i = 0; i < numShards; i++) {
+      std::lock_guard<std::mutex> lock(this->shards[i].mutex);
+      this->shards[i].map.merge(other.shards[i].map);
+    }
+  }
+};
+} // namespace hdoc::types
@@ -9,7 +9,10 @@
 #include "llvm/ADT/StringExtras.h"
 #include "llvm/Support/SHA1.h"
 
+#include "types/InternedString.hpp"
+
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace hdoc::types {
@@ -55,16 +58,14 @@ struct SymbolID {
 
 /// @brief Base class for all other types of symbols
 struct Symbol {
-  std::string           name         = ""; ///< Function name, record name, enum name etc.
-  std::string           briefComment = ""; ///< Text following @brief or \brief command
-  std::string           docComment   = ""; ///< All other Doxygen text attached to this symbol's documentation
-  hdoc::types::SymbolID ID;                ///< Unique identifier for this Symbol
-  std::string           file = "";         ///< File where this Symbol is declared, relative to source root
-  std::uint64_t         line = 0;          ///< Line number in the file
-  hdoc::types::SymbolID parentNamespaceID; ///< ID of the parent namespace (or record)
-  bool                  isDetail = false;  ///< Is this symbol in a "detail" namespace?
-
-  virtual ~Symbol() = default;
+  std::string                 name         = ""; ///< Function name, record name, enum name etc.
+  std::string                 briefComment = ""; ///< Text following @brief or \brief command
+  std::string                 docComment   = ""; ///< All other Doxygen text attached to this symbol's documentation
+  hdoc::types::SymbolID       ID;                ///< Unique identifier for this Symbol
+  hdoc::types::InternedString file;              ///< File where this Symbol is declared, relative to source root
+  std::uint64_t               line = 0;          ///< Line number in the file
+  hdoc::types::SymbolID       parentNamespaceID; ///< ID of the parent namespace (or record)
+  bool                        isDetail = false;  ///< Is this symbol in a "detail" namespace?
 
   /// @brief Comparison operator sorts alphabetically by symbol name, sort detail symbols last
   bool operator<(const Symbol& s) const {
@@ -75,13 +76,21 @@ struct Symbol {
   }
 
   bool operator==(hdoc::types::Symbol const&) const = default;
+};
 
-  virtual const std::string directory() const {
-    return "";
-  };
+/// @brief Compile-time properties of each kind of Symbol, specialized alongside each kind.
+/// Provides `directory`, the directory in the output where pages for that kind of symbol are written.
+template <typename T> struct SymbolTraits;
+
+/// @brief Base class for concrete kinds of symbols, which provides URLs based on SymbolTraits<Derived>.
+/// Resolved at compile time so that symbols don't need a vtable.
+template <typename Derived> struct SymbolOfKind : public Symbol {
+  static constexpr std::string_view directory() {
+    return SymbolTraits<Derived>::directory;
+  }
 
   std::string url() const {
-    return directory() + "/" + this->ID.str() + ".html";
+    return std::string(directory()) + "/" + this->ID.str() + ".html";
   }
 
   std::string relativeUrl() const {
@@ -92,8 +101,8 @@ struct Symbol {
 /// @brief Represents a possible reference to another Symbol that may or may not be in the Index.
 /// Used to represent cross-links to function parameters, return types, or record member variables.
 struct TypeRef {
-  hdoc::types::SymbolID id;   ///< Possible SymbolID of this type.
-  std::string           name; ///< Name of the type
+  hdoc::types::SymbolID       id;   ///< Possible SymbolID of this type.
+  hdoc::types::InternedString name; ///< Name of the type
 };
 
 /// @brief Represents a function parameter
@@ -105,16 +114,17 @@ struct TemplateParam {
   };
   TemplateType templateType;
 
-  std::string name;                    ///< Name given to the parameter
-  std::string type;                    ///< Type given to the parameter (if any)
-  std::string docComment;              ///< Any comment attached to this param using @tparam or \tparam
-  std::string defaultValue;            ///< The default value for this param, if it exists
-  bool        isParameterPack = false; ///< Is this template a parameter pack, i.e. "typename..."
-  bool        isTypename      = false; ///< Was this template declared with "typename" or "class"?
+  std::string                 name;                    ///< Name given to the parameter
+  hdoc::types::InternedString type;                    ///< Type given to the parameter (if any)
+  std::string                 docComment;              ///< Any comment attached to this param using @tparam or \tparam
+  std::string                 defaultValue;            ///< The default value for this param, if it exists
+  bool                        isParameterPack = false; ///< Is this template a parameter pack, i.e. "typename..."
+  bool                        isTypename      = false; ///< Was this template declared with "typename" or "class"?
+  uint32_t                    depth           = 0;     ///< Nesting depth of the template this parameter belongs to
 };
 
 /// @brief Represents a using declaration or similar alias
-struct AliasSymbol : public Symbol {
+struct AliasSymbol : public SymbolOfKind<AliasSymbol> {
 public:
   TypeRef                    target;                             ///< The type this using declaration aliases
   bool                       isRecordMember = false;             ///< Is it a member alias?
@@ -122,10 +132,6 @@ public:
   std::vector<TemplateParam> templateParams;                     ///< All of the template parameters for this alias
   std::string                proto;                              ///< Full "prototype", including template parameters
 
-  virtual const std::string directory() const override {
-    return "aliases";
-  }
-
   /// @brief Comparison operator sorts according to visibility, within same visibility fall back to default
   bool operator<(const AliasSymbol& s) const {
     if (this->access != s.access) {
@@ -135,6 +141,10 @@ public:
   }
 };
 
+template <> struct SymbolTraits<AliasSymbol> {
+  static constexpr std::string_view directory = "aliases";
+};
+
 /// @brief Represents a member variable of a record
 struct MemberVariable {
   bool                   isStatic = false;           ///< Is this member variable marked static?
@@ -146,7 +156,7 @@ struct MemberVariable {
 };
 
 /// @brief Describes a record, such as a struct, class, or union
-struct RecordSymbol : public Symbol {
+struct RecordSymbol : public SymbolOfKind<RecordSymbol> {
   /// @brief Represents a record that is being inherited from
   struct BaseRecord {
     hdoc::types::SymbolID  id;     ///< ID of the record that's being inherited from
@@ -162,10 +172,10 @@ struct RecordSymbol : public Symbol {
   std::vector<TemplateParam>         templateParams;  ///< All of the template parameters for this record
   std::vector<hdoc::types::SymbolID> aliasIDs;        ///< All of the aliases in this record
   std::vector<hdoc::types::SymbolID> hiddenFriendIDs; ///< All functions  declared as hidden friends of this record
+};
 
-  virtual const std::string directory() const override {
-    return "records";
-  }
+template <> struct SymbolTraits<RecordSymbol> {
+  static constexpr std::string_view directory = "records";
 };
 
 /// @brief Unique identifier for functions that should be grouped (name + namespace)
@@ -185,25 +195,27 @@ struct FunctionParam {
 };
 
 /// @brief Symbol representing a function or member function
-struct FunctionSymbol : public Symbol {
+struct FunctionSymbol : public SymbolOfKind<FunctionSymbol> {
 public:
-  bool                       isRecordMember    = false; ///< Is it a method?
-  bool                       isHiddenFriend    = false; ///< is hidden friend (friend with function body)?
-  bool                       isConstexpr       = false; ///< Is it marked constexpr?
-  bool                       isConsteval       = false; ///< Is it marked consteval?
-  bool                       isExplicit        = false; ///< Is it marked explicit?
-  bool                       isInline          = false; ///< Is it marked inline?
-  bool                       isNoDiscard       = false; ///< Is it marked [[nodiscard]]?
-  bool                       isNoReturn        = false; ///< Is it marked [[noreturn]]?
-  bool                       isConst           = false; ///< Is it marked const?
-  bool                       isVolatile        = false; ///< Is it marked volatile?
-  bool                       isRestrict        = false; ///< Is it marked restrict?
-  bool                       isVirtual         = false; ///< Is it a virtual function?
-  bool                       isVariadic        = false; ///< Does it have a "..." parameter?
-  bool                       isNoExcept        = false; ///< Is it marked noexcept?
-  bool                       hasTrailingReturn = false; ///< Does use the funky `auto func() -> int {}` syntax?
-  bool                       isCtorOrDtor      = false; ///< Is it a record constructor or destructor?
-  bool                       isConversionOp    = false; ///< Is it a conversion operator?
+  // Qualifiers are packed into bits since there is one of these for every function in the index
+  bool isRecordMember    : 1 = false; ///< Is it a method?
+  bool isHiddenFriend    : 1 = false; ///< is hidden friend (friend with function body)?
+  bool isConstexpr       : 1 = false; ///< Is it marked constexpr?
+  bool isConsteval       : 1 = false; ///< Is it marked consteval?
+  bool isExplicit        : 1 = false; ///< Is it marked explicit?
+  bool isInline          : 1 = false; ///< Is it marked inline?
+  bool isNoDiscard       : 1 = false; ///< Is it marked [[nodiscard]]?
+  bool isNoReturn        : 1 = false; ///< Is it marked [[noreturn]]?
+  bool isConst           : 1 = false; ///< Is it marked const?
+  bool isVolatile        : 1 = false; ///< Is it marked volatile?
+  bool isRestrict        : 1 = false; ///< Is it marked restrict?
+  bool isVirtual         : 1 = false; ///< Is it a virtual function?
+  bool isVariadic        : 1 = false; ///< Does it have a "..." parameter?
+  bool isNoExcept        : 1 = false; ///< Is it marked noexcept?
+  bool hasTrailingReturn : 1 = false; ///< Does use the funky `auto func() -> int {}` syntax?
+  bool isCtorOrDtor      : 1 = false; ///< Is it a record constructor or destructor?
+  bool isConversionOp    : 1 = false; ///< Is it a conversion operator?
+
   uint64_t                   nameStart         = 0;     ///< Position of the first character of the name
   uint64_t                   postTemplate      = 0; ///< Position of the first character after all the template magic
   clang::AccessSpecifier     access            = clang::AS_public; ///< Is the function public/protected/private
@@ -216,10 +228,6 @@ public:
   std::vector<TemplateParam> templateParams;       ///< All of the parameters for this function
   FreestandingFunctionID     freestandingID = notFreeStanding; ///< Unique identifier for this function overload group
 
-  virtual const std::string directory() const override {
-    return "functions";
-  }
-
   /// @brief Comparison operator sorts according to visibility, within same visibility fall back to default
   bool operator<(const FunctionSymbol& s) const {
     if (this->access != s.access) {
@@ -229,6 +237,10 @@ public:
   }
 };
 
+template <> struct SymbolTraits<FunctionSymbol> {
+  static constexpr std::string_view directory = "functions";
+};
+
 /// @brief Represents the values inside an enum
 struct EnumMember {
   int64_t     value;      ///< Integer value this member resolves to
@@ -237,28 +249,28 @@ struct EnumMember {
 };
 
 /// @brief Represents an enum or scoped enum (enum class/struct)
-struct EnumSymbol : public Symbol {
+struct EnumSymbol : public SymbolOfKind<EnumSymbol> {
 public:
   std::string             type = ""; ///< "class" for enum class, "struct" for enum struct, otherwise ""
   std::vector<EnumMember> members;   ///< All of this enum's values
+};
 
-  virtual const std::string directory() const override {
-    return "enums";
-  }
+template <> struct SymbolTraits<EnumSymbol> {
+  static constexpr std::string_view directory = "enums";
 };
 
 /// @brief Represents a namespace
-struct NamespaceSymbol : public Symbol {
+struct NamespaceSymbol : public SymbolOfKind<NamespaceSymbol> {
 public:
   std::vector<hdoc::types::SymbolID> records    = {}; ///< All of the records in this namespace
   std::vector<hdoc::types::SymbolID> namespaces = {}; ///< All of the other namespaces in this namespace
   std::vector<hdoc::types::SymbolID> enums      = {}; ///< All of the enums in this namespace
   std::vector<hdoc::types::SymbolID> usings     = {}; ///< All of the usings in this namespace
   std::vector<hdoc::types::SymbolID> functions  = {}; ///< All of the functions in this namespace
+};
 
-  virtual const std::string directory() const override {
-    return "namespaces";
-  }
+template <> struct SymbolTraits<NamespaceSymbol> {
+  static constexpr std::string_view directory = "namespaces";
 };
 
 struct FreestandingFunction {
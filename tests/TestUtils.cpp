@@ -5,12 +5,30 @@
 
 #include "clang/ASTMatchers/ASTMatchFinder.h"
 #include "clang/ASTMatchers/ASTMatchers.h"
+#include "clang/Frontend/FrontendAction.h"
 #include "clang/Tooling/Tooling.h"
+#include "llvm/Support/ThreadPool.h"
 
+#include "indexer/HeaderRegistry.hpp"
+#include "indexer/IndexMerger.hpp"
 #include "indexer/Matchers.hpp"
 #include "types/Symbols.hpp"
 
 void runOverCode(const std::string_view code, hdoc::types::Index& index, const hdoc::types::Config cfg) {
+  std::vector<std::string> args;
+  if (cfg.skipFunctionBodies) {
+    args = {"-Xclang", "-skip-function-bodies"};
+  }
+
+  // The pruning front end is only available through IndexMatchers, which also indexes aliases
+  if (cfg.pruneAST) {
+    hdoc::indexer::matchers::IndexMatchers matchers(&index, &cfg, nullptr);
+    std::unique_ptr<clang::tooling::FrontendActionFactory> Factory(
+        clang::tooling::newFrontendActionFactory(&matchers));
+    clang::tooling::runToolOnCodeWithArgs(Factory->create(), code, args);
+    return;
+  }
+
   clang::ast_matchers::MatchFinder          Finder;
   hdoc::indexer::matchers::FunctionMatcher  FunctionFinder(&index, &cfg);
   hdoc::indexer::matchers::RecordMatcher    RecordFinder(&index, &cfg);
@@ -23,7 +41,58 @@ void runOverCode(const std::string_view code, hdoc::types::Index& index, const h
   Finder.addMatcher(NamespaceFinder.getMatcher(), &NamespaceFinder);
 
   std::unique_ptr<clang::tooling::FrontendActionFactory> Factory(clang::tooling::newFrontendActionFactory(&Finder));
-  clang::tooling::runToolOnCode(Factory->create(), code);
+  clang::tooling::runToolOnCodeWithArgs(Factory->create(), code, args);
+}
+
+/// Claims the files of a TU as they're entered, like the indexer's own front end action.
+class OwnedFilesAction : public clang::ASTFrontendAction {
+public:
+  OwnedFilesAction(hdoc::indexer::matchers::IndexMatchers& matchers, hdoc::indexer::OwnedFiles& ownedFiles)
+      : matchers(matchers), ownedFiles(ownedFiles) {}
+
+  std::unique_ptr<clang::ASTConsumer> CreateASTConsumer(clang::CompilerInstance& ci, llvm::StringRef) override {
+    this->ownedFiles.attachToPreprocessor(ci.getPreprocessor());
+    return this->matchers.newASTConsumer();
+  }
+
+private:
+  hdoc::indexer::matchers::IndexMatchers& matchers;
+  hdoc::indexer::OwnedFiles&              ownedFiles;
+};
+
+void runOverTUs(const std::vector<std::pair<std::string, std::string>>& files,
+                const std::vector<std::string>&                        tus,
+                hdoc::types::Index&                                    index,
+                const hdoc::types::Config                              cfg) {
+  hdoc::indexer::HeaderRegistry registry;
+  hdoc::indexer::IndexMerger    merger;
+  for (uint32_t i = tus.size(); i-- > 0;) {
+    // The contents of the TU itself are passed as code, and everything else is mapped for it to include
+    std::string                         code;
+    clang::tooling::FileContentMappings otherFiles;
+    for (const auto& [path, contents] : files) {
+      if (path == tus[i]) {
+        code = contents;
+      } else {
+        otherFiles.emplace_back(path, contents);
+      }
+    }
+
+    hdoc::types::Index                     tuIndex;
+    hdoc::indexer::OwnedFiles              ownedFiles(cfg.deduplicateHeaders ? &registry : nullptr, tus[i]);
+    hdoc::indexer::matchers::IndexMatchers matchers(&tuIndex, &cfg, &ownedFiles);
+    clang::tooling::runToolOnCodeWithArgs(std::make_unique<OwnedFilesAction>(matchers, ownedFiles),
+                                          code,
+                                          {},
+                                          tus[i],
+                                          "hdoc-tests",
+                                          std::make_shared<clang::PCHContainerOperations>(),
+                                          otherFiles);
+    merger.add(tuIndex, i);
+  }
+
+  llvm::ThreadPool pool(llvm::hardware_concurrency(1));
+  merger.finish(index, pool);
 }
 
 void checkIndexSizes(const hdoc::types::Index& index,
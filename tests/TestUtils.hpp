@@ -9,11 +9,21 @@
 
 #include <optional>
 #include <string>
+#include <utility>
+#include <vector>
 
 void runOverCode(const std::string_view    code,
                  hdoc::types::Index&       index,
                  const hdoc::types::Config cfg = hdoc::types::Config());
 
+/// Index each TU in tus separately and merge their indexes the way the indexer does, with earlier TUs winning.
+/// files holds the path and contents of every TU and header, and TUs are indexed from last to first so that the
+/// headers shared between TUs are claimed by the TU whose symbols lose when merging.
+void runOverTUs(const std::vector<std::pair<std::string, std::string>>& files,
+                const std::vector<std::string>&                        tus,
+                hdoc::types::Index&                                    index,
+                const hdoc::types::Config                              cfg = hdoc::types::Config());
+
 void checkIndexSizes(const hdoc::types::Index& index,
                      const uint32_t            recordsSize,
                      const uint32_t            functionsSize,
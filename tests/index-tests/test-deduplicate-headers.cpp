@@ -0,0 +1,85 @@
+// Copyright 2019-2023 hdoc
+// SPDX-License-Identifier: AGPL-3.0-only
+
+#include "tests/TestUtils.hpp"
+
+// widget.cpp comes first, so its symbols win when merging, but main.cpp is indexed first and claims widget.hpp
+static const std::vector<std::pair<std::string, std::string>> files = {
+    {"/hdoc-test/widget.hpp", R"(
+      class Widget {
+      public:
+        explicit Widget(int size = 1);
+        virtual void resize(int width, int height = 10);
+      };
+    )"},
+    {"/hdoc-test/widget.cpp", R"(
+      #include "widget.hpp"
+      Widget::Widget(int size) {}
+      void Widget::resize(int width, int height) {}
+    )"},
+    {"/hdoc-test/main.cpp", R"(
+      #include "widget.hpp"
+      int main() {
+        Widget w;
+        w.resize(1);
+      }
+    )"},
+};
+static const std::vector<std::string> tus = {"/hdoc-test/widget.cpp", "/hdoc-test/main.cpp"};
+
+static hdoc::types::Index indexWidget(const bool deduplicateHeaders) {
+  hdoc::types::Config cfg;
+  cfg.rootDir            = "/hdoc-test";
+  cfg.deduplicateHeaders = deduplicateHeaders;
+
+  hdoc::types::Index index;
+  runOverTUs(files, tus, index, cfg);
+  return index;
+}
+
+TEST_CASE("Out-of-line definitions don't replace declarations in headers owned by another TU") {
+  const hdoc::types::Index index = indexWidget(true);
+  checkIndexSizes(index, 1, 3, 0, 0);
+
+  const auto resize = findByName(index.functions, "resize");
+  REQUIRE(resize);
+  CHECK(resize->file == "widget.hpp");
+  CHECK(resize->isVirtual == true);
+  CHECK(resize->params.size() == 2);
+  CHECK(resize->params[1].defaultValue == "10");
+
+  const auto ctor = findByName(index.functions, "Widget");
+  REQUIRE(ctor);
+  CHECK(ctor->file == "widget.hpp");
+  CHECK(ctor->isExplicit == true);
+  CHECK(ctor->params.size() == 1);
+  CHECK(ctor->params[0].defaultValue == "1");
+}
+
+TEST_CASE("Deduplicating headers indexes the same symbols") {
+  const hdoc::types::Index deduplicated = indexWidget(true);
+  const hdoc::types::Index full         = indexWidget(false);
+
+  CHECK(deduplicated.records.entries.size() == full.records.entries.size());
+  for (const auto& [id, s] : full.records.entries) {
+    REQUIRE(deduplicated.records.entries.contains(id));
+    CHECK(deduplicated.records.entries.at(id).name == s.name);
+    CHECK(deduplicated.records.entries.at(id).file == s.file);
+    CHECK(deduplicated.records.entries.at(id).line == s.line);
+  }
+
+  CHECK(deduplicated.functions.entries.size() == full.functions.entries.size());
+  for (const auto& [id, s] : full.functions.entries) {
+    REQUIRE(deduplicated.functions.entries.contains(id));
+    const hdoc::types::FunctionSymbol& d = deduplicated.functions.entries.at(id);
+    CHECK(d.proto == s.proto);
+    CHECK(d.file == s.file);
+    CHECK(d.line == s.line);
+    CHECK(d.isVirtual == s.isVirtual);
+    CHECK(d.isExplicit == s.isExplicit);
+    CHECK(d.params.size() == s.params.size());
+    for (uint64_t i = 0; i < d.params.size() && i < s.params.size(); i++) {
+      CHECK(d.params[i].defaultValue == s.params[i].defaultValue);
+    }
+  }
+}
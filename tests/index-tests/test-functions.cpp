@@ -805,3 +805,25 @@ TEST_CASE("Const member function with trailing return type, noexcept, and const
 //   CHECK(f.params[0].docComment == "");
 //   CHECK(f.params[0].defaultValue == "");
 // }
+
+TEST_CASE("Hidden friends are detected regardless of whether function bodies are skipped") {
+  const std::string code = R"(
+    namespace ns {
+      struct Foo {
+        friend bool operator==(const Foo&, const Foo&) { return true; }
+        friend void declaredOnly(Foo&);
+      };
+    }
+  )";
+
+  for (const bool skipFunctionBodies : {false, true}) {
+    hdoc::types::Config cfg;
+    cfg.skipFunctionBodies = skipFunctionBodies;
+    hdoc::types::Index index;
+    runOverCode(code, index, cfg);
+
+    const auto foo = findByName(index.records, "Foo");
+    REQUIRE(foo.has_value());
+    CHECK(foo->hiddenFriendIDs.size() == 1);
+  }
+}
@@ -496,3 +496,49 @@ TEST_CASE("Namespace alias") {
   CHECK(n3.ID.str().size() == 16);
   CHECK(n3.parentNamespaceID == n2.ID);
 }
+
+TEST_CASE("Ignored and detail namespaces apply to everything nested in them") {
+  const std::string code = R"(
+    namespace foo {
+      namespace internal_impl {
+        void ignored();
+        namespace nested {
+          struct AlsoIgnored {};
+        }
+      }
+
+      namespace detail {
+        struct Hidden {
+          void method();
+        };
+        namespace {
+          void anonymous();
+        }
+      }
+
+      void visible();
+    }
+
+    namespace foo::detail {
+      void reopened();
+    }
+  )";
+
+  hdoc::types::Config cfg;
+  cfg.ignoreNamespaces = {"impl", "unused"};
+  cfg.detailNamespaces = {"detail"};
+
+  hdoc::types::Index index;
+  runOverCode(code, index, cfg);
+  checkIndexSizes(index, 1, 3, 0, 2);
+
+  CHECK(findByName(index.functions, "ignored").has_value() == false);
+  CHECK(findByName(index.records, "AlsoIgnored").has_value() == false);
+
+  CHECK(findByName(index.namespaces, "foo")->isDetail == false);
+  CHECK(findByName(index.namespaces, "detail")->isDetail == true);
+  CHECK(findByName(index.records, "Hidden")->isDetail == true);
+  CHECK(findByName(index.functions, "method")->isDetail == true);
+  CHECK(findByName(index.functions, "reopened")->isDetail == true);
+  CHECK(findByName(index.functions, "visible")->isDetail == false);
+}
@@ -0,0 +1,88 @@
+// Copyright 2019-2023 hdoc
+// SPDX-License-Identifier: AGPL-3.0-only
+
+#include "tests/TestUtils.hpp"
+
+TEST_CASE("Pruning the AST indexes the same symbols as matching every decl") {
+  const std::string code = R"(
+    namespace foo {
+      namespace impl {
+        struct Ignored {
+          void method();
+        };
+      }
+
+      namespace {
+        struct Anonymous {};
+      }
+
+      template <typename T> struct Box {
+        T value;
+        T get() const;
+      };
+      template <> struct Box<bool> {};
+      template struct Box<int>;
+
+      enum class Color { Red, Green };
+
+      struct Outer {
+        struct Inner {
+          enum Kind { A, B };
+        };
+        void method();
+      };
+
+      static void hidden() {}
+      void defined() {
+        Box<char> b;
+        b.get();
+      }
+    }
+  )";
+
+  hdoc::types::Config cfg;
+  cfg.ignoreNamespaces = {"impl"};
+
+  hdoc::types::Index matched;
+  runOverCode(code, matched, cfg);
+
+  cfg.pruneAST = true;
+  hdoc::types::Index pruned;
+  runOverCode(code, pruned, cfg);
+
+  checkIndexSizes(pruned,
+                  matched.records.entries.size(),
+                  matched.functions.entries.size(),
+                  matched.enums.entries.size(),
+                  matched.namespaces.entries.size());
+  for (const auto& [id, symbol] : matched.records.entries) {
+    CHECK(pruned.records.contains(id) == true);
+  }
+  for (const auto& [id, symbol] : matched.functions.entries) {
+    CHECK(pruned.functions.contains(id) == true);
+  }
+
+  CHECK(findByName(pruned.records, "Ignored").has_value() == false);
+  CHECK(findByName(pruned.records, "Anonymous").has_value() == false);
+  CHECK(findByName(pruned.functions, "hidden").has_value() == false);
+  CHECK(findByName(pruned.records, "Inner").has_value() == true);
+  CHECK(findByName(pruned.functions, "defined").has_value() == true);
+  CHECK(findByName(pruned.enums, "Color").has_value() == true);
+}
+
+TEST_CASE("Pruning the AST skips classes declared in function bodies") {
+  const std::string code = R"(
+    void f() {
+      struct Local {
+        void method() {}
+      };
+    }
+  )";
+
+  hdoc::types::Config cfg;
+  cfg.pruneAST = true;
+  hdoc::types::Index index;
+  runOverCode(code, index, cfg);
+  checkIndexSizes(index, 0, 1, 0, 0);
+  CHECK(findByName(index.functions, "f").has_value() == true);
+}
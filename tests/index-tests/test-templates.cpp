@@ -1,6 +1,7 @@
 // Copyright 2019-2023 hdoc
 // SPDX-License-Identifier: AGPL-3.0-only
 
+#include "indexer/Indexer.hpp"
 #include "tests/TestUtils.hpp"
 
 TEST_CASE("Function template declaration") {
@@ -686,6 +687,85 @@ TEST_CASE("Function that takes specialized template argument with pointer has co
   CHECK(f.params[0].defaultValue == "");
 }
 
+TEST_CASE("Method template of a record nested in a class template") {
+  const std::string code = R"(
+    template<class T>
+    struct Outer {
+      struct Inner {
+        template<class U>
+        void f(T t, U u);
+      };
+    };
+  )";
+
+  hdoc::types::Index index;
+  runOverCode(code, index);
+
+  const auto outer = findByName(index.records, "Outer");
+  const auto inner = findByName(index.records, "Inner");
+  const auto f     = findByName(index.functions, "f");
+  REQUIRE(outer);
+  REQUIRE(inner);
+  REQUIRE(f);
+  REQUIRE(outer->templateParams.size() == 1);
+  CHECK(outer->templateParams[0].name == "T");
+  CHECK(outer->templateParams[0].depth == 0);
+  CHECK(inner->templateParams.size() == 0);
+  REQUIRE(f->templateParams.size() == 1);
+  CHECK(f->templateParams[0].name == "U");
+  CHECK(f->templateParams[0].depth == 1);
+  REQUIRE(f->params.size() == 2);
+
+  // Inner doesn't know the names of Outer's parameters, so only the placeholder for U is replaced
+  hdoc::types::FunctionSymbol method = *f;
+  method.proto                       = "void f(type-parameter-0-0 t, type-parameter-1-0 u)";
+  method.nameStart                   = 5;
+  method.postTemplate                = 0;
+  method.params[0].type.name         = "type-parameter-0-0";
+  method.params[1].type.name         = "type-parameter-1-0";
+
+  std::string buf;
+  hdoc::indexer::replaceMethodTemplateParams(*inner, method, buf);
+  CHECK(method.proto == "void f(type-parameter-0-0 t, U u)");
+  CHECK(method.nameStart == 5);
+  CHECK(method.params[0].type.name == "type-parameter-0-0");
+  CHECK(method.params[1].type.name == "U");
+}
+
+TEST_CASE("Method template of a record that isn't a template") {
+  const std::string code = R"(
+    struct Plain {
+      template<class U>
+      void g(U u);
+    };
+  )";
+
+  hdoc::types::Index index;
+  runOverCode(code, index);
+
+  const auto plain = findByName(index.records, "Plain");
+  const auto g     = findByName(index.functions, "g");
+  REQUIRE(plain);
+  REQUIRE(g);
+  CHECK(plain->templateParams.size() == 0);
+  REQUIRE(g->templateParams.size() == 1);
+  CHECK(g->templateParams[0].name == "U");
+  CHECK(g->templateParams[0].depth == 0);
+  REQUIRE(g->params.size() == 1);
+
+  // The method's own parameters are at depth 0, and there's nothing at depth 1
+  hdoc::types::FunctionSymbol method = *g;
+  method.proto                       = "void g(type-parameter-0-0 u, type-parameter-1-0 v)";
+  method.nameStart                   = 5;
+  method.postTemplate                = 0;
+  method.params[0].type.name         = "type-parameter-0-0";
+
+  std::string buf;
+  hdoc::indexer::replaceMethodTemplateParams(*plain, method, buf);
+  CHECK(method.proto == "void g(U u, type-parameter-1-0 v)");
+  CHECK(method.params[0].type.name == "U");
+}
+
 // TODO: figure out why there are 3 CXXMethodDecls in this code block
 // TEST_CASE("what the fuck") {
 //   const std::string code = R"(
@@ -0,0 +1,94 @@
+// Copyright 2019-2023 hdoc
+// SPDX-License-Identifier: AGPL-3.0-only
+
+#include "doctest.h"
+#include "support/AsyncFileWriter.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+static std::string readFile(const std::filesystem::path& path) {
+  std::ifstream     in(path);
+  std::stringstream ss;
+  ss << in.rdbuf();
+  return ss.str();
+}
+
+TEST_CASE("Files are written to directories that don't exist yet") {
+  const std::filesystem::path dir = std::filesystem::temp_directory_path() / "hdoc-test-async-file-writer";
+  std::filesystem::remove_all(dir);
+
+  {
+    // A queue shorter than the number of files makes write() wait for files to be written
+    hdoc::utils::AsyncFileWriter writer(2, 2);
+    for (int i = 0; i < 20; i++) {
+      std::string buf = writer.takeBuffer();
+      CHECK(buf.empty() == true);
+      buf += "file " + std::to_string(i);
+      writer.write(dir / (i % 2 == 0 ? "even" : "odd") / (std::to_string(i) + ".html"), std::move(buf));
+    }
+    CHECK(writer.wait() == true);
+  }
+
+  for (int i = 0; i < 20; i++) {
+    const std::filesystem::path path = dir / (i % 2 == 0 ? "even" : "odd") / (std::to_string(i) + ".html");
+    CHECK(readFile(path) == "file " + std::to_string(i));
+  }
+  std::filesystem::remove_all(dir);
+}
+
+TEST_CASE("Buffers of written files are reused") {
+  const std::filesystem::path path = std::filesystem::temp_directory_path() / "hdoc-test-async-file-writer.html";
+
+  hdoc::utils::AsyncFileWriter writer(1, 4);
+  writer.write(path, std::string(1000, 'x'));
+  CHECK(writer.wait() == true);
+  CHECK(readFile(path) == std::string(1000, 'x'));
+
+  const std::string buf = writer.takeBuffer();
+  CHECK(buf.empty() == true);
+  CHECK(buf.capacity() >= 1000);
+  std::filesystem::remove(path);
+}
+
+TEST_CASE("Failing to write a file is reported") {
+  const std::filesystem::path file = std::filesystem::temp_directory_path() / "hdoc-test-async-file-writer-file";
+  std::ofstream(file) << "not a directory";
+
+  hdoc::utils::AsyncFileWriter writer(1, 4);
+  writer.write(file / "page.html", "contents");
+  CHECK(writer.wait() == false);
+  std::filesystem::remove(file);
+}
+
+TEST_CASE("Failing to flush a file when closing it is reported") {
+  // Writes to /dev/full fail with ENOSPC, and a short file only reaches it when the stream is flushed
+  if (std::filesystem::exists("/dev/full") == false) {
+    return;
+  }
+
+  hdoc::utils::AsyncFileWriter writer(1, 4);
+  writer.write("/dev/full", "contents");
+  CHECK(writer.wait() == false);
+}
+
+TEST_CASE("Files are added to the archive instead of being written separately") {
+  const std::filesystem::path dir     = std::filesystem::temp_directory_path() / "hdoc-test-async-file-writer-out";
+  const std::filesystem::path archive = std::filesystem::temp_directory_path() / "hdoc-test-async-file-writer.zip";
+  std::filesystem::remove_all(dir);
+
+  hdoc::utils::AsyncFileWriter writer(2, 4);
+  REQUIRE(writer.openArchive(archive, dir) == true);
+  writer.write(dir / "index.html", "index");
+  writer.write(dir / "r" / "1.html", "record");
+  CHECK(writer.closeArchive() == true);
+
+  // Nothing is written to the output directory, and stored files appear verbatim in the archive
+  CHECK(std::filesystem::exists(dir) == false);
+  const std::string contents = readFile(archive);
+  CHECK(contents.find("r/1.html") != std::string::npos);
+  CHECK(contents.find("record") != std::string::npos);
+  std::filesystem::remove(archive);
+}
@@ -0,0 +1,94 @@
+// Copyright 2019-2023 hdoc
+// SPDX-License-Identifier: AGPL-3.0-only
+
+#include "serde/BinarySerializer.hpp"
+#include "tests/TestUtils.hpp"
+
+#include <string>
+
+TEST_CASE("Check if Index is the same after binary serde roundtrip") {
+  const std::string_view code = R"(
+    namespace foo {
+      /// @brief An enum
+      enum class Color : int { Red = 1, Green = -2 };
+
+      using Alias = int;
+
+      template <typename T, int N = 3>
+      struct Base {
+        /// Doc comment
+        T data[N];
+        virtual ~Base() = default;
+      };
+
+      class Derived : public Base<int> {
+      public:
+        [[nodiscard]] constexpr int method(const int& a, Alias b = 4) const && noexcept;
+        static Derived* create();
+      private:
+        int member = 0;
+      };
+
+      template <typename U> U freestanding(U u);
+    }
+  )";
+
+  hdoc::types::Index index;
+  runOverCode(code, index);
+
+  const std::string data = hdoc::serde::serializeToBinary(index);
+
+  hdoc::types::Index index2;
+  CHECK(hdoc::serde::deserializeFromBinary(data, index2) == true);
+  checkIndexSizes(index2,
+                  index.records.entries.size(),
+                  index.functions.entries.size(),
+                  index.enums.entries.size(),
+                  index.namespaces.entries.size());
+  CHECK(index2.aliases.entries.size() == index.aliases.entries.size());
+  CHECK(index2.functions.numMatches == index.functions.numMatches);
+
+  for (const auto& [id, s] : index.records.entries) {
+    const hdoc::types::RecordSymbol& s2 = index2.records.entries.at(id);
+    CHECK(s2 == s);
+    CHECK(s2.proto == s.proto);
+    CHECK(s2.vars.size() == s.vars.size());
+    CHECK(s2.methodIDs == s.methodIDs);
+    CHECK(s2.baseRecords.size() == s.baseRecords.size());
+    CHECK(s2.templateParams.size() == s.templateParams.size());
+  }
+  for (const auto& [id, s] : index.functions.entries) {
+    const hdoc::types::FunctionSymbol& s2 = index2.functions.entries.at(id);
+    CHECK(s2 == s);
+    CHECK(s2.proto == s.proto);
+    CHECK(s2.returnType.name == s.returnType.name);
+    CHECK(s2.params.size() == s.params.size());
+    CHECK(s2.templateParams.size() == s.templateParams.size());
+    for (uint64_t i = 0; i < s2.templateParams.size() && i < s.templateParams.size(); i++) {
+      CHECK(s2.templateParams[i].depth == s.templateParams[i].depth);
+    }
+    CHECK(s2.isConstexpr == s.isConstexpr);
+    CHECK(s2.isNoExcept == s.isNoExcept);
+  }
+  for (const auto& [id, s] : index.enums.entries) {
+    const hdoc::types::EnumSymbol& s2 = index2.enums.entries.at(id);
+    CHECK(s2 == s);
+    REQUIRE(s2.members.size() == s.members.size());
+    for (uint64_t i = 0; i < s.members.size(); i++) {
+      CHECK(s2.members[i].name == s.members[i].name);
+      CHECK(s2.members[i].value == s.members[i].value);
+    }
+  }
+  for (const auto& [id, s] : index.namespaces.entries) {
+    CHECK(index2.namespaces.entries.at(id) == s);
+  }
+  for (const auto& [id, s] : index.aliases.entries) {
+    CHECK(index2.aliases.entries.at(id) == s);
+  }
+
+  // Truncated or corrupted data must be rejected rather than producing a partial index
+  hdoc::types::Index index3;
+  CHECK(hdoc::serde::deserializeFromBinary(std::string_view(data).substr(0, data.size() / 2), index3) == false);
+  hdoc::types::Index index4;
+  CHECK(hdoc::serde::deserializeFromBinary("not an index", index4) == false);
+}
@@ -0,0 +1,26 @@
+// Copyright 2019-2023 hdoc
+// SPDX-License-Identifier: AGPL-3.0-only
+
+#include "doctest.h"
+#include "indexer/CoveringSet.hpp"
+
+TEST_CASE("Covering set picks the TUs that add the most headers") {
+  const std::vector<std::vector<std::string>> headers = {
+      {"/src/a.hpp", "/src/b.hpp"},
+      {"/src/a.hpp", "/src/b.hpp", "/src/c.hpp", "/src/d.hpp"},
+      {"/src/e.hpp"},
+      {},
+      {"/src/c.hpp", "/src/a.hpp", "/src/c.hpp"},
+      {"/src/e.hpp"},
+  };
+
+  // TU 1 covers everything but e.hpp, and TU 2 is the first TU that includes it
+  const std::vector<uint64_t> picked = hdoc::indexer::findCoveringSet(headers);
+  CHECK(picked == std::vector<uint64_t>{1, 2});
+}
+
+TEST_CASE("Covering set of TUs with disjoint headers contains all of them") {
+  const std::vector<std::vector<std::string>> headers = {{"/src/a.hpp"}, {"/src/b.hpp"}, {"/src/c.hpp"}};
+  CHECK(hdoc::indexer::findCoveringSet(headers) == std::vector<uint64_t>{0, 1, 2});
+  CHECK(hdoc::indexer::findCoveringSet({}).empty());
+}
@@ -0,0 +1,26 @@
+// Copyright 2019-2023 hdoc
+// SPDX-License-Identifier: AGPL-3.0-only
+
+#include "doctest.h"
+#include "indexer/HeaderRegistry.hpp"
+
+#include <algorithm>
+
+TEST_CASE("Headers are only claimed by the first TU that includes them") {
+  hdoc::indexer::HeaderRegistry registry;
+
+  CHECK(registry.isClaimed("/src/a.hpp") == false);
+  CHECK(registry.claim("/src/a.hpp", "/src/a.cpp") == true);
+  CHECK(registry.isClaimed("/src/a.hpp") == true);
+
+  // Other TUs can't claim it, but the owner can claim it again (e.g. for a second compile command)
+  CHECK(registry.claim("/src/a.hpp", "/src/b.cpp") == false);
+  CHECK(registry.claim("/src/a.hpp", "/src/a.cpp") == true);
+
+  CHECK(registry.claim("/src/b.hpp", "/src/b.cpp") == true);
+  CHECK(registry.isClaimed("/src/c.hpp") == false);
+
+  std::vector<std::string> claimed = registry.getClaimedFiles();
+  std::sort(claimed.begin(), claimed.end());
+  CHECK(claimed == std::vector<std::string>{"/src/a.hpp", "/src/b.hpp"});
+}
@@ -0,0 +1,50 @@
+// Copyright 2019-2023 hdoc
+// SPDX-License-Identifier: AGPL-3.0-only
+
+#include "doctest.h"
+#include "support/HTMLStream.hpp"
+
+#include <string>
+
+TEST_CASE("Escaping text for HTML") {
+  std::string out;
+  hdoc::utils::appendEscapedHTML(out, "plain");
+  CHECK(out == "plain");
+
+  out.clear();
+  hdoc::utils::appendEscapedHTML(out, "a < b && \"c\" > 'd'");
+  CHECK(out == "a &lt; b &amp;&amp; &quot;c&quot; &gt; &apos;d&apos;");
+
+  out.clear();
+  hdoc::utils::appendEscapedHTML(out, "");
+  CHECK(out == "");
+}
+
+TEST_CASE("Streaming elements, classes, and attributes") {
+  std::string             out;
+  hdoc::utils::HTMLStream html(out);
+
+  html.open({"ul"});
+  html.open({"li", "is-family-code"}, {}, "hdoc-private");
+  html.element({"a"}, "std::vector<int>", {{"href", "a.html#b?c=\"d\""}});
+  html.close({"li"});
+  html.open({"li"}, {}, "hdoc-detail").text("x").close({"li"});
+  html.close({"ul"});
+  html.voidElement({"hr", "member-fun-separator"});
+  html.open({"p"}).raw("<b>bold</b>").close({"p"});
+
+  CHECK(out == "<ul>"
+               "<li class=\"is-family-code hdoc-private\">"
+               "<a href=\"a.html#b?c=&quot;d&quot;\">std::vector&lt;int&gt;</a>"
+               "</li>"
+               "<li class=\"hdoc-detail\">x</li>"
+               "</ul>"
+               "<hr class=\"member-fun-separator\">"
+               "<p><b>bold</b></p>");
+}
+
+TEST_CASE("Streams append to their string without clearing it") {
+  std::string out = "<main>";
+  hdoc::utils::HTMLStream(out).element({"h1"}, "Title", {{"id", "top"}}).close({"main"});
+  CHECK(out == "<main><h1 id=\"top\">Title</h1></main>");
+}
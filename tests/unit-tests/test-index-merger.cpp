@@ -0,0 +1,43 @@
+// Copyright 2019-2023 hdoc
+// SPDX-License-Identifier: AGPL-3.0-only
+
+#include "doctest.h"
+#include "indexer/IndexMerger.hpp"
+
+#include <string>
+#include <vector>
+
+/// Build an index with one record with the given ID whose file is set to the name of the TU it came from
+static void addRecord(hdoc::types::Index& index, const uint64_t id, const std::string& tu) {
+  hdoc::types::RecordSymbol r;
+  r.ID   = hdoc::types::SymbolID(id);
+  r.file = tu;
+  index.records.entries.emplace(r.ID, std::move(r));
+  index.records.numMatches++;
+}
+
+TEST_CASE("Duplicate symbols are resolved by TU position regardless of the order TUs are added in") {
+  const std::vector<std::vector<uint32_t>> orders = {{0, 1, 2}, {2, 1, 0}, {1, 2, 0}};
+  llvm::ThreadPool                         pool;
+
+  for (const auto& order : orders) {
+    hdoc::indexer::IndexMerger merger;
+    for (const uint32_t tu : order) {
+      hdoc::types::Index tuIndex;
+      addRecord(tuIndex, 0x1111111111111111ULL, "tu" + std::to_string(tu));
+      if (tu > 0) {
+        addRecord(tuIndex, 0xAAAAAAAAAAAAAAAAULL, "tu" + std::to_string(tu));
+      }
+      addRecord(tuIndex, 0xF000000000000000ULL + tu, "tu" + std::to_string(tu));
+      merger.add(tuIndex, tu);
+    }
+
+    hdoc::types::Index index;
+    merger.finish(index, pool);
+    CHECK(index.records.entries.size() == 5);
+    CHECK(index.records.numMatches == 8);
+    CHECK(index.records.entries.at(hdoc::types::SymbolID(0x1111111111111111ULL)).file == "tu0");
+    CHECK(index.records.entries.at(hdoc::types::SymbolID(0xAAAAAAAAAAAAAAAAULL)).file == "tu1");
+    CHECK(index.records.entries.at(hdoc::types::SymbolID(0xF000000000000002ULL)).file == "tu2");
+  }
+}
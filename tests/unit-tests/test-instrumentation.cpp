@@ -0,0 +1,79 @@
+// Copyright 2019-2023 hdoc
+// SPDX-License-Identifier: AGPL-3.0-only
+
+#include "support/Instrumentation.hpp"
+#include "tests/TestUtils.hpp"
+
+#include <fstream>
+#include <sstream>
+
+TEST_CASE("Heap bytes of a Database include the strings its symbols own") {
+  hdoc::types::Database<hdoc::types::EnumSymbol> db;
+  const uint64_t                                 emptyBytes = hdoc::utils::getHeapBytes(db);
+
+  hdoc::types::EnumSymbol e;
+  e.name = "Color";
+  db.update(hdoc::types::SymbolID(1), e);
+  const uint64_t shortBytes = hdoc::utils::getHeapBytes(db);
+  CHECK(shortBytes > emptyBytes);
+
+  // A long doc comment can't be stored inline and has to be counted, unlike sizeof(EnumSymbol)
+  e.docComment = std::string(1000, 'x');
+  e.members.emplace_back(hdoc::types::EnumMember{1, "Red", ""});
+  db.update(hdoc::types::SymbolID(1), e);
+  CHECK(hdoc::utils::getHeapBytes(db) >= shortBytes + 1000 + sizeof(hdoc::types::EnumMember));
+}
+
+TEST_CASE("Instrumentation report contains phases, TUs, and databases") {
+  hdoc::utils::Instrumentation instrumentation;
+
+  bool ran = false;
+  instrumentation.measure("phase", [&]() { ran = true; });
+  CHECK(ran == true);
+  REQUIRE(instrumentation.getPhases().size() == 1);
+  CHECK(instrumentation.getPhases()[0].name == "phase");
+  CHECK(instrumentation.getPhases()[0].wallSeconds >= 0);
+  CHECK(instrumentation.getPhases()[0].cpuSeconds >= 0);
+  CHECK(instrumentation.getPhases()[0].peakRSSBytes > 0);
+
+  instrumentation.recordTranslationUnit("fast.cpp", 1.0);
+  instrumentation.recordTranslationUnit("slow.cpp", 2.0);
+
+  const std::string_view code = R"(
+    namespace foo {
+      /// A function with a doc comment that is long enough to not be stored inline
+      void f(int a);
+    }
+  )";
+  hdoc::types::Index index;
+  runOverCode(code, index);
+  instrumentation.recordIndex(index);
+  REQUIRE(instrumentation.getDatabases().size() == 5);
+  CHECK(instrumentation.getDatabases()[0].name == "functions");
+  CHECK(instrumentation.getDatabases()[0].numEntries == 1);
+  CHECK(instrumentation.getDatabases()[0].heapBytes > sizeof(hdoc::types::FunctionSymbol));
+
+  const std::filesystem::path path = std::filesystem::temp_directory_path() / "hdoc-test-instrumentation.json";
+  REQUIRE(instrumentation.write(path) == true);
+  std::ifstream     in(path);
+  std::stringstream ss;
+  ss << in.rdbuf();
+  const std::string report = ss.str();
+  CHECK(report.find("\"phases\"") != std::string::npos);
+  CHECK(report.find("\"heapBytes\"") != std::string::npos);
+  CHECK(report.find("\"peakRSSBytes\"") != std::string::npos);
+  // The slowest TU is listed first
+  CHECK(report.find("slow.cpp") < report.find("fast.cpp"));
+  std::filesystem::remove(path);
+}
+
+TEST_CASE("Failing to write the instrumentation report is reported") {
+  // Writes to /dev/full fail with ENOSPC, and a short report only reaches it when the stream is flushed
+  if (std::filesystem::exists("/dev/full") == false) {
+    return;
+  }
+
+  hdoc::utils::Instrumentation instrumentation;
+  instrumentation.recordTranslationUnit("a.cpp", 1.0);
+  CHECK(instrumentation.write("/dev/full") == false);
+}
@@ -0,0 +1,52 @@
+// Copyright 2019-2023 hdoc
+// SPDX-License-Identifier: AGPL-3.0-only
+
+#include "doctest.h"
+#include "types/InternedString.hpp"
+
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST_CASE("Equal strings are interned to the same handle") {
+  const hdoc::types::InternedString a = "const std::string &";
+  const hdoc::types::InternedString b = std::string("const std::string &");
+  const hdoc::types::InternedString c = "int";
+  CHECK(a == b);
+  CHECK(&a.str() == &b.str());
+  CHECK(a != c);
+  CHECK(a == "const std::string &");
+  CHECK(std::string("int") == c);
+  CHECK(a.size() == 19);
+
+  hdoc::types::InternedString empty;
+  CHECK(empty.empty());
+  CHECK(empty == "");
+  CHECK(empty == hdoc::types::InternedString(""));
+  CHECK(empty.str().empty());
+
+  // Interning the same strings again doesn't grow the pool
+  const uint64_t poolSize = hdoc::types::InternedString::getPoolSize();
+  CHECK(hdoc::types::InternedString("int") == c);
+  CHECK(hdoc::types::InternedString::getPoolSize() == poolSize);
+  CHECK(hdoc::types::InternedString::getPoolHeapBytes() > 0);
+}
+
+TEST_CASE("Strings interned concurrently get the same handle") {
+  std::vector<hdoc::types::InternedString> handles(8);
+  std::vector<std::thread>                 threads;
+  for (uint64_t i = 0; i < handles.size(); i++) {
+    threads.emplace_back([&handles, i]() {
+      for (uint64_t j = 0; j < 1000; j++) {
+        handles[i] = "some/file/path" + std::to_string(j % 10) + ".hpp";
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  for (const auto& handle : handles) {
+    CHECK(handle == "some/file/path9.hpp");
+    CHECK(&handle.str() == &handles[0].str());
+  }
+}
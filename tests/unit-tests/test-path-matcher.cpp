@@ -0,0 +1,83 @@
+// Copyright 2019-2023 hdoc
+// SPDX-License-Identifier: AGPL-3.0-only
+
+#include "doctest.h"
+#include "support/PathMatcher.hpp"
+
+#include <string>
+#include <vector>
+
+TEST_CASE("Glob matching of single strings") {
+  CHECK(hdoc::utils::isGlobMatch("*.cpp", "main.cpp") == true);
+  CHECK(hdoc::utils::isGlobMatch("*.cpp", "main.hpp") == false);
+  CHECK(hdoc::utils::isGlobMatch("*", "") == true);
+  CHECK(hdoc::utils::isGlobMatch("", "") == true);
+  CHECK(hdoc::utils::isGlobMatch("", "a") == false);
+  CHECK(hdoc::utils::isGlobMatch("a*b*c", "aXXbYYc") == true);
+  CHECK(hdoc::utils::isGlobMatch("a*b*c", "aXXbYY") == false);
+  CHECK(hdoc::utils::isGlobMatch("*ab", "aaab") == true);
+  CHECK(hdoc::utils::isGlobMatch("test_?.cpp", "test_1.cpp") == true);
+  CHECK(hdoc::utils::isGlobMatch("test_?.cpp", "test_12.cpp") == false);
+  CHECK(hdoc::utils::isGlobMatch("[abc].h", "b.h") == true);
+  CHECK(hdoc::utils::isGlobMatch("[abc].h", "d.h") == false);
+  CHECK(hdoc::utils::isGlobMatch("[!abc].h", "d.h") == true);
+  CHECK(hdoc::utils::isGlobMatch("[^abc].h", "a.h") == false);
+  CHECK(hdoc::utils::isGlobMatch("v[0-9]", "v7") == true);
+  CHECK(hdoc::utils::isGlobMatch("v[0-9]", "vx") == false);
+  CHECK(hdoc::utils::isGlobMatch("[]]", "]") == true);
+  CHECK(hdoc::utils::isGlobMatch("[a-]", "-") == true);
+  CHECK(hdoc::utils::isGlobMatch("a[b", "a[b") == true);
+  CHECK(hdoc::utils::isGlobMatch("\\*.h", "*.h") == true);
+  CHECK(hdoc::utils::isGlobMatch("\\*.h", "a.h") == false);
+}
+
+TEST_CASE("Patterns without glob characters are substrings") {
+  const hdoc::utils::PathMatcher m({"/tests/", "_autogenerated.cpp"});
+  CHECK(m.isMatch("src/tests/foo.cpp") == true);
+  CHECK(m.isMatch("tests/foo.cpp") == false);
+  CHECK(m.isMatch("src/interface_autogenerated.cpp") == true);
+  CHECK(m.isMatch("src/interface_autogenerated.hpp") == false);
+  CHECK(m.isMatch("src/main.cpp") == false);
+}
+
+TEST_CASE("Unanchored globs match at any depth") {
+  const hdoc::utils::PathMatcher m({"*.pb.h", "gen*/"});
+  CHECK(m.isMatch("foo.pb.h") == true);
+  CHECK(m.isMatch("src/proto/foo.pb.h") == true);
+  CHECK(m.isMatch("src/proto/foo.pb.cc") == false);
+  // A glob ending with "/" only matches directories
+  CHECK(m.isMatch("src/generated/types.hpp") == true);
+  CHECK(m.isMatch("generated/types.hpp") == true);
+  CHECK(m.isMatch("src/generated.hpp") == false);
+}
+
+TEST_CASE("Anchored globs match relative to the root") {
+  const hdoc::utils::PathMatcher m({"/third_party/*", "src/*/internal_*.hpp", "/build*"});
+  CHECK(m.isMatch("third_party/lib/lib.hpp") == true);
+  CHECK(m.isMatch("third_party/lib.hpp") == true);
+  CHECK(m.isMatch("src/third_party/lib.hpp") == false);
+  CHECK(m.isMatch("src/foo/internal_bar.hpp") == true);
+  CHECK(m.isMatch("src/internal_bar.hpp") == false);
+  CHECK(m.isMatch("lib/src/foo/internal_bar.hpp") == false);
+  // Globs also match the parent directories of a path
+  CHECK(m.isMatch("build-release/gen/foo.hpp") == true);
+  CHECK(m.isMatch("src/build/foo.hpp") == false);
+}
+
+TEST_CASE("Double asterisks match any number of directories") {
+  const hdoc::utils::PathMatcher m({"**/vendor/**/*.h", "docs/**"});
+  CHECK(m.isMatch("vendor/a.h") == true);
+  CHECK(m.isMatch("src/vendor/x/y/a.h") == true);
+  CHECK(m.isMatch("src/vendor/x/y/a.cpp") == false);
+  CHECK(m.isMatch("src/vendored/a.h") == false);
+  CHECK(m.isMatch("docs/a/b.md") == true);
+  CHECK(m.isMatch("docs") == false);
+  CHECK(m.isMatch("src/docs/a.md") == false);
+}
+
+TEST_CASE("Empty PathMatcher matches nothing") {
+  const hdoc::utils::PathMatcher m(std::vector<std::string>{});
+  CHECK(m.empty() == true);
+  CHECK(m.isMatch("src/main.cpp") == false);
+  CHECK(hdoc::utils::PathMatcher({"*.h"}).empty() == false);
+}
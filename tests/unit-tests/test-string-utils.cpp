@@ -0,0 +1,50 @@
+// Copyright 2019-2023 hdoc
+// SPDX-License-Identifier: AGPL-3.0-only
+
+#include "doctest.h"
+#include "support/StringUtils.hpp"
+
+#include <string>
+#include <vector>
+
+TEST_CASE("Template type parameter placeholders are replaced in a single scan") {
+  const std::vector<std::vector<std::string>> names = {
+      {"T", "U", "", "", "", "", "", "", "", "", "Tenth"},
+      {"V"},
+  };
+  const auto getName = [&](const uint64_t depth, const uint64_t index) -> const std::string* {
+    if (depth >= names.size() || index >= names[depth].size() || names[depth][index].empty()) {
+      return nullptr;
+    }
+    return &names[depth][index];
+  };
+
+  std::string buf;
+
+  std::string s = "type-parameter-0-0 f(const type-parameter-0-1 &, type-parameter-1-0)";
+  CHECK(hdoc::utils::replaceTemplateTypeParams(s, buf, getName) == true);
+  CHECK(s == "T f(const U &, V)");
+
+  // Multi-digit indices are replaced as a whole instead of matching the placeholder for index 1
+  s = "type-parameter-0-10";
+  CHECK(hdoc::utils::replaceTemplateTypeParams(s, buf, getName) == true);
+  CHECK(s == "Tenth");
+
+  // Placeholders without a name, at unknown depths, or that are malformed are left alone
+  s = "type-parameter-0-2 type-parameter-5-0 type-parameter-0- type-parameter-";
+  CHECK(hdoc::utils::replaceTemplateTypeParams(s, buf, getName) == false);
+  CHECK(s == "type-parameter-0-2 type-parameter-5-0 type-parameter-0- type-parameter-");
+
+  s = "void g()";
+  CHECK(hdoc::utils::replaceTemplateTypeParams(s, buf, getName) == false);
+  CHECK(s == "void g()");
+
+  // Offsets after a placeholder move with the text, offsets before it stay put
+  s                  = "template <> type-parameter-0-0 Foo::bar(type-parameter-0-1 x)";
+  uint64_t offsets[] = {11, 31};
+  CHECK(hdoc::utils::replaceTemplateTypeParams(s, buf, getName, offsets) == true);
+  CHECK(s == "template <> T Foo::bar(U x)");
+  CHECK(offsets[0] == 11);
+  CHECK(offsets[1] == 14);
+  CHECK(s.substr(offsets[1], 3) == "Foo");
+}
@@ -0,0 +1,76 @@
+// Copyright 2019-2023 hdoc
+// SPDX-License-Identifier: AGPL-3.0-only
+
+#include "doctest.h"
+#include "support/SubstringMatcher.hpp"
+
+#include <string>
+#include <vector>
+
+TEST_CASE("SubstringMatcher finds any of its substrings") {
+  const hdoc::utils::SubstringMatcher m({"detail", "impl", "internal"});
+  CHECK(m.empty() == false);
+  CHECK(m.isMatch("detail") == true);
+  CHECK(m.isMatch("foo_detail_bar") == true);
+  CHECK(m.isMatch("pimpl") == true);
+  CHECK(m.isMatch("internals") == true);
+  CHECK(m.isMatch("") == false);
+  CHECK(m.isMatch("details_") == true);
+  CHECK(m.isMatch("detai") == false);
+  CHECK(m.isMatch("intern") == false);
+  CHECK(m.isMatch("foo") == false);
+}
+
+TEST_CASE("SubstringMatcher follows suffix links between overlapping substrings") {
+  // "she" fails over to "he", and "hers" has to be found after a partial match of "his"
+  const hdoc::utils::SubstringMatcher m({"he", "she", "his", "hers"});
+  CHECK(m.isMatch("ushe") == true);
+  CHECK(m.isMatch("sh") == false);
+  CHECK(m.isMatch("hi") == false);
+  CHECK(m.isMatch("xhe") == true);
+
+  const hdoc::utils::SubstringMatcher n({"abcd", "bce"});
+  CHECK(n.isMatch("abce") == true);
+  CHECK(n.isMatch("abcf") == false);
+
+  const hdoc::utils::SubstringMatcher o({"aab"});
+  CHECK(o.isMatch("aaab") == true);
+  CHECK(o.isMatch("abab") == false);
+}
+
+TEST_CASE("SubstringMatcher edge cases") {
+  const hdoc::utils::SubstringMatcher none(std::vector<std::string>{});
+  CHECK(none.empty() == true);
+  CHECK(none.isMatch("anything") == false);
+
+  // An empty substring is contained in every string, like with std::string::find()
+  const hdoc::utils::SubstringMatcher all({"foo", ""});
+  CHECK(all.empty() == false);
+  CHECK(all.isMatch("") == true);
+  CHECK(all.isMatch("bar") == true);
+}
+
+TEST_CASE("SubstringMatcher agrees with std::string::find") {
+  const std::vector<std::string>      substrings = {"ab", "bab", "bca", "c", "caa", "aaaa"};
+  const hdoc::utils::SubstringMatcher m(substrings);
+
+  // Check every string of up to 6 characters over the alphabet {a, b, c, d}
+  std::string s;
+  for (uint32_t len = 0; len <= 6; len++) {
+    uint32_t numStrings = 1;
+    for (uint32_t i = 0; i < len; i++) {
+      numStrings *= 4;
+    }
+    for (uint32_t n = 0; n < numStrings; n++) {
+      s.clear();
+      for (uint32_t i = 0, x = n; i < len; i++, x /= 4) {
+        s.push_back("abcd"[x % 4]);
+      }
+      bool expected = false;
+      for (const auto& substr : substrings) {
+        expected |= s.find(substr) != std::string::npos;
+      }
+      CHECK(m.isMatch(s) == expected);
+    }
+  }
+}
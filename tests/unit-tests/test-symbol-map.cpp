@@ -0,0 +1,99 @@
+// Copyright 2019-2023 hdoc
+// SPDX-License-Identifier: AGPL-3.0-only
+
+#include "doctest.h"
+#include "types/Index.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+TEST_CASE("SymbolMap behaves like a map across shards") {
+  hdoc::types::SymbolMap<hdoc::types::EnumSymbol> map;
+  CHECK(map.empty());
+  CHECK(map.begin() == map.end());
+
+  // Spread keys over the whole range of IDs so that they land in different shards
+  const uint64_t numSymbols = 1000;
+  for (uint64_t i = 0; i < numSymbols; i++) {
+    hdoc::types::EnumSymbol e;
+    e.ID   = hdoc::types::SymbolID(i * 0x9E3779B97F4A7C15ULL);
+    e.name = std::to_string(i);
+    CHECK(map.emplace(e.ID, std::move(e)).second == true);
+  }
+  CHECK(map.size() == numSymbols);
+
+  uint64_t numIterated = 0;
+  for (const auto& [id, e] : map) {
+    CHECK(id == e.ID);
+    numIterated++;
+  }
+  CHECK(numIterated == numSymbols);
+
+  const hdoc::types::SymbolID id(7 * 0x9E3779B97F4A7C15ULL);
+  REQUIRE(map.find(id) != map.end());
+  CHECK(map.find(id)->second.name == "7");
+  CHECK(map.at(id).name == "7");
+  CHECK(map.erase(id) == 1);
+  CHECK(map.contains(id) == false);
+  CHECK(map.find(id) == map.end());
+  CHECK(map.size() == numSymbols - 1);
+
+  // Existing entries take precedence when merging
+  hdoc::types::SymbolMap<hdoc::types::EnumSymbol> other;
+  other[id].name                                          = "new";
+  other[hdoc::types::SymbolID(0x9E3779B97F4A7C15ULL)].name = "duplicate";
+  map.merge(other);
+  CHECK(map.size() == numSymbols);
+  CHECK(map.at(id).name == "new");
+  CHECK(map.at(hdoc::types::SymbolID(0x9E3779B97F4A7C15ULL)).name == "1");
+}
+
+TEST_CASE("Each SymbolID can only be claimed once across threads") {
+  hdoc::types::Database<hdoc::types::FunctionSymbol> db;
+  std::atomic<uint32_t>                              numClaimed = 0;
+  std::vector<std::thread>                           threads;
+
+  const uint64_t numSymbols = 5000;
+  for (uint32_t t = 0; t < 8; t++) {
+    threads.emplace_back([&]() {
+      for (uint64_t i = 0; i < numSymbols; i++) {
+        const hdoc::types::SymbolID id(i * 0x9E3779B97F4A7C15ULL);
+        if (db.claim(id)) {
+          numClaimed++;
+          hdoc::types::FunctionSymbol f;
+          f.ID = id;
+          db.update(id, f);
+        }
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+
+  CHECK(numClaimed == numSymbols);
+  CHECK(db.entries.size() == numSymbols);
+}
+
+TEST_CASE("Moving a symbol into a Database keeps its contents") {
+  hdoc::types::Database<hdoc::types::FunctionSymbol> db;
+  const hdoc::types::SymbolID                        id(42);
+  REQUIRE(db.claim(id) == true);
+
+  hdoc::types::FunctionSymbol f;
+  f.ID         = id;
+  f.name       = "aFunctionWithANameTooLongToBeStoredInline";
+  f.docComment = std::string(1000, 'x');
+  f.params.emplace_back(hdoc::types::FunctionParam{"a", {}, "", ""});
+  const char* docCommentData = f.docComment.data();
+  db.update(id, std::move(f));
+
+  const hdoc::types::FunctionSymbol& stored = db.entries[id];
+  CHECK(stored.name == "aFunctionWithANameTooLongToBeStoredInline");
+  CHECK(stored.params.size() == 1);
+  CHECK(stored.params[0].name == "a");
+  // The buffer was handed over rather than copied
+  CHECK(stored.docComment.data() == docCommentData);
+}
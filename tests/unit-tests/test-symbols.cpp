@@ -0,0 +1,44 @@
+// Copyright 2019-2023 hdoc
+// SPDX-License-Identifier: AGPL-3.0-only
+
+#include "doctest.h"
+#include "types/Symbols.hpp"
+
+#include <type_traits>
+
+// Symbols are stored by value in the Index and don't need a vtable
+static_assert(std::is_polymorphic_v<hdoc::types::FunctionSymbol> == false);
+static_assert(std::is_polymorphic_v<hdoc::types::NamespaceSymbol> == false);
+static_assert(hdoc::types::RecordSymbol::directory() == "records");
+
+TEST_CASE("Symbol URLs use the directory of their kind") {
+  hdoc::types::FunctionSymbol f;
+  f.ID = hdoc::types::SymbolID(0x1234);
+  CHECK(f.url() == "functions/0000000000001234.html");
+  CHECK(f.relativeUrl() == "../functions/0000000000001234.html");
+
+  hdoc::types::EnumSymbol e;
+  e.ID = hdoc::types::SymbolID(0xABCDEF0123456789);
+  CHECK(e.url() == "enums/ABCDEF0123456789.html");
+
+  CHECK(hdoc::types::AliasSymbol::directory() == "aliases");
+  CHECK(hdoc::types::NamespaceSymbol::directory() == "namespaces");
+  CHECK(hdoc::types::SymbolTraits<hdoc::types::FunctionSymbol>::directory == "functions");
+}
+
+TEST_CASE("Function qualifiers are independent of each other") {
+  hdoc::types::FunctionSymbol f;
+  CHECK(f.isConst == false);
+  CHECK(f.isConversionOp == false);
+
+  f.isConst        = true;
+  f.isConversionOp = true;
+  CHECK(f.isConst == true);
+  CHECK(f.isVolatile == false);
+  CHECK(f.isConversionOp == true);
+  CHECK(f.isCtorOrDtor == false);
+
+  f.isConst = false;
+  CHECK(f.isConst == false);
+  CHECK(f.isConversionOp == true);
+}
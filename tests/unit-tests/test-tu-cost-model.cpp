@@ -0,0 +1,59 @@
+// Copyright 2019-2023 hdoc
+// SPDX-License-Identifier: AGPL-3.0-only
+
+#include "doctest.h"
+#include "indexer/TUCostModel.hpp"
+
+#include <fstream>
+
+TEST_CASE("TUs are ordered by size, then by recorded timings") {
+  const std::filesystem::path dir = std::filesystem::temp_directory_path() / "hdoc-test-tu-cost-model";
+  std::filesystem::remove_all(dir);
+  std::filesystem::create_directories(dir);
+
+  const std::string small  = (dir / "small.cpp").string();
+  const std::string medium = (dir / "medium.cpp").string();
+  const std::string large  = (dir / "large.cpp").string();
+  std::ofstream(small) << std::string(10, ' ');
+  std::ofstream(medium) << std::string(100, ' ');
+  std::ofstream(large) << std::string(1000, ' ');
+
+  // Without any timings, the largest source files come first
+  {
+    hdoc::indexer::TUCostModel model(dir);
+    std::vector<std::string>   files = {small, medium, large};
+    model.sortByDescendingCost(files);
+    CHECK(files == std::vector<std::string>{large, medium, small});
+
+    model.record(small, 10.0);
+    model.record(large, 5.0);
+    model.store();
+  }
+
+  // The small file turned out to be expensive, and the medium file is estimated by the median time per byte
+  {
+    hdoc::indexer::TUCostModel model(dir);
+    std::vector<std::string>   files = {large, medium, small};
+    model.sortByDescendingCost(files);
+    CHECK(files == std::vector<std::string>{small, large, medium});
+  }
+
+  // Without a cache directory nothing is persisted, neither in the working directory nor in the old cache directory
+  {
+    const std::filesystem::path cwd   = std::filesystem::current_path();
+    const std::filesystem::path empty = dir / "empty";
+    std::filesystem::create_directories(empty);
+    const auto timingsTime = std::filesystem::last_write_time(dir / "timings");
+
+    std::filesystem::current_path(empty);
+    hdoc::indexer::TUCostModel model("");
+    model.record(small, 1.0);
+    model.store();
+    std::filesystem::current_path(cwd);
+
+    CHECK(std::filesystem::is_empty(empty) == true);
+    CHECK(std::filesystem::last_write_time(dir / "timings") == timingsTime);
+  }
+
+  std::filesystem::remove_all(dir);
+}
@@ -0,0 +1,82 @@
+// Copyright 2019-2023 hdoc
+// SPDX-License-Identifier: AGPL-3.0-only
+
+#include "indexer/WorkerProtocol.hpp"
+#include "support/StringUtils.hpp"
+#include "tests/TestUtils.hpp"
+
+TEST_CASE("Line lists survive a roundtrip and truncation is detected") {
+  std::string data;
+  hdoc::utils::appendLines(data, {"/src/a.hpp", "", "/src/with space.hpp"});
+  hdoc::utils::appendLines(data, {});
+  data += "rest";
+
+  std::string_view         view = data;
+  std::vector<std::string> lines;
+  CHECK(hdoc::utils::consumeLines(view, lines) == true);
+  CHECK(lines == std::vector<std::string>{"/src/a.hpp", "", "/src/with space.hpp"});
+  CHECK(hdoc::utils::consumeLines(view, lines) == true);
+  CHECK(lines.empty());
+  CHECK(view == "rest");
+
+  std::string_view truncated = std::string_view(data).substr(0, 8);
+  CHECK(hdoc::utils::consumeLines(truncated, lines) == false);
+  std::string_view garbage = "x\n";
+  CHECK(hdoc::utils::consumeLines(garbage, lines) == false);
+}
+
+TEST_CASE("Worker requests and results survive a roundtrip") {
+  hdoc::indexer::WorkerRequest request;
+  request.tu                   = "/src/a.cpp";
+  request.claimedFiles         = {"/src/a.hpp", "/src/b.hpp"};
+  request.extraArgs            = {"-isystem/usr/include", "-Xclang", "-skip-function-bodies"};
+  request.cfg.rootDir          = "/src";
+  request.cfg.ignorePaths      = {"third_party/"};
+  request.cfg.detailNamespaces = {"detail"};
+  request.cfg.pruneAST         = true;
+  request.commands.emplace_back("/build", "/src/a.cpp", std::vector<std::string>{"c++", "-c", "/src/a.cpp"}, "a.o");
+  request.commands.emplace_back("/build", "/src/a.cpp", std::vector<std::string>{"c++", "-DB", "/src/a.cpp"}, "b.o");
+
+  const std::string            requestData = hdoc::indexer::serializeWorkerRequest(request);
+  hdoc::indexer::WorkerRequest request2;
+  CHECK(hdoc::indexer::deserializeWorkerRequest(requestData, request2) == true);
+  CHECK(request2.tu == request.tu);
+  CHECK(request2.pchPath == "");
+  CHECK(request2.claimedFiles == request.claimedFiles);
+  CHECK(request2.extraArgs == request.extraArgs);
+  CHECK(request2.cfg.rootDir == request.cfg.rootDir);
+  CHECK(request2.cfg.ignorePaths == request.cfg.ignorePaths);
+  CHECK(request2.cfg.ignoreNamespaces.empty());
+  CHECK(request2.cfg.detailNamespaces == request.cfg.detailNamespaces);
+  CHECK(request2.cfg.ignorePrivateMembers == false);
+  CHECK(request2.cfg.pruneAST == true);
+  CHECK(request2.cfg.deduplicateHeaders == false);
+  REQUIRE(request2.commands.size() == 2);
+  CHECK(request2.commands[1].Directory == "/build");
+  CHECK(request2.commands[1].Filename == "/src/a.cpp");
+  CHECK(request2.commands[1].CommandLine == request.commands[1].CommandLine);
+  CHECK(request2.commands[1].Output == "b.o");
+
+  hdoc::indexer::WorkerRequest request3;
+  CHECK(hdoc::indexer::deserializeWorkerRequest(std::string_view(requestData).substr(0, requestData.size() - 4),
+                                                request3) == false);
+
+  hdoc::indexer::WorkerResult result;
+  result.success      = true;
+  result.deps         = {"/src/a.cpp", "/src/a.hpp", "/usr/include/vector"};
+  result.skippedFiles = {"/src/b.hpp"};
+  runOverCode("struct Foo { void bar(); };", result.index);
+
+  const std::string           data = hdoc::indexer::serializeWorkerResult(result);
+  hdoc::indexer::WorkerResult result2;
+  CHECK(hdoc::indexer::deserializeWorkerResult(data, result2) == true);
+  CHECK(result2.success == true);
+  CHECK(result2.deps == result.deps);
+  CHECK(result2.claimedFiles.empty());
+  CHECK(result2.skippedFiles == result.skippedFiles);
+  CHECK(result2.index.records.entries.size() == 1);
+  CHECK(result2.index.functions.entries.size() == result.index.functions.entries.size());
+
+  hdoc::indexer::WorkerResult result3;
+  CHECK(hdoc::indexer::deserializeWorkerResult(std::string_view(data).substr(0, data.size() / 2), result3) == false);
+}
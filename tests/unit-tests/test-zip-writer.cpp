@@ -0,0 +1,155 @@
+// Copyright 2019-2023 hdoc
+// SPDX-License-Identifier: AGPL-3.0-only
+
+#include "doctest.h"
+#include "support/ZipWriter.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+
+static uint64_t readLE(const std::string& data, const uint64_t offset, const uint32_t numBytes) {
+  uint64_t v = 0;
+  for (uint32_t i = 0; i < numBytes; i++) {
+    v |= static_cast<uint64_t>(static_cast<uint8_t>(data[offset + i])) << (8 * i);
+  }
+  return v;
+}
+
+static std::string readFile(const std::filesystem::path& path) {
+  std::ifstream     in(path, std::ios::binary);
+  std::stringstream ss;
+  ss << in.rdbuf();
+  return ss.str();
+}
+
+/// Look up every file in the central directory of the archive at path and read its contents from the offset
+/// stored there, the way a server would
+static std::map<std::string, std::string> readArchive(const std::filesystem::path& path) {
+  const std::string data = readFile(path);
+
+  // The end of central directory record is the last 22 bytes since there's no comment
+  const uint64_t eocd = data.size() - 22;
+  REQUIRE(readLE(data, eocd, 4) == 0x06054b50);
+  uint64_t numEntries = readLE(data, eocd + 10, 2);
+  uint64_t cdOffset   = readLE(data, eocd + 16, 4);
+  if (numEntries == 0xffff) {
+    // The ZIP64 locator precedes the end of central directory record and points to the ZIP64 record
+    const uint64_t zip64 = readLE(data, eocd - 20 + 8, 8);
+    REQUIRE(readLE(data, zip64, 4) == 0x06064b50);
+    numEntries = readLE(data, zip64 + 32, 8);
+    cdOffset   = readLE(data, zip64 + 48, 8);
+  }
+
+  std::map<std::string, std::string> files;
+  uint64_t                           pos = cdOffset;
+  for (uint64_t i = 0; i < numEntries; i++) {
+    REQUIRE(readLE(data, pos, 4) == 0x02014b50);
+    const uint64_t    size      = readLE(data, pos + 24, 4);
+    const uint64_t    nameLen   = readLE(data, pos + 28, 2);
+    const uint64_t    extraLen  = readLE(data, pos + 30, 2);
+    const uint64_t    localPos  = readLE(data, pos + 42, 4);
+    const std::string name      = data.substr(pos + 46, nameLen);
+    const uint64_t    dataStart = localPos + 30 + readLE(data, localPos + 26, 2) + readLE(data, localPos + 28, 2);
+    files[name]                 = data.substr(dataStart, size);
+    pos += 46 + nameLen + extraLen;
+  }
+  return files;
+}
+
+TEST_CASE("Files in a ZIP archive can be read through its central directory") {
+  const std::filesystem::path path = std::filesystem::temp_directory_path() / "hdoc-test-zip-writer.zip";
+
+  hdoc::utils::ZipWriter zip;
+  REQUIRE(zip.open(path) == true);
+  CHECK(zip.add("index.html", "<html></html>") == true);
+  CHECK(zip.add("r/123.html", "record") == true);
+  CHECK(zip.add("empty.txt", "") == true);
+  CHECK(zip.size() == 3);
+  REQUIRE(zip.close() == true);
+
+  const auto files = readArchive(path);
+  CHECK(files.size() == 3);
+  CHECK(files.at("index.html") == "<html></html>");
+  CHECK(files.at("r/123.html") == "record");
+  CHECK(files.at("empty.txt") == "");
+  std::filesystem::remove(path);
+}
+
+TEST_CASE("ZIP archives with more than 65535 files use ZIP64 records") {
+  const std::filesystem::path path = std::filesystem::temp_directory_path() / "hdoc-test-zip-writer-zip64.zip";
+
+  hdoc::utils::ZipWriter zip;
+  REQUIRE(zip.open(path) == true);
+  for (int i = 0; i < 70000; i++) {
+    zip.add("f/" + std::to_string(i) + ".html", std::to_string(i));
+  }
+  REQUIRE(zip.close() == true);
+
+  const auto files = readArchive(path);
+  CHECK(files.size() == 70000);
+  CHECK(files.at("f/0.html") == "0");
+  CHECK(files.at("f/69999.html") == "69999");
+  std::filesystem::remove(path);
+}
+
+TEST_CASE("Files in a ZIP archive have the CRC-32 of their contents") {
+  const std::filesystem::path path = std::filesystem::temp_directory_path() / "hdoc-test-zip-writer-crc.zip";
+
+  hdoc::utils::ZipWriter zip;
+  REQUIRE(zip.open(path) == true);
+  CHECK(zip.add("check.txt", "123456789") == true);
+  REQUIRE(zip.close() == true);
+
+  // 0xCBF43926 is the standard check value of CRC-32, stored in both the local header and the central directory
+  const std::string data = readFile(path);
+  REQUIRE(readLE(data, 0, 4) == 0x04034b50);
+  CHECK(readLE(data, 14, 4) == 0xCBF43926);
+  const uint64_t cdOffset = readLE(data, data.size() - 22 + 16, 4);
+  REQUIRE(readLE(data, cdOffset, 4) == 0x02014b50);
+  CHECK(readLE(data, cdOffset + 16, 4) == 0xCBF43926);
+  std::filesystem::remove(path);
+}
+
+TEST_CASE("ZIP archives don't depend on the order files are added in") {
+  const std::filesystem::path path1 = std::filesystem::temp_directory_path() / "hdoc-test-zip-writer-order1.zip";
+  const std::filesystem::path path2 = std::filesystem::temp_directory_path() / "hdoc-test-zip-writer-order2.zip";
+
+  hdoc::utils::ZipWriter zip1;
+  REQUIRE(zip1.open(path1) == true);
+  zip1.add("b.html", "second");
+  zip1.add("a.html", "first");
+  zip1.add("c/d.html", "third");
+  REQUIRE(zip1.close() == true);
+
+  hdoc::utils::ZipWriter zip2;
+  REQUIRE(zip2.open(path2) == true);
+  zip2.add("c/d.html", "third");
+  zip2.add("a.html", "first");
+  zip2.add("b.html", "second");
+  REQUIRE(zip2.close() == true);
+
+  CHECK(readFile(path1) == readFile(path2));
+  CHECK(readArchive(path1).at("b.html") == "second");
+  CHECK(std::filesystem::exists(path1.string() + ".pending") == false);
+  std::filesystem::remove(path1);
+  std::filesystem::remove(path2);
+}
+
+TEST_CASE("Files with a name that's already in a ZIP archive are rejected") {
+  const std::filesystem::path path = std::filesystem::temp_directory_path() / "hdoc-test-zip-writer-duplicate.zip";
+
+  hdoc::utils::ZipWriter zip;
+  REQUIRE(zip.open(path) == true);
+  CHECK(zip.add("docreadme.html", "first") == true);
+  CHECK(zip.add("docreadme.html", "second") == false);
+  CHECK(zip.size() == 1);
+  REQUIRE(zip.close() == true);
+
+  const auto files = readArchive(path);
+  CHECK(files.size() == 1);
+  CHECK(files.at("docreadme.html") == "first");
+  std::filesystem::remove(path);
+}